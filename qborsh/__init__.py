@@ -1,3 +1,7 @@
 from qborsh.constants import *
 from qborsh.csrc import *
 from qborsh.types import *
+from qborsh.query import scan
+from qborsh.recordlog import RecordLog
+from qborsh.registry import Registry
+from qborsh import aio, idl, ipc, net, parallel, solana, spl
@@ -0,0 +1,287 @@
+import asyncio
+import collections
+import struct
+import typing
+
+from qborsh.types import BorshType
+
+FRAME_PREFIX = struct.Struct("<I")
+"""
+Every frame on the wire is a little-endian u32 payload length, then the payload.
+"""
+
+MAX_FRAME = 64 * 1024 * 1024
+"""
+Frames announcing a larger payload are rejected (and the connection closed).
+"""
+
+ConnectedCallback = typing.Callable[["FrameReader", "FrameWriter"], typing.Awaitable[None]]
+
+
+class FrameReader(asyncio.BufferedProtocol):
+    """
+    asyncio protocol that receives length-prefixed frames and yields them
+    decoded with `schema` (or as bytes without one).
+
+    The event loop reads straight into the protocol's receive buffer
+    (`get_buffer`), and every complete frame is decoded in place from that
+    buffer, so a frame is never copied into an intermediate bytes object.
+    Reading pauses while `max_queue` decoded messages wait for the consumer.
+
+    Example:
+        >>> reader, writer = await qborsh.aio.open_connection(host, port, schema=Quote)
+        >>> writer.write(request)
+        >>> async for quote in reader:
+        ...     ...
+    """
+
+    def __init__(
+        self,
+        schema: typing.Optional[BorshType] = None,
+        buffer_size: int = 256 * 1024,
+        max_frame: int = MAX_FRAME,
+        max_queue: int = 1024,
+        on_connect: typing.Optional[ConnectedCallback] = None,
+    ):
+        self.schema = schema
+        self.max_frame = max_frame
+        self.max_queue = max_queue
+        self.transport: typing.Optional[asyncio.Transport] = None
+        self._on_connect = on_connect
+
+        self._data = bytearray(buffer_size)
+        self._view = memoryview(self._data)
+        self._start = 0  # first byte of the oldest incomplete frame
+        self._end = 0  # end of received data
+        self._need = FRAME_PREFIX.size  # bytes that frame needs in total
+
+        self._messages: collections.deque = collections.deque()
+        self._waiter: typing.Optional[asyncio.Future] = None
+        self._error: typing.Optional[BaseException] = None
+        self._eof = False
+        self._reading_paused = False
+        self._writing_paused = False
+        self._drain_waiters: list[asyncio.Future] = []
+
+    # -----------------------------------------------------
+    # Protocol Callbacks
+    # -----------------------------------------------------
+
+    def connection_made(self, transport: asyncio.BaseTransport) -> None:
+        self.transport = typing.cast(asyncio.Transport, transport)
+        if self._on_connect is not None:
+            writer = FrameWriter(self.transport, self, self.schema)
+            asyncio.get_running_loop().create_task(self._on_connect(self, writer))
+
+    def get_buffer(self, sizehint: int) -> memoryview:
+        size = len(self._data)
+        if self._start == self._end:
+            self._start = self._end = 0
+        elif size - self._start < self._need or size - self._end < size // 4:
+            # Move the incomplete frame to the front to make room behind it
+            pending = self._end - self._start
+            self._view[:pending] = self._view[self._start : self._end]
+            self._start, self._end = 0, pending
+
+        if size < self._need:
+            data = bytearray(max(self._need, size * 2))
+            data[: self._end] = self._view[: self._end]
+            self._view.release()
+            self._data, self._view = data, memoryview(data)
+        return self._view[self._end :]
+
+    def buffer_updated(self, nbytes: int) -> None:
+        self._end += nbytes
+        data, view = self._data, self._view
+
+        while True:
+            available = self._end - self._start
+            if available < FRAME_PREFIX.size:
+                self._need = FRAME_PREFIX.size
+                break
+            (length,) = FRAME_PREFIX.unpack_from(data, self._start)
+            if length > self.max_frame:
+                self._fail(ValueError(f"Frame of {length} bytes exceeds max_frame ({self.max_frame})."))
+                return
+            total = FRAME_PREFIX.size + length
+            if available < total:
+                self._need = total
+                break
+
+            with view[self._start + FRAME_PREFIX.size : self._start + total] as payload:
+                try:
+                    message = self.schema.decode(payload) if self.schema is not None else bytes(payload)
+                except Exception as e:
+                    self._fail(e)
+                    return
+            self._messages.append(message)
+            self._start += total
+
+        if self._messages:
+            self._wake()
+            if len(self._messages) >= self.max_queue and not self._reading_paused and self.transport:
+                self.transport.pause_reading()
+                self._reading_paused = True
+
+    def eof_received(self) -> bool:
+        return False
+
+    def connection_lost(self, exc: typing.Optional[Exception]) -> None:
+        self._eof = True
+        if self._error is None:
+            if exc is not None:
+                self._error = exc
+            elif self._end > self._start:
+                self._error = ConnectionError("Connection closed in the middle of a frame.")
+        self._wake()
+        for waiter in self._drain_waiters:
+            if not waiter.done():
+                waiter.set_exception(self._error or ConnectionResetError("Connection lost."))
+        self._drain_waiters.clear()
+
+    def pause_writing(self) -> None:
+        self._writing_paused = True
+
+    def resume_writing(self) -> None:
+        self._writing_paused = False
+        for waiter in self._drain_waiters:
+            if not waiter.done():
+                waiter.set_result(None)
+        self._drain_waiters.clear()
+
+    # -----------------------------------------------------
+    # Consumer
+    # -----------------------------------------------------
+
+    def _fail(self, exc: BaseException) -> None:
+        self._error = exc
+        self._wake()
+        if self.transport is not None:
+            self.transport.close()
+
+    def _wake(self) -> None:
+        waiter, self._waiter = self._waiter, None
+        if waiter is not None and not waiter.done():
+            waiter.set_result(None)
+
+    async def read(self) -> typing.Any:
+        """
+        Next message. Raises EOFError once the peer closed the connection
+        and every message was read, or the error that broke the connection.
+        """
+        while not self._messages:
+            if self._error is not None:
+                raise self._error
+            if self._eof:
+                raise EOFError("Connection closed.")
+            self._waiter = asyncio.get_running_loop().create_future()
+            await self._waiter
+
+        message = self._messages.popleft()
+        if self._reading_paused and len(self._messages) <= self.max_queue // 2 and self.transport:
+            self.transport.resume_reading()
+            self._reading_paused = False
+        return message
+
+    def __aiter__(self) -> "FrameReader":
+        return self
+
+    async def __anext__(self) -> typing.Any:
+        try:
+            return await self.read()
+        except EOFError:
+            raise StopAsyncIteration from None
+
+    async def _wait_writable(self) -> None:
+        if self._error is not None:
+            raise self._error
+        if self._writing_paused:
+            waiter = asyncio.get_running_loop().create_future()
+            self._drain_waiters.append(waiter)
+            await waiter
+
+
+class FrameWriter:
+    """
+    Sends length-prefixed frames, batching every frame written during one
+    event loop iteration into a single `transport.write`.
+    """
+
+    def __init__(
+        self,
+        transport: asyncio.Transport,
+        protocol: typing.Optional[FrameReader] = None,
+        schema: typing.Optional[BorshType] = None,
+    ):
+        self.transport = transport
+        self.schema = schema
+        self._protocol = protocol
+        self._loop = asyncio.get_running_loop()
+        self._pending = bytearray()
+        self._scheduled = False
+
+    def write(self, value: typing.Any) -> None:
+        """
+        Queue one message (encoded with `schema`, or bytes-like without one).
+        """
+        payload = self.schema.encode(value) if self.schema is not None else value
+        if len(payload) > 0xFFFFFFFF:
+            raise ValueError("Frame exceeds 4 GiB.")
+        self._pending += FRAME_PREFIX.pack(len(payload))
+        self._pending += payload
+        if not self._scheduled:
+            self._loop.call_soon(self._flush)
+            self._scheduled = True
+
+    def write_many(self, values: typing.Iterable[typing.Any]) -> None:
+        for value in values:
+            self.write(value)
+
+    def _flush(self) -> None:
+        self._scheduled = False
+        if self._pending and not self.transport.is_closing():
+            # The transport may keep the buffer, so start a fresh one
+            data, self._pending = self._pending, bytearray()
+            self.transport.write(data)
+
+    async def drain(self) -> None:
+        """
+        Send queued frames now and wait while the transport's buffer is full.
+        """
+        self._flush()
+        if self._protocol is not None:
+            await self._protocol._wait_writable()
+
+    def close(self) -> None:
+        self._flush()
+        self.transport.close()
+
+
+async def open_connection(
+    host: typing.Optional[str] = None,
+    port: typing.Optional[int] = None,
+    schema: typing.Optional[BorshType] = None,
+    **kwargs: typing.Any,
+) -> tuple[FrameReader, FrameWriter]:
+    """
+    Connect to a frame server, like `asyncio.open_connection`. Extra keyword
+    arguments go to `loop.create_connection`.
+    """
+    loop = asyncio.get_running_loop()
+    transport, protocol = await loop.create_connection(lambda: FrameReader(schema), host, port, **kwargs)
+    return protocol, FrameWriter(transport, protocol, schema)
+
+
+async def start_server(
+    client_connected: ConnectedCallback,
+    host: typing.Optional[str] = None,
+    port: typing.Optional[int] = None,
+    schema: typing.Optional[BorshType] = None,
+    **kwargs: typing.Any,
+) -> asyncio.Server:
+    """
+    Serve frames, like `asyncio.start_server`: `client_connected(reader,
+    writer)` runs as a task for every connection.
+    """
+    loop = asyncio.get_running_loop()
+    return await loop.create_server(lambda: FrameReader(schema, on_connect=client_connected), host, port, **kwargs)
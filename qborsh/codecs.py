@@ -0,0 +1,61 @@
+import typing
+import zlib
+
+
+class Codec(typing.Protocol):
+    """
+    Block compression used by `RecordLog`. `name` is stored in the file so
+    readers can find the codec again; register custom codecs with
+    `register_codec` before opening files that use them.
+    """
+
+    name: str
+
+    def compress(self, data: bytes) -> bytes: ...
+
+    def decompress(self, data: typing.Union[bytes, memoryview]) -> bytes: ...
+
+
+class ZlibCodec:
+    """
+    zlib from the standard library. Borsh snapshots (zero padding, repeated
+    pubkeys) typically shrink several times over at the default level.
+    """
+
+    name = "zlib"
+
+    def __init__(self, level: int = 6):
+        self.level = level
+
+    def compress(self, data: bytes) -> bytes:
+        return zlib.compress(data, self.level)
+
+    def decompress(self, data: typing.Union[bytes, memoryview]) -> bytes:
+        return zlib.decompress(data)
+
+
+_CODECS: dict[str, Codec] = {}
+
+
+def register_codec(codec: Codec) -> None:
+    """
+    Make `codec` available to readers under `codec.name`.
+    """
+    if not codec.name or len(codec.name.encode()) > 255:
+        raise ValueError(f"Invalid codec name: {codec.name!r}")
+    _CODECS[codec.name] = codec
+
+
+def get_codec(codec: typing.Union[str, Codec]) -> Codec:
+    """
+    Resolve a codec by name (or return a codec object as is).
+    """
+    if not isinstance(codec, str):
+        return codec
+    try:
+        return _CODECS[codec]
+    except KeyError:
+        raise ValueError(f"Unknown codec: {codec}") from None
+
+
+register_codec(ZlibCodec())
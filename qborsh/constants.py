@@ -44,11 +44,23 @@ if os.environ.get("QBORSH_VALIDATE", "true").lower() in {"true", "on", "yes"}:
 else:
     csrc.set_validation(False)
 
+
+# Whether PubKey values decode to `PublicKey` objects: the 32 raw bytes, with
+# base58 only computed (and cached) on the first str(). Decodes whose keys are
+# only compared or used as dict keys skip base58 entirely.
+def set_lazy_pubkeys(enable: bool) -> None:
+    os.environ["QBORSH_LAZY_PUBKEYS"] = str(enable)
+    csrc.set_lazy_pubkeys(enable)
+
+
+csrc.set_lazy_pubkeys(os.environ.get("QBORSH_LAZY_PUBKEYS", "false").lower() in {"true", "on", "yes"})
+
 __all__ = [
     "BUFFER_SIZE",
     "GLOBAL_BUFFER",
     "GLOBAL_BUFFER_SUB",
     "set_buffer_size",
     "set_global_buffer",
+    "set_lazy_pubkeys",
     "set_validation",
 ]
@@ -1,6 +1,30 @@
-from .py_borsh import Buffer, set_validation
+from .py_borsh import (
+    Buffer,
+    Dispatch,
+    Index,
+    Layout,
+    PublicKey,
+    Readahead,
+    Ring,
+    aggregate,
+    build_index,
+    clear_interned,
+    crc32c,
+    frame_span,
+    merge_sorted,
+    ring_bytes,
+    scan,
+    scan_frames,
+    set_lazy_pubkeys,
+    set_validation,
+    sort,
+    split_records,
+)
 
 __all__ = [
     "Buffer",
+    "Layout",
+    "PublicKey",
+    "clear_interned",
     "set_validation",
 ]
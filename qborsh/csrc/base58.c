@@ -0,0 +1,228 @@
+#include "base58.h"
+#include <stdbool.h> // for bool
+#include <stdlib.h>  // for calloc, free
+
+/*
+ * Keys are worked on as eight big-endian 32-bit limbs, and converted in
+ * chunks of five base58 digits (58^5 fits a limb), so every step is a fixed
+ * number of 64-bit multiplies or divisions by a constant: no bignum.
+ */
+#define KEY_LIMBS 8
+#define CHUNK_DIGITS 5
+#define CHUNK_BASE 656356768u /* 58^5 */
+#define KEY_CHUNKS 9          /* 58^45 > 2^256 */
+
+static const char g_alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/*
+ * Digit value of each char, -1 outside the alphabet.
+ */
+static const int8_t g_digits[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, -1, -1, -1, -1, -1, -1,
+    -1, 9, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1,
+    22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, -1, -1, -1, -1, -1,
+    -1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+size_t base58_encode_key(const uint8_t *key, char *out)
+{
+    uint32_t limbs[KEY_LIMBS];
+    for (int i = 0; i < KEY_LIMBS; i++)
+    {
+        limbs[i] = (uint32_t)key[4 * i] << 24 | (uint32_t)key[4 * i + 1] << 16 |
+                   (uint32_t)key[4 * i + 2] << 8 | key[4 * i + 3];
+    }
+
+    size_t zeros = 0;
+    while (zeros < 32 && key[zeros] == 0)
+    {
+        zeros++;
+    }
+
+    // Long division by 58^5, least significant chunk first; limbs that
+    // became zero are skipped
+    uint32_t chunks[KEY_CHUNKS] = {0};
+    int top = 0;
+    while (top < KEY_LIMBS && limbs[top] == 0)
+    {
+        top++;
+    }
+    for (int c = KEY_CHUNKS - 1; c >= 0 && top < KEY_LIMBS; c--)
+    {
+        uint64_t rem = 0;
+        for (int i = top; i < KEY_LIMBS; i++)
+        {
+            uint64_t cur = rem << 32 | limbs[i];
+            limbs[i] = (uint32_t)(cur / CHUNK_BASE);
+            rem = cur % CHUNK_BASE;
+        }
+        chunks[c] = (uint32_t)rem;
+        while (top < KEY_LIMBS && limbs[top] == 0)
+        {
+            top++;
+        }
+    }
+
+    uint8_t digits[KEY_CHUNKS * CHUNK_DIGITS];
+    for (int c = 0; c < KEY_CHUNKS; c++)
+    {
+        uint32_t chunk = chunks[c];
+        for (int d = CHUNK_DIGITS - 1; d >= 0; d--)
+        {
+            digits[c * CHUNK_DIGITS + d] = (uint8_t)(chunk % 58);
+            chunk /= 58;
+        }
+    }
+
+    // Leading zero bytes are spelled as '1's, the number itself without
+    // leading zero digits
+    size_t first = 0;
+    while (first < sizeof(digits) && digits[first] == 0)
+    {
+        first++;
+    }
+    size_t length = 0;
+    for (size_t i = 0; i < zeros; i++)
+    {
+        out[length++] = '1';
+    }
+    for (size_t i = first; i < sizeof(digits); i++)
+    {
+        out[length++] = g_alphabet[digits[i]];
+    }
+    return length;
+}
+
+int base58_decode_key(const char *text, size_t len, uint8_t *key)
+{
+    const uint8_t *p = (const uint8_t *)text;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (g_digits[p[i]] < 0)
+            return BASE58_INVALID_CHAR;
+    }
+    if (len > BASE58_KEY_MAX)
+        return BASE58_WRONG_SIZE;
+
+    size_t ones = 0;
+    while (ones < len && p[ones] == '1')
+    {
+        ones++;
+    }
+    if (ones > 32)
+        return BASE58_WRONG_SIZE;
+
+    // limbs = limbs * 58^k + chunk, k digits at a time
+    uint32_t limbs[KEY_LIMBS] = {0};
+    for (size_t i = ones; i < len;)
+    {
+        uint32_t chunk = 0;
+        uint32_t scale = 1;
+        for (int d = 0; d < CHUNK_DIGITS && i < len; d++, i++)
+        {
+            chunk = chunk * 58 + (uint32_t)g_digits[p[i]];
+            scale *= 58;
+        }
+        uint64_t carry = chunk;
+        for (int l = KEY_LIMBS - 1; l >= 0; l--)
+        {
+            uint64_t cur = (uint64_t)limbs[l] * scale + carry;
+            limbs[l] = (uint32_t)cur;
+            carry = cur >> 32;
+        }
+        if (carry)
+            return BASE58_WRONG_SIZE; // wider than 256 bits
+    }
+
+    for (int l = 0; l < KEY_LIMBS; l++)
+    {
+        key[4 * l] = (uint8_t)(limbs[l] >> 24);
+        key[4 * l + 1] = (uint8_t)(limbs[l] >> 16);
+        key[4 * l + 2] = (uint8_t)(limbs[l] >> 8);
+        key[4 * l + 3] = (uint8_t)limbs[l];
+    }
+
+    // The '1's must account for exactly the key's leading zero bytes
+    size_t zeros = 0;
+    while (zeros < 32 && key[zeros] == 0)
+    {
+        zeros++;
+    }
+    return zeros == ones ? BASE58_OK : BASE58_WRONG_SIZE;
+}
+
+int base58_decode(const char *text, size_t len, uint8_t *out, size_t *out_len)
+{
+    const uint8_t *p = (const uint8_t *)text;
+    *out_len = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (g_digits[p[i]] < 0)
+            return BASE58_INVALID_CHAR;
+    }
+    size_t ones = 0;
+    while (ones < len && p[ones] == '1')
+    {
+        ones++;
+    }
+
+    // Same chunked multiply as for keys, over as many little-endian limbs
+    // as the number grows to (log2(58) < 6 bits per char)
+    size_t capacity = (len - ones) * 6 / 32 + 2;
+    uint32_t *limbs = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+    if (!limbs)
+        return BASE58_NO_MEMORY;
+    size_t used = 0;
+    for (size_t i = ones; i < len;)
+    {
+        uint32_t chunk = 0;
+        uint32_t scale = 1;
+        for (int d = 0; d < CHUNK_DIGITS && i < len; d++, i++)
+        {
+            chunk = chunk * 58 + (uint32_t)g_digits[p[i]];
+            scale *= 58;
+        }
+        uint64_t carry = chunk;
+        for (size_t l = 0; l < used; l++)
+        {
+            uint64_t cur = (uint64_t)limbs[l] * scale + carry;
+            limbs[l] = (uint32_t)cur;
+            carry = cur >> 32;
+        }
+        if (carry)
+            limbs[used++] = (uint32_t)carry;
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < ones; i++)
+    {
+        out[length++] = 0;
+    }
+    bool leading = true;
+    for (size_t l = used; l-- > 0;)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            uint8_t byte = (uint8_t)(limbs[l] >> shift);
+            if (leading && byte == 0)
+                continue;
+            leading = false;
+            out[length++] = byte;
+        }
+    }
+    free(limbs);
+    *out_len = length;
+    return BASE58_OK;
+}
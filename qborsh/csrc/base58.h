@@ -0,0 +1,50 @@
+#ifndef BASE58_H
+#define BASE58_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h> // for uint8_t
+#include <stddef.h> // for size_t
+
+/*
+ * Longest base58 text of a 32-byte key.
+ */
+#define BASE58_KEY_MAX 44
+
+/*
+ * base58_decode_key results.
+ */
+#define BASE58_OK 0
+#define BASE58_INVALID_CHAR -1
+#define BASE58_WRONG_SIZE -2
+#define BASE58_NO_MEMORY -3
+
+    /*
+     * Base58 (Bitcoin alphabet) text of a 32-byte key, written to 'out'
+     * (BASE58_KEY_MAX chars at most, not terminated). Returns its length.
+     */
+    size_t base58_encode_key(const uint8_t *key, char *out);
+
+    /*
+     * Decodes 'len' chars of base58 into a 32-byte key. Returns BASE58_OK,
+     * BASE58_INVALID_CHAR, or BASE58_WRONG_SIZE when the text is valid
+     * base58 of anything but exactly 32 bytes.
+     */
+    int base58_decode_key(const char *text, size_t len, uint8_t *key);
+
+    /*
+     * Decodes 'len' chars of base58 of any size into 'out', which holds
+     * 'len' bytes (base58 never decodes to more bytes than chars). Sets
+     * '*out_len' and returns BASE58_OK, BASE58_INVALID_CHAR or
+     * BASE58_NO_MEMORY.
+     */
+    int base58_decode(const char *text, size_t len, uint8_t *out, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BASE58_H */
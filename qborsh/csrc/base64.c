@@ -0,0 +1,87 @@
+#include "base64.h"
+
+/*
+ * Sextet of each char; 0xFF outside the alphabet, so one OR of a quad's four
+ * lookups tells whether any char was invalid (valid values never set 0x40).
+ */
+static const uint8_t g_sextets[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 62, 0xFF, 0xFF, 0xFF, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+/*
+ * Decodes one quad of four alphabet chars into 'out'. False if any char is
+ * outside the alphabet.
+ */
+static inline bool decode_quad(const uint8_t *p, uint8_t *out)
+{
+    uint8_t a = g_sextets[p[0]], b = g_sextets[p[1]], c = g_sextets[p[2]], d = g_sextets[p[3]];
+    if ((a | b | c | d) & 0x40)
+        return false;
+    uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | d;
+    out[0] = (uint8_t)(v >> 16);
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = (uint8_t)v;
+    return true;
+}
+
+bool base64_decode(const char *text, size_t len, uint8_t *out, size_t *out_len)
+{
+    const uint8_t *p = (const uint8_t *)text;
+    *out_len = 0;
+    if (len % 4)
+        return false;
+    if (len == 0)
+        return true;
+
+    // Every quad but the last is padding free: the hot loop, eight quads
+    // (32 chars) per step with a single validity check
+    size_t quads = len / 4 - 1;
+    size_t i = 0;
+    uint8_t *o = out;
+    for (; i + 8 <= quads; i += 8)
+    {
+        bool valid = true;
+        for (size_t k = 0; k < 8; k++)
+        {
+            valid &= decode_quad(p + 4 * (i + k), o + 3 * k);
+        }
+        if (!valid)
+            return false;
+        o += 24;
+    }
+    for (; i < quads; i++)
+    {
+        if (!decode_quad(p + 4 * i, o))
+            return false;
+        o += 3;
+    }
+
+    // The last quad may end in one or two '='
+    const uint8_t *last = p + len - 4;
+    size_t pad = last[3] == '=' ? (last[2] == '=' ? 2 : 1) : 0;
+    uint8_t quad[4] = {last[0], last[1], pad == 2 ? 'A' : last[2], pad ? 'A' : last[3]};
+    uint8_t tail[3];
+    if (!decode_quad(quad, tail))
+        return false;
+    for (size_t k = 0; k < 3 - pad; k++)
+    {
+        *o++ = tail[k];
+    }
+    *out_len = (size_t)(o - out);
+    return true;
+}
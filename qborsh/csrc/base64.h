@@ -0,0 +1,32 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint8_t
+#include <stddef.h>  // for size_t
+
+    /*
+     * Bytes that 'len' chars of base64 decode to at most.
+     */
+    static inline size_t base64_decoded_max(size_t len)
+    {
+        return len / 4 * 3;
+    }
+
+    /*
+     * Decodes standard, padded base64 (RFC 4648, no whitespace) into 'out',
+     * which holds base64_decoded_max(len) bytes. Sets '*out_len' and returns
+     * false on malformed text.
+     */
+    bool base64_decode(const char *text, size_t len, uint8_t *out, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BASE64_H */
@@ -43,6 +43,13 @@ static inline void ensure_capacity(Buffer *buf, size_t additional)
     // If we don't have enough space, reallocate
     if (buf->size + additional > buf->capacity)
     {
+        // Borrowed memory cannot grow: the caller reports the overflow
+        if (buf->borrowed)
+        {
+            set_buffer_error(buf);
+            return;
+        }
+
         size_t needed = buf->size + additional;
 
         // Custom growth strategy: double until 1KB, then 1.5x
@@ -140,6 +147,7 @@ void init_buffer(Buffer *buf, size_t initial_capacity)
     buf->capacity = 0;
     buf->offset = 0;
     buf->error = false;
+    buf->borrowed = false;
 
     // Default capacity if caller didn't provide one
     if (initial_capacity == 0)
@@ -160,17 +168,33 @@ void init_buffer(Buffer *buf, size_t initial_capacity)
     }
 }
 
+void init_buffer_view(Buffer *buf, const uint8_t *data, size_t size)
+{
+    buf->data = (uint8_t *)data;
+    buf->size = size;
+    buf->capacity = size;
+    buf->offset = 0;
+    buf->error = false;
+    buf->borrowed = true;
+}
+
+uint8_t *buffer_reserve(Buffer *buf, size_t count)
+{
+    return reserve_space(buf, count);
+}
+
 void free_buffer(Buffer *buf)
 {
-    if (buf->data)
+    if (buf->data && !buf->borrowed)
     {
         free(buf->data);
-        buf->data = NULL;
     }
+    buf->data = NULL;
     buf->size = 0;
     buf->capacity = 0;
     buf->offset = 0;
     buf->error = false;
+    buf->borrowed = false;
 }
 
 /* -----------------------------------------------------
@@ -288,6 +312,37 @@ void write_bool(Buffer *buf, bool value)
     write_u8(buf, bval);
 }
 
+void write_short_u16(Buffer *buf, uint16_t value)
+{
+    uint8_t bytes[3];
+    size_t length = 0;
+    while (value >= 0x80)
+    {
+        bytes[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = (uint8_t)value;
+    write_le(buf, bytes, length);
+}
+
+void write_var_u64(Buffer *buf, uint64_t value)
+{
+    uint8_t bytes[10];
+    size_t length = 0;
+    while (value >= 0x80)
+    {
+        bytes[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = (uint8_t)value;
+    write_le(buf, bytes, length);
+}
+
+void write_var_i64(Buffer *buf, int64_t value)
+{
+    write_var_u64(buf, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
 /*
  * Writes a fixed-size array. The new approach uses reserve_space
  * directly, avoiding repeated memcpy calls in other helpers.
@@ -484,6 +539,115 @@ bool read_bool(Buffer *buf)
     return (read_u8(buf) != 0);
 }
 
+uint16_t read_short_u16(Buffer *buf)
+{
+    if (buf->error)
+        return 0;
+    const uint8_t *p = buf->data + buf->offset;
+    size_t available = buf->size - buf->offset;
+
+    // Most lengths are below 128: one byte, one branch
+    if (available && p[0] < 0x80)
+    {
+        buf->offset += 1;
+        return p[0];
+    }
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < 3 && i < available; i++)
+    {
+        value |= (uint32_t)(p[i] & 0x7F) << (7 * i);
+        if (p[i] < 0x80)
+        {
+            if (p[i] == 0 || value > 0xFFFF)
+                break; // non-canonical or out of range
+            buf->offset += i + 1;
+            return (uint16_t)value;
+        }
+    }
+    set_buffer_error(buf);
+    return 0;
+}
+
+#if defined(__GNUC__)
+/*
+ * Decodes a varint of up to 8 bytes from one 64-bit word: the first clear
+ * high bit ends it, and three shift-and-mask steps squeeze the 7-bit groups
+ * together (SWAR, no per-byte loop). Returns its length, or 0 when all 8
+ * bytes continue and the value needs the scalar path.
+ */
+static inline size_t read_var_word(const uint8_t *p, uint64_t *out)
+{
+    uint64_t w = 0;
+    for (int i = 7; i >= 0; i--)
+    {
+        w = (w << 8) | p[i]; // folds into one load on little-endian targets
+    }
+    uint64_t stops = ~w & 0x8080808080808080ULL;
+    if (!stops)
+        return 0;
+
+    size_t length = ((size_t)__builtin_ctzll(stops) + 1) / 8;
+    if (length < 8)
+        w &= (1ULL << (8 * length)) - 1;
+    w &= 0x7F7F7F7F7F7F7F7FULL;
+    w = ((w & 0x7F007F007F007F00ULL) >> 1) | (w & 0x007F007F007F007FULL);
+    w = ((w & 0x3FFF00003FFF0000ULL) >> 2) | (w & 0x00003FFF00003FFFULL);
+    w = ((w & 0x0FFFFFFF00000000ULL) >> 4) | (w & 0x000000000FFFFFFFULL);
+    *out = w;
+    return length;
+}
+#endif
+
+uint64_t read_var_u64(Buffer *buf)
+{
+    if (buf->error)
+        return 0;
+    const uint8_t *p = buf->data + buf->offset;
+    size_t available = buf->size - buf->offset;
+
+    // Small values are one byte, one branch
+    if (available && p[0] < 0x80)
+    {
+        buf->offset += 1;
+        return p[0];
+    }
+
+    uint64_t value = 0;
+#if defined(__GNUC__)
+    if (available >= 8)
+    {
+        size_t length = read_var_word(p, &value);
+        if (length)
+        {
+            buf->offset += length;
+            return value;
+        }
+        value = 0;
+    }
+#endif
+    for (size_t i = 0; i < 10 && i < available; i++)
+    {
+        uint64_t group = p[i] & 0x7F;
+        if (i == 9 && group > 1)
+            break; // wider than 64 bits
+        value |= group << (7 * i);
+        if (p[i] < 0x80)
+        {
+            buf->offset += i + 1;
+            return value;
+        }
+    }
+    set_buffer_error(buf);
+    return 0;
+}
+
+int64_t read_var_i64(Buffer *buf)
+{
+    uint64_t value = read_var_u64(buf);
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
 void read_fixed_array(Buffer *buf, void *out_array,
                       size_t elem_size, size_t length)
 {
@@ -569,6 +733,22 @@ void read_hashset(Buffer *buf, void **out_keys,
     }
 }
 
+const uint8_t *read_view(Buffer *buf, size_t count)
+{
+    if (buf->error)
+        return NULL;
+    // Same overrun check as read_le, written to be safe for huge counts.
+    // Overruns are expected on malformed input, so only the flag is set.
+    if (count > buf->size - buf->offset)
+    {
+        set_buffer_error(buf);
+        return NULL;
+    }
+    const uint8_t *view = buf->data + buf->offset;
+    buf->offset += count;
+    return view;
+}
+
 /* -----------------------------------------------------
  * Utility
  * ----------------------------------------------------- */
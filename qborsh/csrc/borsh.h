@@ -13,6 +13,8 @@ extern "C"
     /*
      * The primary buffer structure, storing data, capacity, size, etc.
      * 'error' indicates an out-of-bounds or out-of-memory condition.
+     * 'borrowed' marks memory the buffer does not own (see init_buffer_view):
+     * it is never grown or freed.
      */
     typedef struct
     {
@@ -21,6 +23,7 @@ extern "C"
         size_t capacity;
         size_t offset;
         bool error;
+        bool borrowed;
     } Buffer;
 
     /*
@@ -55,6 +58,18 @@ extern "C"
     void init_buffer(Buffer *buf, size_t initial_capacity);
     void free_buffer(Buffer *buf);
 
+    /*
+     * Points 'buf' at existing memory for reading only. The buffer does not
+     * own 'data': never write to it and never pass it to free_buffer().
+     */
+    void init_buffer_view(Buffer *buf, const uint8_t *data, size_t size);
+
+    /*
+     * Grows the buffer by 'count' bytes and returns where they start, so the
+     * caller can fill them directly (e.g. with read()). NULL on error.
+     */
+    uint8_t *buffer_reserve(Buffer *buf, size_t count);
+
     /* -----------------------------------------------------
      * Write Functions
      * ----------------------------------------------------- */
@@ -74,6 +89,21 @@ extern "C"
     void write_f64(Buffer *buf, double value);
     void write_bool(Buffer *buf, bool value);
 
+    /*
+     * Solana's compact-u16 (the "shortvec" length prefix): 1 to 3 bytes of
+     * 7 bits each, least significant first, the high bit marking that
+     * another byte follows.
+     */
+    void write_short_u16(Buffer *buf, uint16_t value);
+
+    /*
+     * Unsigned LEB128, 1 to 10 bytes of 7 bits each, least significant
+     * first. Signed values are zigzag mapped first (0, -1, 1, -2 ... to
+     * 0, 1, 2, 3 ...) so small magnitudes stay short.
+     */
+    void write_var_u64(Buffer *buf, uint64_t value);
+    void write_var_i64(Buffer *buf, int64_t value);
+
     void write_fixed_array(Buffer *buf, const void *array_data,
                            size_t elem_size, size_t length);
     void write_vec(Buffer *buf, const void *elem_data,
@@ -108,6 +138,20 @@ extern "C"
     double read_f64(Buffer *buf);
     bool read_bool(Buffer *buf);
 
+    /*
+     * Reads a compact-u16, rejecting what the Solana runtime rejects:
+     * non-canonical encodings (a trailing zero byte) and values above 0xFFFF.
+     */
+    uint16_t read_short_u16(Buffer *buf);
+
+    /*
+     * Reads an LEB128 value, rejecting encodings longer than 10 bytes or
+     * wider than 64 bits. Overlong (zero padded) encodings are accepted, as
+     * other LEB128 decoders do.
+     */
+    uint64_t read_var_u64(Buffer *buf);
+    int64_t read_var_i64(Buffer *buf);
+
     void read_fixed_array(Buffer *buf, void *out_array,
                           size_t elem_size, size_t length);
     void read_vec(Buffer *buf, void *out_array,
@@ -123,6 +167,12 @@ extern "C"
     void read_hashset(Buffer *buf, void **out_keys,
                       size_t *out_length, ReadFunc key_read_func);
 
+    /*
+     * Bounds-checked zero-copy read: returns a pointer to the next 'count'
+     * bytes and advances the offset. Check buffer_has_error() afterwards.
+     */
+    const uint8_t *read_view(Buffer *buf, size_t count);
+
     /* -----------------------------------------------------
      * Utility
      * ----------------------------------------------------- */
@@ -0,0 +1,88 @@
+#include "crc32c.h"
+#include <stdbool.h> // for bool
+#include <string.h>  // for memcpy
+
+/*
+ * Reflected Castagnoli polynomial.
+ */
+#define CRC32C_POLY 0x82F63B78u
+
+/*
+ * Slicing-by-8 tables for the portable path.
+ */
+static uint32_t g_table[8][256];
+
+static uint32_t (*g_crc32c)(uint32_t, const uint8_t *, size_t);
+
+static uint32_t crc32c_sw(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        word ^= crc;
+        crc = g_table[7][word & 0xFF] ^ g_table[6][(word >> 8) & 0xFF] ^
+              g_table[5][(word >> 16) & 0xFF] ^ g_table[4][(word >> 24) & 0xFF] ^
+              g_table[3][(word >> 32) & 0xFF] ^ g_table[2][(word >> 40) & 0xFF] ^
+              g_table[1][(word >> 48) & 0xFF] ^ g_table[0][word >> 56];
+        data += 8;
+        len -= 8;
+    }
+    while (len--)
+    {
+        crc = g_table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) static uint32_t crc32c_hw(uint32_t crc, const uint8_t *data, size_t len)
+{
+    uint64_t c = crc;
+    while (len >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        c = __builtin_ia32_crc32di(c, word);
+        data += 8;
+        len -= 8;
+    }
+    while (len--)
+    {
+        c = __builtin_ia32_crc32qi((uint32_t)c, *data++);
+    }
+    return (uint32_t)c;
+}
+#endif
+
+void crc32c_init(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+        {
+            c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+        }
+        g_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (int t = 1; t < 8; t++)
+        {
+            g_table[t][i] = (g_table[t - 1][i] >> 8) ^ g_table[0][g_table[t - 1][i] & 0xFF];
+        }
+    }
+
+    g_crc32c = crc32c_sw;
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        g_crc32c = crc32c_hw;
+#endif
+}
+
+uint32_t crc32c(uint32_t crc, const uint8_t *data, size_t len)
+{
+    return ~g_crc32c(~crc, data, len);
+}
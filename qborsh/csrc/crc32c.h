@@ -0,0 +1,27 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h> // for uint32_t
+#include <stddef.h> // for size_t
+
+    /*
+     * Builds the lookup tables and picks the SSE4.2 instruction when the CPU
+     * has it. Call once before crc32c().
+     */
+    void crc32c_init(void);
+
+    /*
+     * CRC-32C (Castagnoli) of 'len' bytes, continuing from 'crc' (0 to start).
+     */
+    uint32_t crc32c(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC32C_H */
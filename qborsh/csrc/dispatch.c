@@ -0,0 +1,85 @@
+#include "dispatch.h"
+#include <stdlib.h> // for malloc, free
+
+static bool alloc_slots(DispatchTable *table, size_t n_slots)
+{
+    uint64_t *keys = (uint64_t *)malloc(n_slots * sizeof(uint64_t));
+    size_t *entries = (size_t *)malloc(n_slots * sizeof(size_t));
+    if (!keys || !entries)
+    {
+        free(keys);
+        free(entries);
+        return false;
+    }
+    for (size_t i = 0; i < n_slots; i++)
+    {
+        entries[i] = DISPATCH_EMPTY;
+    }
+    table->keys = keys;
+    table->entries = entries;
+    table->n_slots = n_slots;
+    return true;
+}
+
+/*
+ * Places a key known to be absent; the table has a free slot.
+ */
+static void place(DispatchTable *table, uint64_t key, size_t entry)
+{
+    size_t mask = table->n_slots - 1;
+    size_t slot = (size_t)hash_mix(key) & mask;
+    while (table->entries[slot] != DISPATCH_EMPTY)
+    {
+        slot = (slot + 1) & mask;
+    }
+    table->keys[slot] = key;
+    table->entries[slot] = entry;
+}
+
+bool dispatch_init(DispatchTable *table, size_t width, size_t capacity)
+{
+    size_t n_slots = 8;
+    while (n_slots < 2 * capacity)
+    {
+        n_slots *= 2;
+    }
+    table->width = width;
+    table->count = 0;
+    return alloc_slots(table, n_slots);
+}
+
+int dispatch_insert(DispatchTable *table, uint64_t key, size_t entry)
+{
+    if (dispatch_find(table, key) != DISPATCH_EMPTY)
+        return 0;
+
+    if (2 * (table->count + 1) > table->n_slots)
+    {
+        // Rehash into twice the slots, keeping the table at most half full
+        DispatchTable old = *table;
+        if (!alloc_slots(table, old.n_slots * 2))
+        {
+            *table = old;
+            return -1;
+        }
+        for (size_t i = 0; i < old.n_slots; i++)
+        {
+            if (old.entries[i] != DISPATCH_EMPTY)
+                place(table, old.keys[i], old.entries[i]);
+        }
+        dispatch_free(&old);
+    }
+    place(table, key, entry);
+    table->count++;
+    return 1;
+}
+
+void dispatch_free(DispatchTable *table)
+{
+    free(table->keys);
+    free(table->entries);
+    table->keys = NULL;
+    table->entries = NULL;
+    table->n_slots = 0;
+    table->count = 0;
+}
@@ -0,0 +1,80 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint64_t
+#include <stddef.h>  // for size_t
+
+#include "hash.h"
+
+/*
+ * Marks an unused slot.
+ */
+#define DISPATCH_EMPTY SIZE_MAX
+
+    /*
+     * Hash table from discriminators (the first 1 to 8 bytes of a payload,
+     * read as a little-endian integer) to entry numbers. Open addressing
+     * with linear probing, kept at most half full, so a lookup is one hash
+     * and usually one or two key compares. Keys can be added at any time.
+     */
+    typedef struct
+    {
+        size_t width;   /* discriminator bytes */
+        size_t n_slots; /* power of two */
+        size_t count;
+        uint64_t *keys;
+        size_t *entries; /* DISPATCH_EMPTY when unused */
+    } DispatchTable;
+
+    /*
+     * Sets up an empty table for about 'capacity' keys. Returns false when
+     * out of memory.
+     */
+    bool dispatch_init(DispatchTable *table, size_t width, size_t capacity);
+
+    /*
+     * Maps 'key' to 'entry'. Returns 1 when added, 0 when the key is already
+     * in the table (which is left unchanged) and -1 when out of memory.
+     */
+    int dispatch_insert(DispatchTable *table, uint64_t key, size_t entry);
+
+    void dispatch_free(DispatchTable *table);
+
+    /*
+     * The discriminator of 'data', which holds at least 'width' bytes.
+     */
+    static inline uint64_t dispatch_key(const uint8_t *data, size_t width)
+    {
+        uint64_t key = 0;
+        for (size_t i = width; i-- > 0;)
+        {
+            key = (key << 8) | data[i];
+        }
+        return key;
+    }
+
+    /*
+     * Entry of 'key', or DISPATCH_EMPTY when it is not in the table.
+     */
+    static inline size_t dispatch_find(const DispatchTable *table, uint64_t key)
+    {
+        size_t mask = table->n_slots - 1;
+        for (size_t slot = (size_t)hash_mix(key) & mask;; slot = (slot + 1) & mask)
+        {
+            size_t entry = table->entries[slot];
+            if (entry == DISPATCH_EMPTY || table->keys[slot] == key)
+                return entry;
+        }
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISPATCH_H */
@@ -0,0 +1,55 @@
+#include "frames.h"
+#include "crc32c.h"
+#include <stdlib.h> // for malloc, realloc, free
+
+static inline uint32_t load_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+const uint8_t *frame_payload(const uint8_t *data, size_t size, size_t offset,
+                             bool verify, size_t *len)
+{
+    if (offset > size || size - offset < FRAME_HEADER)
+        return NULL;
+
+    const uint8_t *header = data + offset;
+    size_t n = load_u32(header);
+    if (n > size - offset - FRAME_HEADER)
+        return NULL;
+    if (verify && crc32c(0, header + FRAME_HEADER, n) != load_u32(header + 4))
+        return NULL;
+    *len = n;
+    return header + FRAME_HEADER;
+}
+
+size_t frames_scan(const uint8_t *data, size_t size, size_t start,
+                   bool verify, uint64_t **offsets, size_t *count)
+{
+    size_t capacity = 1024, n = 0, offset = start;
+    uint64_t *out = (uint64_t *)malloc(capacity * sizeof(uint64_t));
+    if (!out)
+        return SIZE_MAX;
+
+    size_t len;
+    while (frame_payload(data, size, offset, verify, &len))
+    {
+        if (n == capacity)
+        {
+            capacity = capacity * 3 / 2;
+            uint64_t *grown = (uint64_t *)realloc(out, capacity * sizeof(uint64_t));
+            if (!grown)
+            {
+                free(out);
+                return SIZE_MAX;
+            }
+            out = grown;
+        }
+        out[n++] = offset;
+        offset += FRAME_HEADER + len;
+    }
+
+    *offsets = out;
+    *count = n;
+    return offset;
+}
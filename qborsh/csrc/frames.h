@@ -0,0 +1,40 @@
+#ifndef FRAMES_H
+#define FRAMES_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint64_t
+#include <stddef.h>  // for size_t
+
+/*
+ * Every frame is a little-endian u32 payload length, the u32 CRC-32C of the
+ * payload, then the payload.
+ */
+#define FRAME_HEADER 8
+
+    /*
+     * Walks the frames starting at 'start' up to the first one that is
+     * truncated or (with 'verify') fails its checksum, which marks the torn
+     * tail of an unclean write. Stores the frame offsets in '*offsets'
+     * (malloc'ed, caller frees) and their number in '*count'. Returns the
+     * end of the last good frame, or SIZE_MAX when out of memory.
+     */
+    size_t frames_scan(const uint8_t *data, size_t size, size_t start,
+                       bool verify, uint64_t **offsets, size_t *count);
+
+    /*
+     * Checks the frame at 'offset'. Returns the payload and its length in
+     * '*len', or NULL if it is truncated or corrupt.
+     */
+    const uint8_t *frame_payload(const uint8_t *data, size_t size, size_t offset,
+                                 bool verify, size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAMES_H */
@@ -0,0 +1,309 @@
+#include "group.h"
+#include "hash.h"
+#include "pool.h"
+#include <stdlib.h> // for calloc, free
+#include <string.h> // for memcmp, memset
+
+/*
+ * Records per work-stealing chunk, as in scan.c.
+ */
+#define GROUP_GRAIN 4096
+
+/* -----------------------------------------------------
+ * Group Table
+ * ----------------------------------------------------- */
+
+static bool table_init(GroupTable *table, size_t capacity, size_t n_hist)
+{
+    memset(table, 0, sizeof(GroupTable));
+    table->n_hist = n_hist;
+    table->entries = (GroupEntry *)calloc(capacity, sizeof(GroupEntry));
+    if (!table->entries)
+        return false;
+    table->capacity = capacity;
+    return true;
+}
+
+void group_table_free(GroupTable *table)
+{
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        free(table->entries[i].hist);
+    }
+    free(table->entries);
+    memset(table, 0, sizeof(GroupTable));
+}
+
+static GroupEntry *table_probe(GroupEntry *entries, size_t capacity,
+                               const uint8_t *key, size_t key_len, uint64_t hash)
+{
+    size_t mask = capacity - 1;
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        GroupEntry *entry = &entries[i];
+        if (!entry->used)
+            return entry;
+        if (entry->hash == hash && entry->key_len == key_len &&
+            memcmp(entry->key, key, key_len) == 0)
+            return entry;
+    }
+}
+
+/*
+ * Doubles the table once it is half full.
+ */
+static bool table_grow(GroupTable *table)
+{
+    size_t capacity = table->capacity * 2;
+    GroupEntry *entries = (GroupEntry *)calloc(capacity, sizeof(GroupEntry));
+    if (!entries)
+        return false;
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        GroupEntry *old = &table->entries[i];
+        if (old->used)
+            *table_probe(entries, capacity, old->key, old->key_len, old->hash) = *old;
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
+    return true;
+}
+
+/*
+ * Returns the group for 'key', creating it if needed, or NULL when out of
+ * memory.
+ */
+static GroupEntry *table_get(GroupTable *table, const uint8_t *key,
+                             size_t key_len, uint64_t hash)
+{
+    GroupEntry *entry = table_probe(table->entries, table->capacity, key, key_len, hash);
+    if (entry->used)
+        return entry;
+
+    if ((table->count + 1) * 2 > table->capacity)
+    {
+        if (!table_grow(table))
+            return NULL;
+        entry = table_probe(table->entries, table->capacity, key, key_len, hash);
+    }
+    if (table->n_hist)
+    {
+        entry->hist = (uint64_t *)calloc(table->n_hist, sizeof(uint64_t));
+        if (!entry->hist)
+            return NULL;
+    }
+    entry->key = key;
+    entry->key_len = key_len;
+    entry->hash = hash;
+    entry->used = true;
+    table->count++;
+    return entry;
+}
+
+/* -----------------------------------------------------
+ * Histogram Buckets
+ * ----------------------------------------------------- */
+
+/*
+ * Index of the bucket holding 'value', or -1 when it falls outside the edges.
+ */
+static long bucket_of(const LayoutNumber *bins, size_t n_bins, const LayoutNumber *value)
+{
+    if (layout_number_compare(value, &bins[0]) < 0 ||
+        layout_number_compare(value, &bins[n_bins - 1]) > 0)
+        return -1;
+
+    // Largest lo with bins[lo] <= value, capped at the last bucket
+    size_t lo = 0, hi = n_bins - 1;
+    while (hi - lo > 1)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (layout_number_compare(&bins[mid], value) <= 0)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return (long)lo;
+}
+
+/* -----------------------------------------------------
+ * Parallel Grouping
+ * ----------------------------------------------------- */
+
+typedef struct
+{
+    const GroupQuery *query;
+    GroupTable *tables; /* one per worker */
+    size_t *bad;        /* per worker, SIZE_MAX when clean */
+    int failed;
+} GroupJob;
+
+static void group_task(void *ctx, size_t worker, size_t begin, size_t end)
+{
+    GroupJob *job = (GroupJob *)ctx;
+    const GroupQuery *query = job->query;
+    const ScanQuery *scan = query->scan;
+    GroupTable *table = &job->tables[worker];
+
+    if (__atomic_load_n(&job->failed, __ATOMIC_RELAXED) || table->error)
+        return;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const uint8_t *data;
+        size_t len;
+        bool malformed;
+        record_get(scan->records, i, &data, &len);
+
+        if (!scan_filter_record(scan, data, len, &malformed))
+        {
+            if (malformed)
+                goto fail;
+            continue;
+        }
+
+        // The group key is the encoded span of the key field
+        const uint8_t *key = NULL;
+        size_t key_len = 0;
+        if (query->grouped)
+        {
+            Buffer view;
+            init_buffer_view(&view, data, len);
+            const LayoutNode *node = layout_locate(scan->layout, &query->key, &view);
+            size_t start = view.offset;
+            if (!node || !layout_skip(node, &view))
+                goto fail;
+            key = data + start;
+            key_len = view.offset - start;
+        }
+
+        GroupEntry *entry = table_get(table, key, key_len, hash_bytes(key, key_len));
+        if (!entry)
+        {
+            table->error = true;
+            return;
+        }
+
+        if (query->op == GROUP_COUNT)
+        {
+            entry->acc.count++;
+            continue;
+        }
+
+        Buffer view;
+        LayoutNumber value;
+        init_buffer_view(&view, data, len);
+        const LayoutNode *node = layout_locate(scan->layout, &query->field, &view);
+        if (!node || !layout_read_number(node, &view, &value))
+            goto fail;
+
+        if (query->op == GROUP_HISTOGRAM)
+        {
+            long bucket = bucket_of(query->bins, query->n_bins, &value);
+            if (bucket >= 0)
+                entry->hist[bucket]++;
+            entry->acc.count++;
+        }
+        else
+        {
+            scan_acc_add(&entry->acc, &value);
+        }
+        continue;
+
+    fail:
+        if (i < job->bad[worker])
+            job->bad[worker] = i;
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+}
+
+/*
+ * Folds every group of 'from' into 'into'.
+ */
+static bool table_merge(GroupTable *into, const GroupTable *from)
+{
+    for (size_t i = 0; i < from->capacity; i++)
+    {
+        const GroupEntry *src = &from->entries[i];
+        if (!src->used)
+            continue;
+
+        GroupEntry *dst = table_get(into, src->key, src->key_len, src->hash);
+        if (!dst)
+            return false;
+        if (into->n_hist)
+        {
+            for (size_t b = 0; b < into->n_hist; b++)
+            {
+                dst->hist[b] += src->hist[b];
+            }
+            dst->acc.count += src->acc.count;
+        }
+        else
+        {
+            // Count-only accumulators keep zeroed min/max, so merging is safe
+            scan_acc_merge(&dst->acc, &src->acc);
+        }
+    }
+    return true;
+}
+
+ScanStatus group_run(const GroupQuery *query, size_t n_workers,
+                     GroupTable *out, size_t *bad_record)
+{
+    if (n_workers == 0)
+        n_workers = 1;
+
+    size_t n_hist = query->op == GROUP_HISTOGRAM ? query->n_bins - 1 : 0;
+    GroupTable *tables = (GroupTable *)calloc(n_workers, sizeof(GroupTable));
+    size_t *bad = (size_t *)malloc(n_workers * sizeof(size_t));
+    bool ok = tables && bad;
+    for (size_t w = 0; ok && w < n_workers; w++)
+    {
+        ok = table_init(&tables[w], 16, n_hist);
+        bad[w] = SIZE_MAX;
+    }
+
+    ScanStatus status = SCAN_OK;
+    *bad_record = SIZE_MAX;
+    if (ok)
+    {
+        GroupJob job = {query, tables, bad, 0};
+        pool_run(query->scan->records->count, GROUP_GRAIN, n_workers, group_task, &job);
+
+        for (size_t w = 0; w < n_workers; w++)
+        {
+            if (bad[w] < *bad_record)
+            {
+                *bad_record = bad[w];
+                status = SCAN_ERR_MALFORMED;
+            }
+            if (tables[w].error)
+                ok = false;
+        }
+        for (size_t w = 1; ok && status == SCAN_OK && w < n_workers; w++)
+        {
+            ok = table_merge(&tables[0], &tables[w]);
+        }
+    }
+    if (!ok && status == SCAN_OK)
+        status = SCAN_ERR_NOMEM;
+
+    if (tables)
+    {
+        for (size_t w = 0; w < n_workers; w++)
+        {
+            if (w == 0 && status == SCAN_OK)
+                continue;
+            if (tables[w].entries)
+                group_table_free(&tables[w]);
+        }
+        if (status == SCAN_OK)
+            *out = tables[0];
+    }
+    free(tables);
+    free(bad);
+    return status;
+}
@@ -0,0 +1,76 @@
+#ifndef GROUP_H
+#define GROUP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint64_t
+#include <stddef.h>  // for size_t
+#include "layout.h"
+#include "scan.h"
+
+    typedef enum
+    {
+        GROUP_COUNT,
+        GROUP_SUM,
+        GROUP_MIN,
+        GROUP_MAX,
+        GROUP_HISTOGRAM,
+    } GroupOp;
+
+    /*
+     * One group. 'key' points at the encoded key bytes inside a record, so
+     * a table is only valid while its records are.
+     */
+    typedef struct
+    {
+        const uint8_t *key;
+        size_t key_len;
+        uint64_t hash;
+        bool used;
+        ScanAcc acc;
+        uint64_t *hist; /* n_hist bucket counts (histograms only) */
+    } GroupEntry;
+
+    /*
+     * Open-addressing (linear probing) table of groups.
+     */
+    typedef struct
+    {
+        GroupEntry *entries;
+        size_t capacity;
+        size_t count;
+        size_t n_hist;
+        bool error; /* out of memory */
+    } GroupTable;
+
+    /*
+     * Aggregates 'field' with 'op' over the records of 'scan' that pass its
+     * filters (its aggregates are ignored), optionally grouped by the
+     * encoded bytes of the 'key' field. Histograms count values into the
+     * n_bins - 1 buckets delimited by the sorted 'bins' edges; the last
+     * bucket includes its upper edge and values outside are not counted.
+     */
+    typedef struct
+    {
+        const ScanQuery *scan;
+        GroupOp op;
+        LayoutPath field;
+        bool grouped;
+        LayoutPath key;
+        const LayoutNumber *bins;
+        size_t n_bins;
+    } GroupQuery;
+
+    ScanStatus group_run(const GroupQuery *query, size_t n_workers,
+                         GroupTable *out, size_t *bad_record);
+    void group_table_free(GroupTable *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GROUP_H */
@@ -0,0 +1,51 @@
+#ifndef HASH_H
+#define HASH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h> // for uint64_t
+#include <stddef.h> // for size_t
+#include <string.h> // for memcpy
+
+    /*
+     * Final avalanche step of MurmurHash3 (fmix64).
+     */
+    static inline uint64_t hash_mix(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /*
+     * Fast 64-bit hash of a byte string, eight bytes per step. Used for
+     * in-memory tables of encoded keys; not cryptographic.
+     */
+    static inline uint64_t hash_bytes(const uint8_t *data, size_t len)
+    {
+        uint64_t h = 0x9e3779b97f4a7c15ULL ^ (uint64_t)len;
+        while (len >= 8)
+        {
+            uint64_t word;
+            memcpy(&word, data, 8);
+            h = hash_mix(h ^ word) + 0x9e3779b97f4a7c15ULL;
+            data += 8;
+            len -= 8;
+        }
+        uint64_t tail = 0;
+        if (len) // data may be NULL for an empty key
+            memcpy(&tail, data, len);
+        return hash_mix(h ^ tail);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASH_H */
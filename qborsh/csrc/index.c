@@ -0,0 +1,225 @@
+#include "index.h"
+#include "hash.h"
+#include "pool.h"
+#include <stdlib.h> // for malloc, free
+#include <string.h> // for memcmp, memcpy, memset
+
+/*
+ * Records per work-stealing chunk while hashing keys.
+ */
+#define INDEX_GRAIN 4096
+
+size_t index_bytes(size_t count)
+{
+    size_t capacity = 16;
+    while (capacity < 2 * count)
+    {
+        capacity *= 2;
+    }
+    return sizeof(IndexHeader) + capacity * sizeof(IndexSlot);
+}
+
+/*
+ * Finds the encoded bytes of the indexed field in one record.
+ */
+static bool key_span(const LayoutNode *layout, const LayoutPath *path,
+                     const uint8_t *data, size_t len,
+                     const uint8_t **key, size_t *key_len)
+{
+    Buffer view;
+    init_buffer_view(&view, data, len);
+    const LayoutNode *node = layout_locate(layout, path, &view);
+    size_t start = view.offset;
+    if (!node || !layout_skip(node, &view))
+        return false;
+    *key = data + start;
+    *key_len = view.offset - start;
+    return true;
+}
+
+/* -----------------------------------------------------
+ * Building
+ * ----------------------------------------------------- */
+
+typedef struct
+{
+    const LayoutNode *layout;
+    const LayoutPath *path;
+    const RecordSet *rs;
+    uint64_t *hashes;
+    size_t *bad; /* per worker, SIZE_MAX when clean */
+    int failed;
+} HashJob;
+
+static void hash_task(void *ctx, size_t worker, size_t begin, size_t end)
+{
+    HashJob *job = (HashJob *)ctx;
+    if (__atomic_load_n(&job->failed, __ATOMIC_RELAXED))
+        return;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const uint8_t *data, *key;
+        size_t len, key_len;
+        record_get(job->rs, i, &data, &len);
+        if (!key_span(job->layout, job->path, data, len, &key, &key_len))
+        {
+            if (i < job->bad[worker])
+                job->bad[worker] = i;
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        job->hashes[i] = hash_bytes(key, key_len);
+    }
+}
+
+ScanStatus index_build(const LayoutNode *layout, const LayoutPath *path,
+                       const RecordSet *rs, size_t n_workers, void *out,
+                       size_t *bad_record)
+{
+    if (n_workers == 0)
+        n_workers = 1;
+
+    size_t n = rs->count;
+    *bad_record = SIZE_MAX;
+    uint64_t *hashes = (uint64_t *)malloc((n ? n : 1) * sizeof(uint64_t));
+    size_t *bad = (size_t *)malloc(n_workers * sizeof(size_t));
+    if (!hashes || !bad)
+    {
+        free(hashes);
+        free(bad);
+        return SCAN_ERR_NOMEM;
+    }
+    for (size_t w = 0; w < n_workers; w++)
+    {
+        bad[w] = SIZE_MAX;
+    }
+
+    HashJob job = {layout, path, rs, hashes, bad, 0};
+    pool_run(n, INDEX_GRAIN, n_workers, hash_task, &job);
+
+    ScanStatus status = SCAN_OK;
+    for (size_t w = 0; w < n_workers; w++)
+    {
+        if (bad[w] < *bad_record)
+        {
+            *bad_record = bad[w];
+            status = SCAN_ERR_MALFORMED;
+        }
+    }
+
+    if (status == SCAN_OK)
+    {
+        IndexHeader *header = (IndexHeader *)out;
+        IndexSlot *slots = (IndexSlot *)(header + 1);
+        size_t capacity = (index_bytes(n) - sizeof(IndexHeader)) / sizeof(IndexSlot);
+
+        memset(header, 0, sizeof(IndexHeader));
+        memcpy(header->magic, INDEX_MAGIC, sizeof(header->magic));
+        header->version = INDEX_VERSION;
+        header->capacity = capacity;
+        header->count = n;
+        header->depth = path->depth;
+        for (size_t d = 0; d < path->depth; d++)
+        {
+            header->path[d] = path->index[d];
+        }
+        for (size_t s = 0; s < capacity; s++)
+        {
+            slots[s].offset = INDEX_EMPTY;
+        }
+
+        // Inserting in record order keeps duplicates in that order along
+        // their probe sequence
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < n; i++)
+        {
+            const uint8_t *data;
+            size_t len;
+            record_get(rs, i, &data, &len);
+
+            size_t s = (size_t)hashes[i] & mask;
+            while (slots[s].offset != INDEX_EMPTY)
+            {
+                s = (s + 1) & mask;
+            }
+            slots[s].hash = hashes[i];
+            slots[s].offset = (uint64_t)(data - rs->base);
+            slots[s].length = len;
+        }
+    }
+
+    free(hashes);
+    free(bad);
+    return status;
+}
+
+/* -----------------------------------------------------
+ * Lookups
+ * ----------------------------------------------------- */
+
+bool index_open(IndexView *view, const void *index, size_t len,
+                const LayoutNode *layout, const uint8_t *data, size_t size)
+{
+    const IndexHeader *header = (const IndexHeader *)index;
+    if (len < sizeof(IndexHeader) || ((uintptr_t)index % sizeof(uint64_t)) != 0)
+        return false;
+    if (memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != INDEX_VERSION || header->depth > LAYOUT_MAX_DEPTH)
+        return false;
+
+    uint64_t capacity = header->capacity;
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || header->count > capacity ||
+        capacity > (len - sizeof(IndexHeader)) / sizeof(IndexSlot) ||
+        len != sizeof(IndexHeader) + capacity * sizeof(IndexSlot))
+        return false;
+
+    view->path.depth = (size_t)header->depth;
+    for (size_t d = 0; d < view->path.depth; d++)
+    {
+        view->path.index[d] = (size_t)header->path[d];
+    }
+    if (!layout_field(layout, &view->path))
+        return false;
+
+    view->header = header;
+    view->slots = (const IndexSlot *)(header + 1);
+    view->layout = layout;
+    view->data = data;
+    view->size = size;
+    return true;
+}
+
+bool index_next(const IndexView *view, const uint8_t *key, size_t key_len,
+                uint64_t *cursor, uint64_t *offset, uint64_t *length)
+{
+    uint64_t hash = hash_bytes(key, key_len);
+    uint64_t capacity = view->header->capacity;
+    uint64_t mask = capacity - 1;
+
+    // The cursor counts probed slots, so a full table still terminates
+    for (; *cursor < capacity; (*cursor)++)
+    {
+        const IndexSlot *slot = &view->slots[(hash + *cursor) & mask];
+        if (slot->offset == INDEX_EMPTY)
+            return false;
+        if (slot->hash != hash || slot->offset > view->size ||
+            slot->length > view->size - slot->offset)
+            continue;
+
+        // Confirm the key itself: different keys may share a hash
+        const uint8_t *found;
+        size_t found_len;
+        if (!key_span(view->layout, &view->path, view->data + slot->offset,
+                      (size_t)slot->length, &found, &found_len))
+            continue;
+        if (found_len == key_len && memcmp(found, key, key_len) == 0)
+        {
+            *offset = slot->offset;
+            *length = slot->length;
+            (*cursor)++;
+            return true;
+        }
+    }
+    return false;
+}
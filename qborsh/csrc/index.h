@@ -0,0 +1,96 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint64_t
+#include <stddef.h>  // for size_t
+#include "layout.h"
+#include "records.h"
+#include "scan.h"
+
+#define INDEX_MAGIC "QBIDX\0\0\0"
+#define INDEX_VERSION 1
+
+/*
+ * Marks an unused slot.
+ */
+#define INDEX_EMPTY UINT64_MAX
+
+    /*
+     * A persisted index is this header followed by 'capacity' slots, in
+     * host byte order, so it can be used straight from a memory map.
+     */
+    typedef struct
+    {
+        char magic[8];
+        uint64_t version;
+        uint64_t capacity; /* power of two */
+        uint64_t count;
+        uint64_t depth;
+        uint64_t path[LAYOUT_MAX_DEPTH]; /* indexed field */
+    } IndexHeader;
+
+    /*
+     * One record: the hash of its encoded key and its byte range in the
+     * record block.
+     */
+    typedef struct
+    {
+        uint64_t hash;
+        uint64_t offset; /* INDEX_EMPTY when unused */
+        uint64_t length;
+    } IndexSlot;
+
+    /*
+     * An index opened over its record block.
+     */
+    typedef struct
+    {
+        const IndexHeader *header;
+        const IndexSlot *slots;
+        const LayoutNode *layout;
+        LayoutPath path;
+        const uint8_t *data;
+        size_t size;
+    } IndexView;
+
+    /*
+     * Bytes needed for an index of 'count' records (load factor <= 0.5).
+     */
+    size_t index_bytes(size_t count);
+
+    /*
+     * Builds an index on the 'path' field of the records 'rs', which must be
+     * framed from one block (offsets are relative to rs->base). 'out' must
+     * hold index_bytes(rs->count) bytes. Keys are hashed on 'n_workers'
+     * threads.
+     */
+    ScanStatus index_build(const LayoutNode *layout, const LayoutPath *path,
+                           const RecordSet *rs, size_t n_workers, void *out,
+                           size_t *bad_record);
+
+    /*
+     * Validates a persisted index of 'len' bytes against 'layout'. Returns
+     * false if it is corrupt or built for another field.
+     */
+    bool index_open(IndexView *view, const void *index, size_t len,
+                    const LayoutNode *layout, const uint8_t *data, size_t size);
+
+    /*
+     * Iterates the records whose key encodes to 'key'. Start with *cursor =
+     * 0; each call returns the next match in insertion order. Returns false
+     * once there are no more.
+     */
+    bool index_next(const IndexView *view, const uint8_t *key, size_t key_len,
+                    uint64_t *cursor, uint64_t *offset, uint64_t *length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INDEX_H */
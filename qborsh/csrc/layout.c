@@ -0,0 +1,470 @@
+#include "layout.h"
+#include <stdlib.h> // for calloc, free
+
+/* -----------------------------------------------------
+ * Construction / Cleanup
+ * ----------------------------------------------------- */
+
+LayoutNode *layout_new(LayoutKind kind, size_t n_children)
+{
+    LayoutNode *node = (LayoutNode *)calloc(1, sizeof(LayoutNode));
+    if (!node)
+        return NULL;
+
+    node->kind = kind;
+    node->size = LAYOUT_VARIABLE;
+    if (n_children > 0)
+    {
+        node->children = (LayoutNode **)calloc(n_children, sizeof(LayoutNode *));
+        if (!node->children)
+        {
+            free(node);
+            return NULL;
+        }
+        node->n_children = n_children;
+    }
+    return node;
+}
+
+void layout_free(LayoutNode *node, void (*release)(void *))
+{
+    if (!node)
+        return;
+    for (size_t i = 0; i < node->n_children; i++)
+    {
+        layout_free(node->children[i], release);
+    }
+    if (node->name && release)
+    {
+        release(node->name);
+    }
+    if (node->meta && release)
+    {
+        release(node->meta);
+    }
+    free(node->children);
+    free(node->offsets);
+    free(node);
+}
+
+/*
+ * Encoded size of a scalar kind, or 0 if the kind is not a scalar.
+ */
+static size_t scalar_size(LayoutKind kind)
+{
+    switch (kind)
+    {
+    case LAYOUT_U8:
+    case LAYOUT_I8:
+    case LAYOUT_BOOL:
+        return 1;
+    case LAYOUT_U16:
+    case LAYOUT_I16:
+        return 2;
+    case LAYOUT_U32:
+    case LAYOUT_I32:
+    case LAYOUT_F32:
+        return 4;
+    case LAYOUT_U64:
+    case LAYOUT_I64:
+    case LAYOUT_F64:
+        return 8;
+    case LAYOUT_U128:
+    case LAYOUT_I128:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+bool layout_finalize(LayoutNode *node)
+{
+    size_t scalar = scalar_size(node->kind);
+    if (scalar)
+    {
+        node->size = scalar;
+        return true;
+    }
+
+    switch (node->kind)
+    {
+    case LAYOUT_PUBKEY:
+        node->size = 32;
+        return true;
+    case LAYOUT_PADDING:
+    case LAYOUT_FIXED_BYTES:
+        node->size = node->length;
+        return true;
+    case LAYOUT_VIEW:
+        node->size = node->children[0]->size;
+        return true;
+    case LAYOUT_COPTION:
+        // Compiling checked the element is fixed-size
+        node->size = 4 + node->children[0]->size;
+        return true;
+    case LAYOUT_ARRAY:
+    {
+        size_t elem = node->children[0]->size;
+        if (elem == LAYOUT_VARIABLE)
+            return true;
+        if (elem != 0 && node->length > (LAYOUT_VARIABLE - 1) / elem)
+            return false; // overflow
+        node->size = elem * node->length;
+        return true;
+    }
+    case LAYOUT_STRUCT:
+    case LAYOUT_TUPLE:
+    {
+        // One extra slot so offsets[n_children] is the size of a fixed struct
+        node->offsets = (size_t *)malloc((node->n_children + 1) * sizeof(size_t));
+        if (!node->offsets)
+            return false;
+
+        size_t offset = 0;
+        node->first_variable = node->n_children;
+        for (size_t i = 0; i < node->n_children; i++)
+        {
+            node->offsets[i] = offset;
+            if (offset == LAYOUT_VARIABLE)
+                continue;
+
+            size_t field = node->children[i]->size;
+            if (field == LAYOUT_VARIABLE || field > LAYOUT_VARIABLE - 1 - offset)
+            {
+                node->first_variable = i;
+                offset = LAYOUT_VARIABLE;
+                continue;
+            }
+            offset += field;
+        }
+        node->offsets[node->n_children] = offset;
+        node->size = offset;
+        return true;
+    }
+    case LAYOUT_ENUM:
+    {
+        // Fixed only when every variant's payload has the same fixed size
+        size_t payload = node->n_children ? node->children[0]->size : LAYOUT_VARIABLE;
+        for (size_t i = 1; i < node->n_children; i++)
+        {
+            if (node->children[i]->size != payload)
+                payload = LAYOUT_VARIABLE;
+        }
+        if (payload < LAYOUT_VARIABLE - 1)
+            node->size = 1 + payload;
+        return true;
+    }
+    default:
+        // Length-prefixed and optional values are always variable
+        return true;
+    }
+}
+
+/* -----------------------------------------------------
+ * Walking Encoded Data
+ * ----------------------------------------------------- */
+
+/*
+ * Skips 'count' length-prefixed blobs, the wire format of Map and Set.
+ */
+static bool skip_blobs(Buffer *buf, uint64_t count)
+{
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint32_t length = read_u32(buf);
+        read_view(buf, length);
+        if (buffer_has_error(buf))
+            return false;
+    }
+    return true;
+}
+
+bool layout_skip(const LayoutNode *node, Buffer *buf)
+{
+    // Fixed-size values (including whole fixed structs) skip in one step
+    if (node->size != LAYOUT_VARIABLE)
+    {
+        read_view(buf, node->size);
+        return !buffer_has_error(buf);
+    }
+
+    switch (node->kind)
+    {
+    case LAYOUT_STRING:
+    case LAYOUT_BYTES:
+    {
+        uint32_t length = read_u32(buf);
+        read_view(buf, length);
+        break;
+    }
+    case LAYOUT_SHORT_U16:
+        read_short_u16(buf);
+        break;
+    case LAYOUT_VAR_U64:
+    case LAYOUT_VAR_I64:
+        read_var_u64(buf);
+        break;
+    case LAYOUT_SHORT_BYTES:
+    {
+        uint16_t length = read_short_u16(buf);
+        read_view(buf, length);
+        break;
+    }
+    case LAYOUT_VIEW:
+        return layout_skip(node->children[0], buf);
+    case LAYOUT_VERSIONED:
+    {
+        const LayoutNode *message = layout_version(node, buf, NULL);
+        return message && layout_skip(message, buf);
+    }
+    case LAYOUT_VEC:
+    case LAYOUT_SHORT_VEC:
+    {
+        uint32_t count = node->kind == LAYOUT_VEC ? read_u32(buf) : read_short_u16(buf);
+        const LayoutNode *elem = node->children[0];
+        if (buffer_has_error(buf))
+            return false;
+        if (elem->size != LAYOUT_VARIABLE)
+        {
+            if (elem->size != 0 && count > SIZE_MAX / elem->size)
+            {
+                buf->error = true;
+                return false;
+            }
+            read_view(buf, (size_t)count * elem->size);
+            break;
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (!layout_skip(elem, buf))
+                return false;
+        }
+        break;
+    }
+    case LAYOUT_ARRAY:
+        for (size_t i = 0; i < node->length; i++)
+        {
+            if (!layout_skip(node->children[0], buf))
+                return false;
+        }
+        break;
+    case LAYOUT_OPTION:
+    {
+        uint8_t tag = read_u8(buf);
+        if (tag && !buffer_has_error(buf))
+            return layout_skip(node->children[0], buf);
+        break;
+    }
+    case LAYOUT_MAP:
+    {
+        uint32_t count = read_u32(buf);
+        return !buffer_has_error(buf) && skip_blobs(buf, (uint64_t)count * 2);
+    }
+    case LAYOUT_SET:
+    {
+        uint32_t count = read_u32(buf);
+        return !buffer_has_error(buf) && skip_blobs(buf, count);
+    }
+    case LAYOUT_ENUM:
+    {
+        uint8_t tag = read_u8(buf);
+        if (buffer_has_error(buf))
+            return false;
+        if (tag >= node->n_children)
+        {
+            buf->error = true;
+            return false;
+        }
+        return layout_skip(node->children[tag], buf);
+    }
+    case LAYOUT_STRUCT:
+    case LAYOUT_TUPLE:
+        // Jump over the fixed-size prefix, then walk the remaining fields
+        read_view(buf, node->offsets[node->first_variable]);
+        for (size_t i = node->first_variable; i < node->n_children; i++)
+        {
+            if (!layout_skip(node->children[i], buf))
+                return false;
+        }
+        break;
+    default:
+        return false;
+    }
+    return !buffer_has_error(buf);
+}
+
+const LayoutNode *layout_version(const LayoutNode *node, Buffer *buf, int *version)
+{
+    if (buf->error || buf->offset >= buf->size)
+    {
+        buf->error = true;
+        return NULL;
+    }
+    uint8_t prefix = buf->data[buf->offset];
+    if (!(prefix & 0x80))
+    {
+        // Legacy: the byte already belongs to the message
+        if (version)
+            *version = -1;
+        return node->children[0];
+    }
+    buf->offset++;
+    size_t index = 1 + (size_t)(prefix & 0x7F);
+    if (version)
+        *version = prefix & 0x7F;
+    return index < node->n_children ? node->children[index] : NULL;
+}
+
+const LayoutNode *layout_locate(const LayoutNode *root,
+                                const LayoutPath *path, Buffer *buf)
+{
+    const LayoutNode *node = root;
+    for (size_t d = 0; d < path->depth; d++)
+    {
+        size_t index = path->index[d];
+        if ((node->kind != LAYOUT_STRUCT && node->kind != LAYOUT_TUPLE) || index >= node->n_children)
+            return NULL;
+
+        if (node->offsets[index] != LAYOUT_VARIABLE)
+        {
+            read_view(buf, node->offsets[index]);
+        }
+        else
+        {
+            read_view(buf, node->offsets[node->first_variable]);
+            for (size_t i = node->first_variable; i < index; i++)
+            {
+                if (!layout_skip(node->children[i], buf))
+                    return NULL;
+            }
+        }
+        if (buffer_has_error(buf))
+            return NULL;
+        node = node->children[index];
+    }
+    return node;
+}
+
+const LayoutNode *layout_field(const LayoutNode *root, const LayoutPath *path)
+{
+    const LayoutNode *node = root;
+    for (size_t d = 0; d < path->depth; d++)
+    {
+        if ((node->kind != LAYOUT_STRUCT && node->kind != LAYOUT_TUPLE) || path->index[d] >= node->n_children)
+            return NULL;
+        node = node->children[path->index[d]];
+    }
+    return node;
+}
+
+/* -----------------------------------------------------
+ * Numeric Fields
+ * ----------------------------------------------------- */
+
+bool layout_is_numeric(LayoutKind kind)
+{
+    return scalar_size(kind) != 0;
+}
+
+bool layout_read_number(const LayoutNode *node, Buffer *buf, LayoutNumber *out)
+{
+    switch (node->kind)
+    {
+    case LAYOUT_U8:
+        out->type = LAYOUT_NUM_UINT;
+        out->u = read_u8(buf);
+        break;
+    case LAYOUT_U16:
+        out->type = LAYOUT_NUM_UINT;
+        out->u = read_u16(buf);
+        break;
+    case LAYOUT_U32:
+        out->type = LAYOUT_NUM_UINT;
+        out->u = read_u32(buf);
+        break;
+    case LAYOUT_U64:
+        out->type = LAYOUT_NUM_UINT;
+        out->u = read_u64(buf);
+        break;
+    case LAYOUT_U128:
+        out->type = LAYOUT_NUM_UINT;
+        out->u = read_u128(buf);
+        break;
+    case LAYOUT_BOOL:
+        out->type = LAYOUT_NUM_UINT;
+        out->u = read_bool(buf);
+        break;
+    case LAYOUT_I8:
+        out->type = LAYOUT_NUM_INT;
+        out->i = read_i8(buf);
+        break;
+    case LAYOUT_I16:
+        out->type = LAYOUT_NUM_INT;
+        out->i = read_i16(buf);
+        break;
+    case LAYOUT_I32:
+        out->type = LAYOUT_NUM_INT;
+        out->i = read_i32(buf);
+        break;
+    case LAYOUT_I64:
+        out->type = LAYOUT_NUM_INT;
+        out->i = read_i64(buf);
+        break;
+    case LAYOUT_I128:
+        out->type = LAYOUT_NUM_INT;
+        out->i = read_i128(buf);
+        break;
+    case LAYOUT_F32:
+        out->type = LAYOUT_NUM_FLOAT;
+        out->f = read_f32(buf);
+        break;
+    case LAYOUT_F64:
+        out->type = LAYOUT_NUM_FLOAT;
+        out->f = read_f64(buf);
+        break;
+    default:
+        return false;
+    }
+    return !buffer_has_error(buf);
+}
+
+static double number_as_double(const LayoutNumber *n)
+{
+    switch (n->type)
+    {
+    case LAYOUT_NUM_UINT:
+        return (double)n->u;
+    case LAYOUT_NUM_INT:
+        return (double)n->i;
+    default:
+        return n->f;
+    }
+}
+
+#define THREE_WAY(a, b) (((a) > (b)) - ((a) < (b)))
+
+int layout_number_compare(const LayoutNumber *a, const LayoutNumber *b)
+{
+    if (a->type == LAYOUT_NUM_FLOAT || b->type == LAYOUT_NUM_FLOAT)
+    {
+        double x = number_as_double(a);
+        double y = number_as_double(b);
+        return THREE_WAY(x, y);
+    }
+    if (a->type == b->type)
+    {
+        if (a->type == LAYOUT_NUM_UINT)
+            return THREE_WAY(a->u, b->u);
+        return THREE_WAY(a->i, b->i);
+    }
+    // Mixed signedness: a negative signed value is below every unsigned one
+    if (a->type == LAYOUT_NUM_INT)
+    {
+        if (a->i < 0)
+            return -1;
+        return THREE_WAY((unsigned __int128)a->i, b->u);
+    }
+    if (b->i < 0)
+        return 1;
+    return THREE_WAY(a->u, (unsigned __int128)b->i);
+}
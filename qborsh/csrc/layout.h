@@ -0,0 +1,184 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for SIZE_MAX, uint8_t, etc.
+#include <stddef.h>  // for size_t
+#include "borsh.h"
+
+/*
+ * Marks a node (or struct field offset) whose encoded size depends on the data.
+ */
+#define LAYOUT_VARIABLE SIZE_MAX
+
+/*
+ * Maximum nesting of struct fields addressed by a LayoutPath.
+ */
+#define LAYOUT_MAX_DEPTH 16
+
+    /*
+     * The kinds of encoded values a layout can describe. Every qborsh type
+     * with a native layout maps onto one of these.
+     */
+    typedef enum
+    {
+        LAYOUT_U8,
+        LAYOUT_U16,
+        LAYOUT_U32,
+        LAYOUT_U64,
+        LAYOUT_U128,
+        LAYOUT_I8,
+        LAYOUT_I16,
+        LAYOUT_I32,
+        LAYOUT_I64,
+        LAYOUT_I128,
+        LAYOUT_F32,
+        LAYOUT_F64,
+        LAYOUT_BOOL,
+        LAYOUT_PUBKEY,  /* 32 raw bytes */
+        LAYOUT_PADDING, /* 'length' ignored bytes */
+        LAYOUT_STRING,  /* u32 length + utf-8 bytes */
+        LAYOUT_BYTES,   /* u32 length + raw bytes */
+        LAYOUT_VEC,     /* u32 count + elements */
+        LAYOUT_ARRAY,   /* 'length' elements */
+        LAYOUT_OPTION,  /* u8 tag + element when the tag is set */
+        LAYOUT_MAP,     /* u32 count + length-prefixed key/value blobs */
+        LAYOUT_SET,     /* u32 count + length-prefixed element blobs */
+        LAYOUT_STRUCT,  /* fields in declaration order */
+        LAYOUT_ENUM,    /* u8 variant index + that variant's payload */
+        LAYOUT_TUPLE,   /* unnamed fields in order, laid out like a struct */
+        LAYOUT_SHORT_U16, /* Solana compact-u16, 1 to 3 bytes */
+        LAYOUT_SHORT_VEC, /* compact-u16 count + elements */
+        LAYOUT_FIXED_BYTES, /* 'length' raw bytes */
+        LAYOUT_SHORT_BYTES, /* compact-u16 length + raw bytes */
+        LAYOUT_VIEW,        /* a bytes kind, decoded without copying */
+        LAYOUT_VERSIONED,   /* Solana message: a 0x80 | version prefix byte, or none for legacy */
+        LAYOUT_VAR_U64,     /* LEB128, 1 to 10 bytes */
+        LAYOUT_VAR_I64,     /* zigzag + LEB128 */
+        LAYOUT_COPTION,     /* Solana COption: u32 tag + fixed-size element, present either way */
+    } LayoutKind;
+
+    /*
+     * One node of a compiled layout tree.
+     *
+     * 'size' is the encoded size when it is fixed, else LAYOUT_VARIABLE. For
+     * structs (and tuples), 'offsets[i]' is the fixed offset of field i (known up to the
+     * first variable-size field, 'first_variable') and LAYOUT_VARIABLE after.
+     * Enums have one child per variant, indexed by the variant tag; unit
+     * variants are zero-length padding. Versioned nodes have the legacy
+     * layout first, then one child per version.
+     */
+    typedef struct LayoutNode
+    {
+        LayoutKind kind;
+        size_t size;
+        size_t length;
+        size_t n_children;
+        struct LayoutNode **children;
+        size_t *offsets;
+        size_t first_variable;
+        void *name; /* struct field / enum variant name, owned by the Python layer */
+        void *meta; /* struct result type / enum variant lookup, owned likewise */
+        bool interned; /* strings and pubkeys: decode through the intern table */
+    } LayoutNode;
+
+    /*
+     * A field addressed by its index in each enclosing struct or tuple.
+     */
+    typedef struct
+    {
+        size_t index[LAYOUT_MAX_DEPTH];
+        size_t depth;
+    } LayoutPath;
+
+    typedef enum
+    {
+        LAYOUT_NUM_UINT,
+        LAYOUT_NUM_INT,
+        LAYOUT_NUM_FLOAT,
+    } LayoutNumType;
+
+    /*
+     * A numeric field value widened to the largest type of its family.
+     */
+    typedef struct
+    {
+        LayoutNumType type;
+        union
+        {
+            unsigned __int128 u;
+            __int128 i;
+            double f;
+        };
+    } LayoutNumber;
+
+    /* -----------------------------------------------------
+     * Construction / Cleanup
+     * ----------------------------------------------------- */
+    LayoutNode *layout_new(LayoutKind kind, size_t n_children);
+
+    /*
+     * Frees the tree, handing every 'name' and 'meta' to 'release'.
+     */
+    void layout_free(LayoutNode *node, void (*release)(void *));
+
+    /*
+     * Computes 'size' (and struct offsets) once all children are set.
+     * Returns false on allocation failure or size overflow.
+     */
+    bool layout_finalize(LayoutNode *node);
+
+    /* -----------------------------------------------------
+     * Walking Encoded Data
+     *
+     * All walkers read through the bounds-checked readers of borsh.c and
+     * report malformed input through the buffer's error flag.
+     * ----------------------------------------------------- */
+    bool layout_skip(const LayoutNode *node, Buffer *buf);
+
+    /*
+     * Reads the version prefix of a LAYOUT_VERSIONED value and returns the
+     * layout of the message that follows, storing its version (-1 for
+     * legacy) in 'version' if given. NULL for unknown versions or when no
+     * data is left.
+     */
+    const LayoutNode *layout_version(const LayoutNode *node, Buffer *buf, int *version);
+
+    /*
+     * Positions 'buf' at the start of the field addressed by 'path' inside
+     * the value starting at the current offset. Returns the field's node, or
+     * NULL if the data is malformed.
+     */
+    const LayoutNode *layout_locate(const LayoutNode *root,
+                                    const LayoutPath *path, Buffer *buf);
+
+    /*
+     * Resolves 'path' without data. Returns NULL if it does not address a
+     * field of 'root'.
+     */
+    const LayoutNode *layout_field(const LayoutNode *root, const LayoutPath *path);
+
+    /* -----------------------------------------------------
+     * Numeric Fields
+     * ----------------------------------------------------- */
+    bool layout_is_numeric(LayoutKind kind);
+    bool layout_read_number(const LayoutNode *node, Buffer *buf,
+                            LayoutNumber *out);
+
+    /*
+     * Three-way comparison (-1, 0, 1) across number types. Mixed integer
+     * signedness compares exactly; anything involving a float compares as
+     * double.
+     */
+    int layout_number_compare(const LayoutNumber *a, const LayoutNumber *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LAYOUT_H */
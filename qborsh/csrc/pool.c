@@ -0,0 +1,171 @@
+#include "pool.h"
+#include <pthread.h> // for pthread_create, pthread_mutex_t, etc.
+#include <stdbool.h> // for bool
+#include <stdlib.h>  // for calloc, free
+
+/*
+ * The chunks [lo, hi) still owned by one worker. The owner takes chunks
+ * from the front; thieves take the back half.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;
+    size_t lo;
+    size_t hi;
+} PoolDeque;
+
+typedef struct
+{
+    PoolDeque *deques;
+    size_t n_workers;
+    size_t n_items;
+    size_t grain;
+    PoolTask task;
+    void *ctx;
+} Pool;
+
+typedef struct
+{
+    Pool *pool;
+    size_t id;
+} PoolWorker;
+
+static bool pool_pop(PoolDeque *deque, size_t *chunk)
+{
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->lo < deque->hi)
+    {
+        *chunk = deque->lo++;
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/*
+ * Steals half of the first non-empty victim's chunks. One stolen chunk is
+ * returned to run right away; the rest refill the thief's own deque.
+ */
+static bool pool_steal(Pool *pool, size_t thief, size_t *chunk)
+{
+    for (size_t k = 1; k < pool->n_workers; k++)
+    {
+        PoolDeque *victim = &pool->deques[(thief + k) % pool->n_workers];
+        size_t begin = 0, end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        size_t remaining = victim->hi - victim->lo;
+        if (remaining > 0)
+        {
+            end = victim->hi;
+            begin = end - (remaining + 1) / 2;
+            victim->hi = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin == end)
+            continue;
+
+        PoolDeque *own = &pool->deques[thief];
+        pthread_mutex_lock(&own->lock);
+        own->lo = begin + 1;
+        own->hi = end;
+        pthread_mutex_unlock(&own->lock);
+
+        *chunk = begin;
+        return true;
+    }
+    return false;
+}
+
+static void *pool_worker_main(void *arg)
+{
+    PoolWorker *worker = (PoolWorker *)arg;
+    Pool *pool = worker->pool;
+    size_t chunk;
+
+    while (pool_pop(&pool->deques[worker->id], &chunk) ||
+           pool_steal(pool, worker->id, &chunk))
+    {
+        size_t begin = chunk * pool->grain;
+        size_t end = begin + pool->grain;
+        if (end > pool->n_items)
+            end = pool->n_items;
+        pool->task(pool->ctx, worker->id, begin, end);
+    }
+    return NULL;
+}
+
+size_t pool_run(size_t n_items, size_t grain, size_t n_workers,
+                PoolTask task, void *ctx)
+{
+    if (n_items == 0)
+        return 1;
+    if (grain == 0)
+        grain = 1;
+
+    size_t n_chunks = (n_items + grain - 1) / grain;
+    if (n_workers > n_chunks)
+        n_workers = n_chunks;
+    if (n_workers <= 1)
+    {
+        task(ctx, 0, 0, n_items);
+        return 1;
+    }
+
+    PoolDeque *deques = (PoolDeque *)calloc(n_workers, sizeof(PoolDeque));
+    PoolWorker *workers = (PoolWorker *)calloc(n_workers, sizeof(PoolWorker));
+    pthread_t *threads = (pthread_t *)calloc(n_workers, sizeof(pthread_t));
+    bool *started = (bool *)calloc(n_workers, sizeof(bool));
+    if (!deques || !workers || !threads || !started)
+    {
+        // Out of memory: still finish the job, just on one thread
+        free(deques);
+        free(workers);
+        free(threads);
+        free(started);
+        task(ctx, 0, 0, n_items);
+        return 1;
+    }
+
+    Pool pool = {deques, n_workers, n_items, grain, task, ctx};
+    for (size_t i = 0; i < n_workers; i++)
+    {
+        pthread_mutex_init(&deques[i].lock, NULL);
+        deques[i].lo = n_chunks * i / n_workers;
+        deques[i].hi = n_chunks * (i + 1) / n_workers;
+        workers[i].pool = &pool;
+        workers[i].id = i;
+    }
+
+    /*
+     * Worker 0 is the calling thread. If a thread fails to start, its chunks
+     * are simply stolen by the workers that did.
+     */
+    size_t running = 1;
+    for (size_t i = 1; i < n_workers; i++)
+    {
+        if (pthread_create(&threads[i], NULL, pool_worker_main, &workers[i]) == 0)
+        {
+            started[i] = true;
+            running++;
+        }
+    }
+    pool_worker_main(&workers[0]);
+    for (size_t i = 1; i < n_workers; i++)
+    {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+    }
+
+    for (size_t i = 0; i < n_workers; i++)
+    {
+        pthread_mutex_destroy(&deques[i].lock);
+    }
+    free(deques);
+    free(workers);
+    free(threads);
+    free(started);
+    return running;
+}
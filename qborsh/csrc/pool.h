@@ -0,0 +1,32 @@
+#ifndef POOL_H
+#define POOL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h> // for size_t
+
+    /*
+     * A unit of work: process items [begin, end) on worker 'worker'
+     * (0 <= worker < n_workers). Tasks must not touch Python objects.
+     */
+    typedef void (*PoolTask)(void *ctx, size_t worker, size_t begin, size_t end);
+
+    /*
+     * Splits 'n_items' into chunks of 'grain' items and runs 'task' over all of
+     * them on 'n_workers' threads (the caller is worker 0). Each worker starts
+     * with a contiguous share of chunks and, once it runs dry, steals half of
+     * the remaining chunks of another worker, so uneven chunks balance out.
+     *
+     * Returns the number of workers that actually ran (>= 1).
+     */
+    size_t pool_run(size_t n_items, size_t grain, size_t n_workers,
+                    PoolTask task, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_H */
@@ -1,8 +1,24 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include <string.h>
+#include <errno.h>  // for errno, EINTR
 #include <limits.h> // for INT_MAX, etc.
+#include <unistd.h> // for pread
 #include "borsh.h"
+#include "layout.h"
+#include "records.h"
+#include "scan.h"
+#include "group.h"
+#include "sort.h"
+#include "index.h"
+#include "crc32c.h"
+#include "frames.h"
+#include "readahead.h"
+#include "ring.h"
+#include "base58.h"
+#include "base64.h"
+#include "dispatch.h"
+#include "hash.h"
 
 /*
  * A global flag controlling validation (range checks). If you wish to skip range checks
@@ -11,6 +27,12 @@
  */
 static int g_validation_enabled = 1;
 
+/*
+ * Whether PubKey values decode to lazy PublicKey objects rather than base58
+ * str, set via `py_borsh.set_lazy_pubkeys(True)`.
+ */
+static int g_lazy_pubkeys = 0;
+
 /*
  * A simple wrapper object to hold a 'Buffer *' from borsh.h
  * and expose it in Python for BORSH-like read/write operations.
@@ -18,6 +40,9 @@ static int g_validation_enabled = 1;
 typedef struct
 {
     PyObject_HEAD Buffer *buf;
+    Py_buffer view;  /* pinned memory while attached, see PyBuffer_attach */
+    bool attached;
+    Buffer owned;    /* the buffer's own storage while attached */
 } PyBufferObject;
 
 /*
@@ -36,12 +61,26 @@ static int CheckBufferError(Buffer *b)
     return 0;
 }
 
+/*
+ * Restores the buffer's own storage after PyBuffer_attach.
+ */
+static void
+DetachBuffer(PyBufferObject *self)
+{
+    if (!self->attached)
+        return;
+    *self->buf = self->owned;
+    PyBuffer_Release(&self->view);
+    self->attached = false;
+}
+
 /* -----------------------------------------------------
  * Deallocation / Initialization
  * ----------------------------------------------------- */
 static void
 PyBuffer_dealloc(PyBufferObject *self)
 {
+    DetachBuffer(self);
     if (self->buf)
     {
         free_buffer(self->buf);
@@ -107,6 +146,7 @@ GetBuffer(PyBufferObject *self)
 static PyObject *
 PyBuffer_free(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
 {
+    DetachBuffer(self);
     if (self->buf)
     {
         free_buffer(self->buf);
@@ -131,6 +171,7 @@ PyBuffer_reset_offset(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
 static PyObject *
 PyBuffer_reset(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
 {
+    DetachBuffer(self);
     if (self->buf)
     {
         self->buf->size = 0;
@@ -140,6 +181,226 @@ PyBuffer_reset(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
     Py_RETURN_NONE;
 }
 
+/*
+ * attach(data, writable=False) -> None
+ *
+ * Reads from the memory of 'data' (any bytes-like object, e.g. a slice of an
+ * mmap) in place of the buffer's own storage, without copying. The object
+ * stays pinned until detach(), reset() or free(). Writes fail meanwhile,
+ * unless 'writable': then the buffer starts empty and writes fill 'data'
+ * in place, failing once it is full.
+ */
+static PyObject *
+PyBuffer_attach(PyBufferObject *self, PyObject *args)
+{
+    Buffer *b = GetBuffer(self);
+    PyObject *arg;
+    int writable = 0;
+    if (!b || !PyArg_ParseTuple(args, "O|p", &arg, &writable))
+        return NULL;
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(arg, &view, writable ? PyBUF_WRITABLE : PyBUF_SIMPLE) < 0)
+        return NULL;
+    DetachBuffer(self);
+
+    self->owned = *b;
+    self->view = view;
+    self->attached = true;
+    init_buffer_view(b, (const uint8_t *)view.buf, (size_t)view.len);
+    if (writable)
+        b->size = 0;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PyBuffer_detach(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
+{
+    DetachBuffer(self);
+    Py_RETURN_NONE;
+}
+
+/*
+ * reserve(size) -> None
+ *
+ * Replaces the contents with 'size' bytes of scratch space (growing the
+ * buffer if needed) and rewinds it for reading, so callers can fill 'data'
+ * directly, e.g. with socket.recv_into.
+ */
+static PyObject *
+PyBuffer_reserve(PyBufferObject *self, PyObject *arg)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    Py_ssize_t size = PyLong_AsSsize_t(arg);
+    if (size == -1 && PyErr_Occurred())
+        return NULL;
+    if (size < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "size must be >= 0");
+        return NULL;
+    }
+    DetachBuffer(self);
+    b->size = 0;
+    b->offset = 0;
+    b->error = false;
+    if (!buffer_reserve(b, (size_t)size))
+    {
+        b->error = false;
+        return PyErr_NoMemory();
+    }
+    Py_RETURN_NONE;
+}
+
+/*
+ * read_from(fd, offset, length) -> int
+ *
+ * Replaces the contents with up to 'length' bytes of 'fd' read at 'offset'
+ * straight into the buffer's storage (pread, no intermediate object) and
+ * rewinds it for reading. Returns the number of bytes read, which is less
+ * than 'length' only at the end of the file.
+ */
+static PyObject *
+PyBuffer_read_from(PyBufferObject *self, PyObject *args)
+{
+    Buffer *b = GetBuffer(self);
+    int fd;
+    long long offset;
+    Py_ssize_t length;
+
+    if (!b || !PyArg_ParseTuple(args, "iLn", &fd, &offset, &length))
+        return NULL;
+    if (offset < 0 || length < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "offset and length must be >= 0");
+        return NULL;
+    }
+    DetachBuffer(self);
+    b->size = 0;
+    b->offset = 0;
+    b->error = false;
+
+    uint8_t *dest = buffer_reserve(b, (size_t)length);
+    if (!dest)
+    {
+        b->error = false;
+        return PyErr_NoMemory();
+    }
+
+    size_t got = 0;
+    int error = 0;
+    Py_BEGIN_ALLOW_THREADS
+    while (got < (size_t)length)
+    {
+        ssize_t n = pread(fd, dest + got, (size_t)length - got, (off_t)(offset + (long long)got));
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            error = errno;
+            break;
+        }
+        if (n == 0)
+            break;
+        got += (size_t)n;
+    }
+    Py_END_ALLOW_THREADS
+
+    b->size = got;
+    if (error)
+    {
+        b->size = 0;
+        errno = error;
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    return PyLong_FromSize_t(got);
+}
+
+/*
+ * Points 'text' at the chars of an ASCII str (its own storage, no copy) or
+ * of a bytes-like object, pinned in 'view' until PyBuffer_Release.
+ */
+static int
+text_from_object(PyObject *obj, Py_buffer *view, const char **text, Py_ssize_t *len)
+{
+    view->obj = NULL;
+    if (PyUnicode_Check(obj))
+    {
+        *text = PyUnicode_AsUTF8AndSize(obj, len);
+        return *text ? 0 : -1;
+    }
+    if (PyObject_GetBuffer(obj, view, PyBUF_SIMPLE) < 0)
+        return -1;
+    *text = (const char *)view->buf;
+    *len = view->len;
+    return 0;
+}
+
+/*
+ * read_base64(text) -> int / read_base58(text) -> int
+ *
+ * Replaces the contents with the bytes 'text' decodes to, decoded straight
+ * into the buffer's storage, and rewinds it for reading. Returns the number
+ * of bytes. Raises ValueError on malformed text.
+ */
+static PyObject *
+PyBuffer_read_text(PyBufferObject *self, PyObject *arg, bool base58)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    Py_buffer view;
+    const char *text;
+    Py_ssize_t len;
+    if (text_from_object(arg, &view, &text, &len) < 0)
+        return NULL;
+
+    DetachBuffer(self);
+    b->size = 0;
+    b->offset = 0;
+    b->error = false;
+    size_t capacity = base58 ? (size_t)len : base64_decoded_max((size_t)len);
+    uint8_t *dest = buffer_reserve(b, capacity);
+    if (!dest)
+    {
+        PyBuffer_Release(&view);
+        b->error = false;
+        return PyErr_NoMemory();
+    }
+
+    size_t length = 0;
+    int status = 0;
+    if (base58)
+        status = base58_decode(text, (size_t)len, dest, &length);
+    else if (!base64_decode(text, (size_t)len, dest, &length))
+        status = BASE58_INVALID_CHAR;
+    PyBuffer_Release(&view);
+
+    b->size = length;
+    if (status == BASE58_NO_MEMORY)
+        return PyErr_NoMemory();
+    if (status != 0)
+    {
+        b->size = 0;
+        PyErr_SetString(PyExc_ValueError, base58 ? "Invalid base58 text." : "Invalid base64 text.");
+        return NULL;
+    }
+    return PyLong_FromSize_t(length);
+}
+
+static PyObject *
+PyBuffer_read_base64(PyBufferObject *self, PyObject *arg)
+{
+    return PyBuffer_read_text(self, arg, false);
+}
+
+static PyObject *
+PyBuffer_read_base58(PyBufferObject *self, PyObject *arg)
+{
+    return PyBuffer_read_text(self, arg, true);
+}
+
 /* -----------------------------------------------------
  * Property Accessors
  * ----------------------------------------------------- */
@@ -176,6 +437,20 @@ PyBuffer_get_offset(PyBufferObject *self, void *closure)
     return PyLong_FromSize_t(b->offset);
 }
 
+/*
+ * True once a write did not fit (or could not allocate) or a read ran past
+ * the data, until the buffer is reset. Unlike the other getters, it does
+ * not raise in that state.
+ */
+static PyObject *
+PyBuffer_get_error(PyBufferObject *self, void *closure)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    return PyBool_FromLong(buffer_has_error(b));
+}
+
 /*
  * Returns a writable memoryview over the entire underlying data array.
  * This includes unused capacity, not just 'size', so use with caution.
@@ -191,7 +466,7 @@ PyBuffer_get_data(PyBufferObject *self, void *closure)
     return PyMemoryView_FromMemory(
         (char *)b->data,
         (Py_ssize_t)b->capacity,
-        PyBUF_WRITE);
+        b->borrowed ? PyBUF_READ : PyBUF_WRITE);
 }
 
 /* ------------------------------------------------------------------
@@ -984,10 +1259,10 @@ PyBuffer_read_bool(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
 }
 
 /* -----------------------------------------------------
- * Write/Read Fixed Array
+ * Write/Read ShortU16 (Solana compact-u16)
  * ----------------------------------------------------- */
 static PyObject *
-PyBuffer_write_fixed_array(PyBufferObject *self, PyObject *args)
+PyBuffer_write_short_u16(PyBufferObject *self, PyObject *arg)
 {
     Buffer *b = GetBuffer(self);
     if (!b)
@@ -995,27 +1270,26 @@ PyBuffer_write_fixed_array(PyBufferObject *self, PyObject *args)
     if (CheckBufferError(b) < 0)
         return NULL;
 
-    const char *raw_data = NULL;
-    Py_ssize_t data_len = 0;
-
-    /* "y#": parse a bytes-like object into a pointer + length */
-    if (!PyArg_ParseTuple(args, "y#", &raw_data, &data_len))
+    long val = PyLong_AsLong(arg);
+    if (PyErr_Occurred())
     {
         return NULL;
     }
-    if (data_len < 0)
+    // The encoding cannot hold more, so this is checked even without validation
+    if (val < 0 || val > 0xFFFF)
     {
-        PyErr_SetString(PyExc_ValueError, "Negative data length");
+        PyErr_SetString(PyExc_ValueError, "short_u16 out of range (0..65535)");
         return NULL;
     }
-    write_fixed_array(b, raw_data, 1, (size_t)data_len);
+
+    write_short_u16(b, (uint16_t)val);
     if (CheckBufferError(b) < 0)
         return NULL;
     Py_RETURN_NONE;
 }
 
 static PyObject *
-PyBuffer_read_fixed_array(PyBufferObject *self, PyObject *args)
+PyBuffer_read_short_u16(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
 {
     Buffer *b = GetBuffer(self);
     if (!b)
@@ -1023,37 +1297,68 @@ PyBuffer_read_fixed_array(PyBufferObject *self, PyObject *args)
     if (CheckBufferError(b) < 0)
         return NULL;
 
-    Py_ssize_t length = 0;
-    if (!PyArg_ParseTuple(args, "n", &length))
-    {
+    uint16_t val = read_short_u16(b);
+    if (CheckBufferError(b) < 0)
         return NULL;
+    return PyLong_FromUnsignedLong(val);
+}
+
+/* -----------------------------------------------------
+ * Write/Read VarU64/VarI64 (LEB128, zigzag for signed)
+ * ----------------------------------------------------- */
+
+/*
+ * Converts 'value' to the unsigned LEB128 payload: the value itself, or its
+ * zigzag mapping when signed. Out of range values are always rejected, the
+ * encoding having no fixed width to wrap in.
+ */
+static int
+var_int_from_object(PyObject *value, bool is_signed, uint64_t *out)
+{
+    if (!PyLong_Check(value))
+    {
+        PyErr_Format(PyExc_TypeError, "Expected int for %s, not %.200s", is_signed ? "var_i64" : "var_u64",
+                     Py_TYPE(value)->tp_name);
+        return -1;
     }
-    if (length < 0)
+    int overflow = 0;
+    long long s = PyLong_AsLongLongAndOverflow(value, &overflow);
+    if (s == -1 && PyErr_Occurred())
+        return -1;
+
+    if (is_signed)
     {
-        PyErr_SetString(PyExc_ValueError, "Negative length");
-        return NULL;
+        if (overflow)
+        {
+            PyErr_SetString(PyExc_ValueError, "var_i64 out of range");
+            return -1;
+        }
+        *out = ((uint64_t)s << 1) ^ (uint64_t)(s >> 63);
+        return 0;
     }
-    PyObject *out_bytes = PyBytes_FromStringAndSize(NULL, length);
-    if (!out_bytes)
+    if (overflow < 0 || (overflow == 0 && s < 0))
     {
-        return NULL;
+        PyErr_SetString(PyExc_ValueError, "var_u64 cannot be negative");
+        return -1;
     }
-    char *dest = PyBytes_AsString(out_bytes);
-
-    read_fixed_array(b, dest, 1, (size_t)length);
-    if (CheckBufferError(b) < 0)
+    if (overflow == 0)
     {
-        Py_DECREF(out_bytes);
-        return NULL;
+        *out = (uint64_t)s;
+        return 0;
     }
-    return out_bytes;
+    unsigned long long u = PyLong_AsUnsignedLongLong(value);
+    if (u == (unsigned long long)-1 && PyErr_Occurred())
+    {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_ValueError, "var_u64 out of range");
+        return -1;
+    }
+    *out = u;
+    return 0;
 }
 
-/* -----------------------------------------------------
- * Write/Read Vec
- * ----------------------------------------------------- */
 static PyObject *
-PyBuffer_write_vec(PyBufferObject *self, PyObject *args)
+PyBuffer_write_var(PyBufferObject *self, PyObject *arg, bool is_signed)
 {
     Buffer *b = GetBuffer(self);
     if (!b)
@@ -1061,27 +1366,29 @@ PyBuffer_write_vec(PyBufferObject *self, PyObject *args)
     if (CheckBufferError(b) < 0)
         return NULL;
 
-    const char *raw_data = NULL;
-    Py_ssize_t data_len = 0;
-
-    /* "y#": parse a bytes-like object. We'll store length + bytes. */
-    if (!PyArg_ParseTuple(args, "y#", &raw_data, &data_len))
-    {
-        return NULL;
-    }
-    if (data_len < 0)
-    {
-        PyErr_SetString(PyExc_ValueError, "Negative data length");
+    uint64_t raw;
+    if (var_int_from_object(arg, is_signed, &raw) < 0)
         return NULL;
-    }
-    write_vec(b, raw_data, 1, (size_t)data_len);
+    write_var_u64(b, raw);
     if (CheckBufferError(b) < 0)
         return NULL;
     Py_RETURN_NONE;
 }
 
 static PyObject *
-PyBuffer_read_vec(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
+PyBuffer_write_var_u64(PyBufferObject *self, PyObject *arg)
+{
+    return PyBuffer_write_var(self, arg, false);
+}
+
+static PyObject *
+PyBuffer_write_var_i64(PyBufferObject *self, PyObject *arg)
+{
+    return PyBuffer_write_var(self, arg, true);
+}
+
+static PyObject *
+PyBuffer_read_var_u64(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
 {
     Buffer *b = GetBuffer(self);
     if (!b)
@@ -1089,79 +1396,240 @@ PyBuffer_read_vec(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
     if (CheckBufferError(b) < 0)
         return NULL;
 
-    uint32_t length_prefix = read_u32(b);
+    uint64_t val = read_var_u64(b);
     if (CheckBufferError(b) < 0)
         return NULL;
+    return PyLong_FromUnsignedLongLong(val);
+}
 
-    PyObject *out_bytes = PyBytes_FromStringAndSize(NULL, length_prefix);
-    if (!out_bytes)
-    {
+static PyObject *
+PyBuffer_read_var_i64(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
         return NULL;
-    }
-    char *dest = PyBytes_AsString(out_bytes);
-    read_fixed_array(b, dest, 1, length_prefix);
     if (CheckBufferError(b) < 0)
-    {
-        Py_DECREF(out_bytes);
         return NULL;
-    }
-    return out_bytes;
+
+    int64_t val = read_var_i64(b);
+    if (CheckBufferError(b) < 0)
+        return NULL;
+    return PyLong_FromLongLong(val);
 }
 
 /* -----------------------------------------------------
- * Write/Read Option
+ * Write/Read PubKey (32 bytes, base58 text in Python)
  * ----------------------------------------------------- */
+
 /*
- * We store:
- *   - 1 byte bool is_some
- *   - if is_some, then a u32 length + raw bytes
+ * Base58 str of a 32-byte key, encoded natively.
  */
 static PyObject *
-PyBuffer_write_option(PyBufferObject *self, PyObject *arg)
+pubkey_to_str(const uint8_t *key)
 {
-    Buffer *b = GetBuffer(self);
-    if (!b)
-        return NULL;
-    if (CheckBufferError(b) < 0)
+    char text[BASE58_KEY_MAX];
+    size_t length = base58_encode_key(key, text);
+    PyObject *result = PyUnicode_New((Py_ssize_t)length, 127);
+    if (result)
+        memcpy(PyUnicode_1BYTE_DATA(result), text, length);
+    return result;
+}
+
+/*
+ * An immutable 32-byte key that compares and hashes by its bytes and only
+ * computes (then caches) its base58 text when converted to str.
+ */
+typedef struct
+{
+    PyObject_HEAD PyObject *text; /* cached base58, NULL until str() */
+    uint8_t key[32];
+} PyPublicKeyObject;
+
+static PyTypeObject PyPublicKeyType;
+
+static PyObject *
+PublicKey_FromBytes(const uint8_t *key)
+{
+    PyPublicKeyObject *self = PyObject_New(PyPublicKeyObject, &PyPublicKeyType);
+    if (!self)
         return NULL;
+    self->text = NULL;
+    memcpy(self->key, key, 32);
+    return (PyObject *)self;
+}
 
-    if (arg == Py_None)
+/*
+ * A decoded key: a PublicKey when lazy pubkeys are on, else base58 str.
+ */
+static PyObject *
+pubkey_value(const uint8_t *key)
+{
+    return g_lazy_pubkeys ? PublicKey_FromBytes(key) : pubkey_to_str(key);
+}
+
+/*
+ * Fills 'key' from 32 raw bytes or a base58 str.
+ */
+static int
+pubkey_from_object(PyObject *value, uint8_t *key)
+{
+    if (Py_IS_TYPE(value, &PyPublicKeyType))
     {
-        write_bool(b, false);
-        if (CheckBufferError(b) < 0)
-            return NULL;
+        memcpy(key, ((PyPublicKeyObject *)value)->key, 32);
+        return 0;
     }
-    else if (PyBytes_Check(arg))
+    if (PyBytes_Check(value))
     {
-        write_bool(b, true);
-        if (CheckBufferError(b) < 0)
-            return NULL;
-
-        Py_ssize_t data_len = PyBytes_Size(arg);
-        if (data_len < 0)
+        if (PyBytes_GET_SIZE(value) != 32)
         {
-            PyErr_SetString(PyExc_ValueError, "Negative data length");
-            return NULL;
+            PyErr_SetString(PyExc_ValueError, "PubKey must be exactly 32 bytes.");
+            return -1;
         }
-        write_u32(b, (uint32_t)data_len);
-        if (CheckBufferError(b) < 0)
-            return NULL;
-
-        const char *raw_data = PyBytes_AsString(arg);
-        write_fixed_array(b, raw_data, 1, (size_t)data_len);
-        if (CheckBufferError(b) < 0)
-            return NULL;
+        memcpy(key, PyBytes_AS_STRING(value), 32);
+        return 0;
     }
-    else
+    if (!PyUnicode_Check(value))
     {
-        PyErr_SetString(PyExc_TypeError, "Expected None or bytes");
+        PyErr_Format(PyExc_TypeError, "PubKey expects bytes, a base58 str or a PublicKey, not %.200s",
+                     Py_TYPE(value)->tp_name);
+        return -1;
+    }
+
+    Py_ssize_t length;
+    const char *text = PyUnicode_AsUTF8AndSize(value, &length);
+    if (!text)
+        return -1;
+    switch (base58_decode_key(text, (size_t)length, key))
+    {
+    case BASE58_OK:
+        return 0;
+    case BASE58_INVALID_CHAR:
+        PyErr_SetString(PyExc_ValueError, "Invalid base58 character in PubKey.");
+        return -1;
+    default:
+        PyErr_SetString(PyExc_ValueError, "PubKey must be exactly 32 bytes.");
+        return -1;
+    }
+}
+
+static PyObject *
+PyPublicKey_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyObject *value;
+    static char *kwlist[] = {"value", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &value))
+        return NULL;
+    if (Py_IS_TYPE(value, &PyPublicKeyType))
+        return Py_NewRef(value);
+
+    uint8_t key[32];
+    if (pubkey_from_object(value, key) < 0)
         return NULL;
+    return PublicKey_FromBytes(key);
+}
+
+static void
+PyPublicKey_dealloc(PyPublicKeyObject *self)
+{
+    Py_XDECREF(self->text);
+    PyObject_Free(self);
+}
+
+static PyObject *
+PyPublicKey_str(PyPublicKeyObject *self)
+{
+    if (!self->text)
+    {
+        self->text = pubkey_to_str(self->key);
+        if (!self->text)
+            return NULL;
     }
+    return Py_NewRef(self->text);
+}
+
+static PyObject *
+PyPublicKey_repr(PyPublicKeyObject *self)
+{
+    PyObject *text = PyPublicKey_str(self);
+    if (!text)
+        return NULL;
+    PyObject *result = PyUnicode_FromFormat("PublicKey('%U')", text);
+    Py_DECREF(text);
+    return result;
+}
+
+static Py_hash_t
+PyPublicKey_hash(PyPublicKeyObject *self)
+{
+    // Keys are uniformly distributed, so their first bytes hash them well
+    Py_hash_t hash;
+    memcpy(&hash, self->key, sizeof(hash));
+    return hash == -1 ? -2 : hash;
+}
+
+static PyObject *
+PyPublicKey_richcompare(PyObject *a, PyObject *b, int op)
+{
+    // Only other keys compare: equality with str or bytes would need
+    // hashes matching theirs, and that means encoding every key
+    if (!Py_IS_TYPE(a, &PyPublicKeyType) || !Py_IS_TYPE(b, &PyPublicKeyType))
+        Py_RETURN_NOTIMPLEMENTED;
+    int order = memcmp(((PyPublicKeyObject *)a)->key, ((PyPublicKeyObject *)b)->key, 32);
+    Py_RETURN_RICHCOMPARE(order, 0, op);
+}
+
+static PyObject *
+PyPublicKey_bytes(PyPublicKeyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    return PyBytes_FromStringAndSize((const char *)self->key, 32);
+}
+
+static PyObject *
+PyPublicKey_reduce(PyPublicKeyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    return Py_BuildValue("(O(y#))", Py_TYPE(self), (const char *)self->key, (Py_ssize_t)32);
+}
+
+static PyMethodDef PyPublicKey_methods[] = {
+    {"__bytes__", (PyCFunction)PyPublicKey_bytes, METH_NOARGS, "The key's 32 raw bytes"},
+    {"__reduce__", (PyCFunction)PyPublicKey_reduce, METH_NOARGS, ""},
+    {NULL, NULL, 0, NULL}};
+
+static PyTypeObject PyPublicKeyType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "qborsh.csrc.py_borsh.PublicKey", // full path so keys pickle
+    .tp_basicsize = sizeof(PyPublicKeyObject),
+    .tp_dealloc = (destructor)PyPublicKey_dealloc,
+    .tp_repr = (reprfunc)PyPublicKey_repr,
+    .tp_hash = (hashfunc)PyPublicKey_hash,
+    .tp_str = (reprfunc)PyPublicKey_str,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "32-byte public key, base58 encoded on first str()",
+    .tp_richcompare = PyPublicKey_richcompare,
+    .tp_methods = PyPublicKey_methods,
+    .tp_new = PyPublicKey_new,
+};
+
+static PyObject *
+PyBuffer_write_pubkey(PyBufferObject *self, PyObject *arg)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+
+    uint8_t key[32];
+    if (pubkey_from_object(arg, key) < 0)
+        return NULL;
+    write_fixed_array(b, key, 1, 32);
+    if (CheckBufferError(b) < 0)
+        return NULL;
     Py_RETURN_NONE;
 }
 
 static PyObject *
-PyBuffer_read_option(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
+PyBuffer_read_pubkey(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
 {
     Buffer *b = GetBuffer(self);
     if (!b)
@@ -1169,22 +1637,128 @@ PyBuffer_read_option(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
     if (CheckBufferError(b) < 0)
         return NULL;
 
-    bool is_some = read_bool(b);
+    const uint8_t *key = read_view(b, 32);
     if (CheckBufferError(b) < 0)
         return NULL;
-    if (!is_some)
+    return pubkey_value(key);
+}
+
+/* -----------------------------------------------------
+ * Write/Read Fixed Array
+ * ----------------------------------------------------- */
+static PyObject *
+PyBuffer_write_fixed_array(PyBufferObject *self, PyObject *args)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+
+    const char *raw_data = NULL;
+    Py_ssize_t data_len = 0;
+
+    /* "y#": parse a bytes-like object into a pointer + length */
+    if (!PyArg_ParseTuple(args, "y#", &raw_data, &data_len))
     {
-        Py_RETURN_NONE;
+        return NULL;
+    }
+    if (data_len < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Negative data length");
+        return NULL;
+    }
+    write_fixed_array(b, raw_data, 1, (size_t)data_len);
+    if (CheckBufferError(b) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PyBuffer_read_fixed_array(PyBufferObject *self, PyObject *args)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+
+    Py_ssize_t length = 0;
+    if (!PyArg_ParseTuple(args, "n", &length))
+    {
+        return NULL;
+    }
+    if (length < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Negative length");
+        return NULL;
+    }
+    PyObject *out_bytes = PyBytes_FromStringAndSize(NULL, length);
+    if (!out_bytes)
+    {
+        return NULL;
+    }
+    char *dest = PyBytes_AsString(out_bytes);
+
+    read_fixed_array(b, dest, 1, (size_t)length);
+    if (CheckBufferError(b) < 0)
+    {
+        Py_DECREF(out_bytes);
+        return NULL;
+    }
+    return out_bytes;
+}
+
+/* -----------------------------------------------------
+ * Write/Read Vec
+ * ----------------------------------------------------- */
+static PyObject *
+PyBuffer_write_vec(PyBufferObject *self, PyObject *args)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+
+    const char *raw_data = NULL;
+    Py_ssize_t data_len = 0;
+
+    /* "y#": parse a bytes-like object. We'll store length + bytes. */
+    if (!PyArg_ParseTuple(args, "y#", &raw_data, &data_len))
+    {
+        return NULL;
+    }
+    if (data_len < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Negative data length");
+        return NULL;
     }
+    write_vec(b, raw_data, 1, (size_t)data_len);
+    if (CheckBufferError(b) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PyBuffer_read_vec(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+
     uint32_t length_prefix = read_u32(b);
     if (CheckBufferError(b) < 0)
         return NULL;
 
     PyObject *out_bytes = PyBytes_FromStringAndSize(NULL, length_prefix);
     if (!out_bytes)
+    {
         return NULL;
+    }
     char *dest = PyBytes_AsString(out_bytes);
-
     read_fixed_array(b, dest, 1, length_prefix);
     if (CheckBufferError(b) < 0)
     {
@@ -1194,6 +1768,76 @@ PyBuffer_read_option(PyBufferObject *self, PyObject *Py_UNUSED(ignored))
     return out_bytes;
 }
 
+/* -----------------------------------------------------
+ * Write/Read Option
+ * ----------------------------------------------------- */
+/*
+ * Borsh layout: a 1 byte is_some tag, then the value's own encoding inline
+ * (no length prefix). Values are passed already encoded, so readers give
+ * the encoded size of the value.
+ */
+static PyObject *
+PyBuffer_write_option(PyBufferObject *self, PyObject *arg)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+
+    if (arg == Py_None)
+    {
+        write_bool(b, false);
+    }
+    else if (PyBytes_Check(arg))
+    {
+        write_bool(b, true);
+        write_fixed_array(b, PyBytes_AS_STRING(arg), 1, (size_t)PyBytes_GET_SIZE(arg));
+    }
+    else
+    {
+        PyErr_SetString(PyExc_TypeError, "Expected None or bytes");
+        return NULL;
+    }
+    if (CheckBufferError(b) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PyBuffer_read_option(PyBufferObject *self, PyObject *args)
+{
+    Buffer *b = GetBuffer(self);
+    if (!b)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+
+    Py_ssize_t length = 0;
+    if (!PyArg_ParseTuple(args, "n", &length))
+    {
+        return NULL;
+    }
+    if (length < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Negative length");
+        return NULL;
+    }
+
+    bool is_some = read_bool(b);
+    if (CheckBufferError(b) < 0)
+        return NULL;
+    if (!is_some)
+    {
+        Py_RETURN_NONE;
+    }
+
+    const uint8_t *data = read_view(b, (size_t)length);
+    if (CheckBufferError(b) < 0)
+        return NULL;
+    return PyBytes_FromStringAndSize((const char *)data, length);
+}
+
 /* -----------------------------------------------------
  * Write/Read Enum
  * ----------------------------------------------------- */
@@ -1637,6 +2281,20 @@ PyBorsh_set_validation(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+/*
+ * set_lazy_pubkeys( bool ) -> None
+ */
+static PyObject *
+PyBorsh_set_lazy_pubkeys(PyObject *self, PyObject *args)
+{
+    int val = 0;
+    if (!PyArg_ParseTuple(args, "p", &val))
+        return NULL;
+
+    g_lazy_pubkeys = (val != 0);
+    Py_RETURN_NONE;
+}
+
 /* -----------------------------------------------------
  * Method Table
  * ----------------------------------------------------- */
@@ -1644,6 +2302,12 @@ static PyMethodDef PyBuffer_methods[] = {
     {"free", (PyCFunction)PyBuffer_free, METH_NOARGS, ""},
     {"reset", (PyCFunction)PyBuffer_reset, METH_NOARGS, ""},
     {"reset_offset", (PyCFunction)PyBuffer_reset_offset, METH_NOARGS, ""},
+    {"attach", (PyCFunction)PyBuffer_attach, METH_VARARGS, ""},
+    {"detach", (PyCFunction)PyBuffer_detach, METH_NOARGS, ""},
+    {"read_from", (PyCFunction)PyBuffer_read_from, METH_VARARGS, ""},
+    {"reserve", (PyCFunction)PyBuffer_reserve, METH_O, ""},
+    {"read_base64", (PyCFunction)PyBuffer_read_base64, METH_O, ""},
+    {"read_base58", (PyCFunction)PyBuffer_read_base58, METH_O, ""},
 
     {"write_u8", (PyCFunction)PyBuffer_write_u8, METH_VARARGS, ""},
     {"read_u8", (PyCFunction)PyBuffer_read_u8, METH_NOARGS, ""},
@@ -1684,6 +2348,18 @@ static PyMethodDef PyBuffer_methods[] = {
     {"write_bool", (PyCFunction)PyBuffer_write_bool, METH_VARARGS, ""},
     {"read_bool", (PyCFunction)PyBuffer_read_bool, METH_NOARGS, ""},
 
+    {"write_short_u16", (PyCFunction)PyBuffer_write_short_u16, METH_O, ""},
+    {"read_short_u16", (PyCFunction)PyBuffer_read_short_u16, METH_NOARGS, ""},
+
+    {"write_var_u64", (PyCFunction)PyBuffer_write_var_u64, METH_O, ""},
+    {"read_var_u64", (PyCFunction)PyBuffer_read_var_u64, METH_NOARGS, ""},
+
+    {"write_var_i64", (PyCFunction)PyBuffer_write_var_i64, METH_O, ""},
+    {"read_var_i64", (PyCFunction)PyBuffer_read_var_i64, METH_NOARGS, ""},
+
+    {"write_pubkey", (PyCFunction)PyBuffer_write_pubkey, METH_O, ""},
+    {"read_pubkey", (PyCFunction)PyBuffer_read_pubkey, METH_NOARGS, ""},
+
     {"write_fixed_array", (PyCFunction)PyBuffer_write_fixed_array, METH_VARARGS, ""},
     {"read_fixed_array", (PyCFunction)PyBuffer_read_fixed_array, METH_VARARGS, ""},
 
@@ -1691,7 +2367,7 @@ static PyMethodDef PyBuffer_methods[] = {
     {"read_vec", (PyCFunction)PyBuffer_read_vec, METH_NOARGS, ""},
 
     {"write_option", (PyCFunction)PyBuffer_write_option, METH_O, ""},
-    {"read_option", (PyCFunction)PyBuffer_read_option, METH_NOARGS, ""},
+    {"read_option", (PyCFunction)PyBuffer_read_option, METH_VARARGS, ""},
 
     {"write_enum", (PyCFunction)PyBuffer_write_enum, METH_VARARGS, ""},
     {"read_enum_variant", (PyCFunction)PyBuffer_read_enum_variant, METH_NOARGS, ""},
@@ -1711,6 +2387,7 @@ static PyGetSetDef PyBuffer_getset[] = {
     {"size", (getter)PyBuffer_get_size, NULL, NULL, NULL},
     {"capacity", (getter)PyBuffer_get_capacity, NULL, NULL, NULL},
     {"offset", (getter)PyBuffer_get_offset, NULL, NULL, NULL},
+    {"error", (getter)PyBuffer_get_error, NULL, NULL, NULL},
     {"data", (getter)PyBuffer_get_data, NULL, NULL, NULL},
     {NULL, NULL, NULL, NULL, NULL}};
 
@@ -1731,11 +2408,3711 @@ static PyTypeObject PyBufferType = {
 };
 
 /* -----------------------------------------------------
- * Module-level method table
+ * Layout Type
  * ----------------------------------------------------- */
 
 /*
- * set_validation( bool ) -> None
+ * A compiled description of how a qborsh type is laid out on the wire.
+ * Built once from the tuple spec returned by BorshType.layout() and shared
+ * by the native engines, which walk encoded data with it without creating
+ * Python objects.
+ */
+typedef struct
+{
+    PyObject_HEAD LayoutNode *root;
+} PyLayoutObject;
+
+static PyTypeObject PyLayoutType;
+
+/*
+ * Guards against runaway recursion on self-referencing specs.
+ */
+#define LAYOUT_MAX_NESTING 64
+
+static const struct
+{
+    const char *name;
+    LayoutKind kind;
+} layout_kind_names[] = {
+    {"u8", LAYOUT_U8},
+    {"u16", LAYOUT_U16},
+    {"u32", LAYOUT_U32},
+    {"u64", LAYOUT_U64},
+    {"u128", LAYOUT_U128},
+    {"i8", LAYOUT_I8},
+    {"i16", LAYOUT_I16},
+    {"i32", LAYOUT_I32},
+    {"i64", LAYOUT_I64},
+    {"i128", LAYOUT_I128},
+    {"f32", LAYOUT_F32},
+    {"f64", LAYOUT_F64},
+    {"bool", LAYOUT_BOOL},
+    {"pubkey", LAYOUT_PUBKEY},
+    {"padding", LAYOUT_PADDING},
+    {"string", LAYOUT_STRING},
+    {"bytes", LAYOUT_BYTES},
+    {"vec", LAYOUT_VEC},
+    {"array", LAYOUT_ARRAY},
+    {"option", LAYOUT_OPTION},
+    {"coption", LAYOUT_COPTION},
+    {"map", LAYOUT_MAP},
+    {"set", LAYOUT_SET},
+    {"struct", LAYOUT_STRUCT},
+    {"enum", LAYOUT_ENUM},
+    {"tuple", LAYOUT_TUPLE},
+    {"short_u16", LAYOUT_SHORT_U16},
+    {"shortvec", LAYOUT_SHORT_VEC},
+    {"var_u64", LAYOUT_VAR_U64},
+    {"var_i64", LAYOUT_VAR_I64},
+    {"fixed_bytes", LAYOUT_FIXED_BYTES},
+    {"short_bytes", LAYOUT_SHORT_BYTES},
+    {"view", LAYOUT_VIEW},
+    {"versioned", LAYOUT_VERSIONED},
+    {NULL, LAYOUT_U8}};
+
+static void release_layout_object(void *obj)
+{
+    Py_DECREF((PyObject *)obj);
+}
+
+/*
+ * Parses a non-negative length argument of a layout spec.
+ */
+static int layout_spec_length(PyObject *obj, size_t *out)
+{
+    Py_ssize_t length = PyLong_AsSsize_t(obj);
+    if (length < 0)
+    {
+        if (!PyErr_Occurred())
+            PyErr_SetString(PyExc_ValueError, "Layout length must not be negative");
+        return -1;
+    }
+    *out = (size_t)length;
+    return 0;
+}
+
+/*
+ * Compiles a spec such as ("vec", ("u8",)) or
+ * ("struct", (("a", ("u64",)), ("b", ("string",)))) into a LayoutNode tree.
+ *
+ * A struct spec may carry a third item, a callable that natively decoded
+ * structs are passed through (e.g. dotdict). Enum specs list their variants
+ * like struct fields, with None as the spec of a unit variant:
+ * ("enum", (("Empty", None), ("Value", ("u64",)))). Tuples list bare specs:
+ * ("tuple", (("u64",), ("pubkey",))), and versioned messages their legacy
+ * spec, then the spec of every version: ("versioned", legacy, (v0,)).
+ */
+static LayoutNode *
+compile_layout(PyObject *spec, int depth)
+{
+    if (depth > LAYOUT_MAX_NESTING)
+    {
+        PyErr_SetString(PyExc_ValueError, "Layout spec nested too deeply");
+        return NULL;
+    }
+    if (!PyTuple_Check(spec) || PyTuple_GET_SIZE(spec) < 1 ||
+        !PyUnicode_Check(PyTuple_GET_ITEM(spec, 0)))
+    {
+        PyErr_Format(PyExc_TypeError, "Layout spec must be a tuple starting with a kind name, not %R", spec);
+        return NULL;
+    }
+
+    const char *name = PyUnicode_AsUTF8(PyTuple_GET_ITEM(spec, 0));
+    if (!name)
+        return NULL;
+    if (strcmp(name, "interned") == 0)
+    {
+        // A marker rather than a node: the string or pubkey it wraps is
+        // compiled as usual and flagged
+        if (PyTuple_GET_SIZE(spec) != 2)
+        {
+            PyErr_Format(PyExc_ValueError, "Malformed layout spec %R", spec);
+            return NULL;
+        }
+        LayoutNode *child = compile_layout(PyTuple_GET_ITEM(spec, 1), depth + 1);
+        if (child && child->kind != LAYOUT_STRING && child->kind != LAYOUT_PUBKEY)
+        {
+            layout_free(child, release_layout_object);
+            PyErr_SetString(PyExc_ValueError, "Only string and pubkey layouts can be interned");
+            return NULL;
+        }
+        if (child)
+            child->interned = true;
+        return child;
+    }
+    int found = -1;
+    for (int i = 0; layout_kind_names[i].name; i++)
+    {
+        if (strcmp(layout_kind_names[i].name, name) == 0)
+        {
+            found = i;
+            break;
+        }
+    }
+    if (found < 0)
+    {
+        PyErr_Format(PyExc_ValueError, "Unknown layout kind '%s'", name);
+        return NULL;
+    }
+
+    LayoutKind kind = layout_kind_names[found].kind;
+    Py_ssize_t n_args = PyTuple_GET_SIZE(spec) - 1;
+    LayoutNode *node = NULL;
+
+    switch (kind)
+    {
+    case LAYOUT_PADDING:
+    case LAYOUT_FIXED_BYTES:
+    {
+        size_t length;
+        if (n_args != 1)
+            goto malformed;
+        if (layout_spec_length(PyTuple_GET_ITEM(spec, 1), &length) < 0)
+            return NULL;
+        node = layout_new(kind, 0);
+        if (!node)
+            return (LayoutNode *)PyErr_NoMemory();
+        node->length = length;
+        break;
+    }
+    case LAYOUT_VEC:
+    case LAYOUT_SHORT_VEC:
+    case LAYOUT_ARRAY:
+    case LAYOUT_OPTION:
+    case LAYOUT_COPTION:
+    case LAYOUT_MAP:
+    case LAYOUT_SET:
+    case LAYOUT_VIEW:
+    {
+        Py_ssize_t n_children = kind == LAYOUT_MAP ? 2 : 1;
+        if (n_args != n_children + (kind == LAYOUT_ARRAY))
+            goto malformed;
+        node = layout_new(kind, (size_t)n_children);
+        if (!node)
+            return (LayoutNode *)PyErr_NoMemory();
+        for (Py_ssize_t i = 0; i < n_children; i++)
+        {
+            node->children[i] = compile_layout(PyTuple_GET_ITEM(spec, 1 + i), depth + 1);
+            if (!node->children[i])
+            {
+                layout_free(node, release_layout_object);
+                return NULL;
+            }
+        }
+        if (kind == LAYOUT_ARRAY && layout_spec_length(PyTuple_GET_ITEM(spec, 2), &node->length) < 0)
+        {
+            layout_free(node, release_layout_object);
+            return NULL;
+        }
+        if (kind == LAYOUT_VIEW && node->children[0]->kind != LAYOUT_BYTES &&
+            node->children[0]->kind != LAYOUT_SHORT_BYTES && node->children[0]->kind != LAYOUT_FIXED_BYTES)
+        {
+            layout_free(node, release_layout_object);
+            PyErr_SetString(PyExc_ValueError, "Only bytes layouts can be views");
+            return NULL;
+        }
+        if (kind == LAYOUT_COPTION && node->children[0]->size >= LAYOUT_VARIABLE - 4)
+        {
+            layout_free(node, release_layout_object);
+            PyErr_SetString(PyExc_ValueError, "COption layouts need a fixed-size element");
+            return NULL;
+        }
+        break;
+    }
+    case LAYOUT_VERSIONED:
+    {
+        if (n_args != 2 || !PyTuple_Check(PyTuple_GET_ITEM(spec, 2)))
+            goto malformed;
+        PyObject *versions = PyTuple_GET_ITEM(spec, 2);
+        Py_ssize_t n_versions = PyTuple_GET_SIZE(versions);
+        if (n_versions > 128)
+            goto malformed;
+        node = layout_new(kind, 1 + (size_t)n_versions);
+        if (!node)
+            return (LayoutNode *)PyErr_NoMemory();
+        for (Py_ssize_t i = 0; i <= n_versions; i++)
+        {
+            PyObject *child = i == 0 ? PyTuple_GET_ITEM(spec, 1) : PyTuple_GET_ITEM(versions, i - 1);
+            node->children[i] = compile_layout(child, depth + 1);
+            if (!node->children[i])
+            {
+                layout_free(node, release_layout_object);
+                return NULL;
+            }
+        }
+        break;
+    }
+    case LAYOUT_TUPLE:
+    {
+        if (n_args != 1 || !PyTuple_Check(PyTuple_GET_ITEM(spec, 1)))
+            goto malformed;
+        PyObject *items = PyTuple_GET_ITEM(spec, 1);
+        node = layout_new(kind, (size_t)PyTuple_GET_SIZE(items));
+        if (!node)
+            return (LayoutNode *)PyErr_NoMemory();
+        for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(items); i++)
+        {
+            node->children[i] = compile_layout(PyTuple_GET_ITEM(items, i), depth + 1);
+            if (!node->children[i])
+            {
+                layout_free(node, release_layout_object);
+                return NULL;
+            }
+        }
+        break;
+    }
+    case LAYOUT_STRUCT:
+    case LAYOUT_ENUM:
+    {
+        if (n_args < 1 || n_args > (kind == LAYOUT_STRUCT ? 2 : 1) || !PyTuple_Check(PyTuple_GET_ITEM(spec, 1)))
+            goto malformed;
+        PyObject *fields = PyTuple_GET_ITEM(spec, 1);
+        Py_ssize_t n_fields = PyTuple_GET_SIZE(fields);
+        if (kind == LAYOUT_ENUM && (n_fields < 1 || n_fields > 256))
+        {
+            PyErr_SetString(PyExc_ValueError, "Enum layout needs 1 to 256 variants");
+            return NULL;
+        }
+        node = layout_new(kind, (size_t)n_fields);
+        if (!node)
+            return (LayoutNode *)PyErr_NoMemory();
+        for (Py_ssize_t i = 0; i < n_fields; i++)
+        {
+            PyObject *field = PyTuple_GET_ITEM(fields, i);
+            if (!PyTuple_Check(field) || PyTuple_GET_SIZE(field) != 2 ||
+                !PyUnicode_Check(PyTuple_GET_ITEM(field, 0)))
+            {
+                layout_free(node, release_layout_object);
+                goto malformed;
+            }
+            PyObject *field_spec = PyTuple_GET_ITEM(field, 1);
+            if (kind == LAYOUT_ENUM && field_spec == Py_None)
+            {
+                // Unit variant: nothing follows the tag
+                node->children[i] = layout_new(LAYOUT_PADDING, 0);
+                if (!node->children[i] || !layout_finalize(node->children[i]))
+                {
+                    layout_free(node, release_layout_object);
+                    return (LayoutNode *)PyErr_NoMemory();
+                }
+            }
+            else
+            {
+                node->children[i] = compile_layout(field_spec, depth + 1);
+                if (!node->children[i])
+                {
+                    layout_free(node, release_layout_object);
+                    return NULL;
+                }
+            }
+            Py_INCREF(PyTuple_GET_ITEM(field, 0));
+            node->children[i]->name = PyTuple_GET_ITEM(field, 0);
+        }
+
+        if (kind == LAYOUT_STRUCT && n_args == 2 && PyTuple_GET_ITEM(spec, 2) != Py_None)
+        {
+            if (!PyCallable_Check(PyTuple_GET_ITEM(spec, 2)))
+            {
+                layout_free(node, release_layout_object);
+                goto malformed;
+            }
+            Py_INCREF(PyTuple_GET_ITEM(spec, 2));
+            node->meta = PyTuple_GET_ITEM(spec, 2);
+        }
+        else if (kind == LAYOUT_ENUM)
+        {
+            // Variant name -> index, so writes find their tag in one lookup
+            PyObject *lookup = PyDict_New();
+            node->meta = lookup;
+            if (!lookup)
+            {
+                layout_free(node, release_layout_object);
+                return NULL;
+            }
+            for (Py_ssize_t i = 0; i < n_fields; i++)
+            {
+                PyObject *index = PyLong_FromSsize_t(i);
+                if (!index || PyDict_SetItem(lookup, (PyObject *)node->children[i]->name, index) < 0)
+                {
+                    Py_XDECREF(index);
+                    layout_free(node, release_layout_object);
+                    return NULL;
+                }
+                Py_DECREF(index);
+            }
+        }
+        break;
+    }
+    default:
+        if (n_args != 0)
+            goto malformed;
+        node = layout_new(kind, 0);
+        if (!node)
+            return (LayoutNode *)PyErr_NoMemory();
+        break;
+    }
+
+    if (!layout_finalize(node))
+    {
+        layout_free(node, release_layout_object);
+        PyErr_SetString(PyExc_OverflowError, "Layout size overflow (or out of memory)");
+        return NULL;
+    }
+    return node;
+
+malformed:
+    PyErr_Format(PyExc_ValueError, "Malformed layout spec %R", spec);
+    return NULL;
+}
+
+static void
+PyLayout_dealloc(PyLayoutObject *self)
+{
+    layout_free(self->root, release_layout_object);
+    self->root = NULL;
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int
+PyLayout_init(PyLayoutObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"spec", NULL};
+    PyObject *spec = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &spec))
+    {
+        return -1;
+    }
+    LayoutNode *root = compile_layout(spec, 0);
+    if (!root)
+        return -1;
+
+    layout_free(self->root, release_layout_object);
+    self->root = root;
+    return 0;
+}
+
+/*
+ * Convenience function to fetch the compiled layout tree.
+ * Sets a Python exception if it is NULL.
+ */
+static inline LayoutNode *
+GetLayout(PyObject *obj)
+{
+    LayoutNode *root = ((PyLayoutObject *)obj)->root;
+    if (!root)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Layout is not compiled");
+    }
+    return root;
+}
+
+static PyObject *
+PyLayout_get_size(PyLayoutObject *self, void *closure)
+{
+    LayoutNode *root = GetLayout((PyObject *)self);
+    if (!root)
+        return NULL;
+    if (root->size == LAYOUT_VARIABLE)
+    {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromSize_t(root->size);
+}
+
+/* -----------------------------------------------------
+ * Native Values
+ *
+ * Layout.read/Layout.write convert between encoded data and the Python
+ * values the qborsh types produce, for a whole value in one native call.
+ * ----------------------------------------------------- */
+
+static int LayoutNumber_FromObject(PyObject *obj, LayoutNumber *out);
+static PyObject *LayoutNumber_AsObject(const LayoutNumber *n);
+
+static const char *
+layout_kind_name(LayoutKind kind)
+{
+    for (int i = 0; layout_kind_names[i].name; i++)
+    {
+        if (layout_kind_names[i].kind == kind)
+            return layout_kind_names[i].name;
+    }
+    return "value";
+}
+
+/*
+ * Raises the error of a failed read or write, like CheckBufferError.
+ */
+static PyObject *
+layout_buffer_error(void)
+{
+    PyErr_SetString(PyExc_RuntimeError, "Buffer encountered an error (OOM or out-of-bounds).");
+    return NULL;
+}
+
+/*
+ * State of one Layout.read call. Views slice 'source', the object the
+ * buffer is attached to (its bytes start at 'base'), when it is immutable
+ * bytes; otherwise they are copied to bytes.
+ */
+typedef struct
+{
+    PyObject *source;
+    const uint8_t *base;
+    PyObject *memory; /* memoryview of 'source', created by the first view */
+    int shared;       /* 1: views may alias 'source', -1: they copy, 0: not checked yet */
+} LayoutReader;
+
+static PyObject *layout_read_value(const LayoutNode *node, Buffer *b, LayoutReader *r);
+
+/*
+ * Decodes a length-prefixed blob (an element of a Map or Set) on its own,
+ * so an element can never read past its blob.
+ */
+static PyObject *
+layout_read_blob(const LayoutNode *node, Buffer *b, LayoutReader *r)
+{
+    uint32_t length = read_u32(b);
+    const uint8_t *data = read_view(b, length);
+    if (buffer_has_error(b))
+        return layout_buffer_error();
+
+    Buffer blob;
+    init_buffer_view(&blob, data, length);
+    return layout_read_value(node, &blob, r);
+}
+
+/*
+ * Whether views may alias 'source': only bytes (or a read-only memoryview of
+ * bytes) can neither change nor go away under them. A bytearray's storage
+ * is reused (e.g. the qborsh.aio receive buffer), a ring slot goes back to
+ * producers and an mmap cannot close while memoryviews of it exist.
+ */
+static bool
+view_source_shared(PyObject *source)
+{
+    if (PyBytes_CheckExact(source))
+        return true;
+    if (PyMemoryView_Check(source))
+    {
+        PyObject *base = PyMemoryView_GET_BASE(source);
+        return base && PyBytes_CheckExact(base) && PyMemoryView_GET_BUFFER(source)->readonly;
+    }
+    return false;
+}
+
+/*
+ * Returns 'length' bytes at 'data' as a memoryview of the source, or as
+ * bytes when the buffer is not attached to one it may alias.
+ */
+static PyObject *
+layout_read_view(LayoutReader *r, const uint8_t *data, size_t length)
+{
+    if (r->source && !r->shared)
+        r->shared = view_source_shared(r->source) ? 1 : -1;
+    if (!r->source || r->shared < 0)
+        return PyBytes_FromStringAndSize((const char *)data, (Py_ssize_t)length);
+    if (!r->memory)
+    {
+        r->memory = PyMemoryView_FromObject(r->source);
+        if (!r->memory)
+            return NULL;
+    }
+    Py_ssize_t start = (Py_ssize_t)(data - r->base);
+    return PySequence_GetSlice(r->memory, start, start + (Py_ssize_t)length);
+}
+
+/* -----------------------------------------------------
+ * Intern Tables
+ *
+ * Bounded, direct-mapped caches of decoded pubkeys and strings for fields
+ * marked interned: a hit returns the object decoded before instead of a new
+ * one, a miss replaces whatever shared its slot. Only touched with the GIL.
+ * ----------------------------------------------------- */
+
+#define INTERN_SLOTS 8192 /* power of two */
+
+typedef struct
+{
+    PyObject *value;
+    uint64_t hash;
+    uint8_t key[32];
+} InternedKey;
+
+typedef struct
+{
+    PyObject *value;
+    uint64_t hash;
+} InternedString;
+
+static InternedKey g_interned_keys[INTERN_SLOTS];
+static InternedString g_interned_strings[INTERN_SLOTS];
+
+static PyObject *
+intern_pubkey(const uint8_t *key)
+{
+    uint64_t hash = hash_bytes(key, 32);
+    InternedKey *slot = &g_interned_keys[hash & (INTERN_SLOTS - 1)];
+    // Cached keys of the other representation (lazy pubkeys toggled) miss
+    if (slot->value && slot->hash == hash && memcmp(slot->key, key, 32) == 0 &&
+        Py_IS_TYPE(slot->value, &PyPublicKeyType) == (g_lazy_pubkeys != 0))
+        return Py_NewRef(slot->value);
+
+    PyObject *value = pubkey_value(key);
+    if (!value)
+        return NULL;
+    Py_XSETREF(slot->value, Py_NewRef(value));
+    slot->hash = hash;
+    memcpy(slot->key, key, 32);
+    return value;
+}
+
+static PyObject *
+intern_string(const uint8_t *data, size_t length)
+{
+    uint64_t hash = hash_bytes(data, length);
+    InternedString *slot = &g_interned_strings[hash & (INTERN_SLOTS - 1)];
+    if (slot->value && slot->hash == hash)
+    {
+        Py_ssize_t cached_length;
+        const char *cached = PyUnicode_AsUTF8AndSize(slot->value, &cached_length);
+        if (cached && (size_t)cached_length == length && memcmp(cached, data, length) == 0)
+            return Py_NewRef(slot->value);
+        PyErr_Clear();
+    }
+
+    PyObject *value = PyUnicode_DecodeUTF8((const char *)data, (Py_ssize_t)length, NULL);
+    if (!value)
+        return NULL;
+    Py_XSETREF(slot->value, Py_NewRef(value));
+    slot->hash = hash;
+    return value;
+}
+
+/*
+ * clear_interned() -> None
+ */
+static PyObject *
+PyBorsh_clear_interned(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    for (size_t i = 0; i < INTERN_SLOTS; i++)
+    {
+        Py_CLEAR(g_interned_keys[i].value);
+        Py_CLEAR(g_interned_strings[i].value);
+    }
+    Py_RETURN_NONE;
+}
+
+/*
+ * Fills 'list' with keys stored back to back, bounds
+ * checked once for the whole run. Steals 'list'.
+ */
+static PyObject *
+layout_read_pubkey_list(const LayoutNode *elem, Buffer *b, PyObject *list)
+{
+    Py_ssize_t count = PyList_GET_SIZE(list);
+    const uint8_t *keys = read_view(b, (size_t)count * 32);
+    if (buffer_has_error(b))
+    {
+        Py_DECREF(list);
+        return layout_buffer_error();
+    }
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject *item = elem->interned ? intern_pubkey(keys + 32 * i) : pubkey_value(keys + 32 * i);
+        if (!item)
+        {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+/*
+ * Fills 'list' with varints read back to back, in one tight loop rather
+ * than one dispatch per element. Steals 'list'.
+ */
+static PyObject *
+layout_read_var_list(const LayoutNode *elem, Buffer *b, PyObject *list)
+{
+    bool is_signed = elem->kind == LAYOUT_VAR_I64;
+    Py_ssize_t count = PyList_GET_SIZE(list);
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        uint64_t raw = read_var_u64(b);
+        if (buffer_has_error(b))
+        {
+            Py_DECREF(list);
+            return layout_buffer_error();
+        }
+        PyObject *item = is_signed ? PyLong_FromLongLong((int64_t)(raw >> 1) ^ -(int64_t)(raw & 1))
+                                   : PyLong_FromUnsignedLongLong(raw);
+        if (!item)
+        {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+/*
+ * Reads one value described by 'node' at the buffer's offset.
+ */
+static PyObject *
+layout_read_value(const LayoutNode *node, Buffer *b, LayoutReader *r)
+{
+    PyObject *result = NULL;
+
+    switch (node->kind)
+    {
+    case LAYOUT_U8:
+        result = PyLong_FromUnsignedLong(read_u8(b));
+        break;
+    case LAYOUT_U16:
+        result = PyLong_FromUnsignedLong(read_u16(b));
+        break;
+    case LAYOUT_U32:
+        result = PyLong_FromUnsignedLong(read_u32(b));
+        break;
+    case LAYOUT_U64:
+        result = PyLong_FromUnsignedLongLong(read_u64(b));
+        break;
+    case LAYOUT_I8:
+        result = PyLong_FromLong(read_i8(b));
+        break;
+    case LAYOUT_I16:
+        result = PyLong_FromLong(read_i16(b));
+        break;
+    case LAYOUT_I32:
+        result = PyLong_FromLong(read_i32(b));
+        break;
+    case LAYOUT_I64:
+        result = PyLong_FromLongLong(read_i64(b));
+        break;
+    case LAYOUT_U128:
+    case LAYOUT_I128:
+    {
+        LayoutNumber number;
+        if (!layout_read_number(node, b, &number))
+            return layout_buffer_error();
+        return LayoutNumber_AsObject(&number);
+    }
+    case LAYOUT_F32:
+        result = PyFloat_FromDouble(read_f32(b));
+        break;
+    case LAYOUT_F64:
+        result = PyFloat_FromDouble(read_f64(b));
+        break;
+    case LAYOUT_BOOL:
+        result = PyBool_FromLong(read_bool(b));
+        break;
+    case LAYOUT_PUBKEY:
+    {
+        const uint8_t *key = read_view(b, 32);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+        return node->interned ? intern_pubkey(key) : pubkey_value(key);
+    }
+    case LAYOUT_PADDING:
+        read_view(b, node->length);
+        result = Py_NewRef(Py_None);
+        break;
+    case LAYOUT_STRING:
+    case LAYOUT_BYTES:
+    {
+        uint32_t length = read_u32(b);
+        const uint8_t *data = read_view(b, length);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+        if (node->kind == LAYOUT_STRING)
+        {
+            if (node->interned)
+                return intern_string(data, length);
+            return PyUnicode_DecodeUTF8((const char *)data, length, NULL);
+        }
+        return PyBytes_FromStringAndSize((const char *)data, length);
+    }
+    case LAYOUT_FIXED_BYTES:
+    case LAYOUT_SHORT_BYTES:
+    case LAYOUT_VIEW:
+    {
+        const LayoutNode *bytes = node->kind == LAYOUT_VIEW ? node->children[0] : node;
+        size_t length = bytes->length;
+        if (bytes->kind != LAYOUT_FIXED_BYTES)
+            length = bytes->kind == LAYOUT_BYTES ? read_u32(b) : read_short_u16(b);
+        const uint8_t *data = read_view(b, length);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+        if (node->kind == LAYOUT_VIEW)
+            return layout_read_view(r, data, length);
+        return PyBytes_FromStringAndSize((const char *)data, (Py_ssize_t)length);
+    }
+    case LAYOUT_VERSIONED:
+    {
+        int version;
+        const LayoutNode *message = layout_version(node, b, &version);
+        if (!message)
+        {
+            if (buffer_has_error(b))
+                return layout_buffer_error();
+            PyErr_Format(PyExc_ValueError, "Unsupported message version %d.", version);
+            return NULL;
+        }
+        result = layout_read_value(message, b, r);
+        if (!result || !PyDict_Check(result))
+            return result;
+
+        // Struct messages carry their version: "legacy" or the number
+        PyObject *tag = version < 0 ? PyUnicode_FromString("legacy") : PyLong_FromLong(version);
+        if (!tag || PyDict_SetItemString(result, "version", tag) < 0)
+        {
+            Py_XDECREF(tag);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(tag);
+        return result;
+    }
+    case LAYOUT_SHORT_U16:
+        result = PyLong_FromUnsignedLong(read_short_u16(b));
+        break;
+    case LAYOUT_VAR_U64:
+        result = PyLong_FromUnsignedLongLong(read_var_u64(b));
+        break;
+    case LAYOUT_VAR_I64:
+        result = PyLong_FromLongLong(read_var_i64(b));
+        break;
+    case LAYOUT_VEC:
+    case LAYOUT_SHORT_VEC:
+    case LAYOUT_ARRAY:
+    {
+        const LayoutNode *elem = node->children[0];
+        size_t count = node->length;
+        if (node->kind != LAYOUT_ARRAY)
+        {
+            count = node->kind == LAYOUT_VEC ? read_u32(b) : read_short_u16(b);
+            if (buffer_has_error(b))
+                return layout_buffer_error();
+        }
+        // Every element but an empty one takes a byte, so a count the data
+        // cannot hold is rejected before allocating for it
+        if (elem->size != 0 && count > b->size - b->offset)
+            return layout_buffer_error();
+
+        PyObject *list = PyList_New((Py_ssize_t)count);
+        if (!list)
+            return NULL;
+        if (elem->kind == LAYOUT_VAR_U64 || elem->kind == LAYOUT_VAR_I64)
+            return layout_read_var_list(elem, b, list);
+        if (elem->kind == LAYOUT_PUBKEY)
+            return layout_read_pubkey_list(elem, b, list);
+        for (size_t i = 0; i < count; i++)
+        {
+            PyObject *item = layout_read_value(elem, b, r);
+            if (!item)
+            {
+                Py_DECREF(list);
+                return NULL;
+            }
+            PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+        }
+        return list;
+    }
+    case LAYOUT_OPTION:
+    {
+        bool some = read_bool(b);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+        if (some)
+            return layout_read_value(node->children[0], b, r);
+        Py_RETURN_NONE;
+    }
+    case LAYOUT_COPTION:
+    {
+        uint32_t tag = read_u32(b);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+        if (tag == 1)
+            return layout_read_value(node->children[0], b, r);
+        if (tag != 0)
+        {
+            PyErr_Format(PyExc_ValueError, "Invalid COption tag %u.", (unsigned)tag);
+            return NULL;
+        }
+        // The element's bytes are there (zeroed) even when it is absent
+        read_view(b, node->children[0]->size);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+        Py_RETURN_NONE;
+    }
+    case LAYOUT_MAP:
+    case LAYOUT_SET:
+    {
+        uint32_t count = read_u32(b);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+
+        bool is_map = node->kind == LAYOUT_MAP;
+        PyObject *collection = is_map ? PyDict_New() : PySet_New(NULL);
+        if (!collection)
+            return NULL;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            PyObject *key = layout_read_blob(node->children[0], b, r);
+            if (!key)
+            {
+                Py_DECREF(collection);
+                return NULL;
+            }
+            int status;
+            if (is_map)
+            {
+                PyObject *value = layout_read_blob(node->children[1], b, r);
+                status = value ? PyDict_SetItem(collection, key, value) : -1;
+                Py_XDECREF(value);
+            }
+            else
+            {
+                status = PySet_Add(collection, key);
+            }
+            Py_DECREF(key);
+            if (status < 0)
+            {
+                Py_DECREF(collection);
+                return NULL;
+            }
+        }
+        return collection;
+    }
+    case LAYOUT_STRUCT:
+    case LAYOUT_TUPLE:
+    {
+        // Fixed-size records are bounds checked once, then their fields are
+        // read from a view of exactly their bytes
+        Buffer fixed;
+        if (node->size != LAYOUT_VARIABLE)
+        {
+            const uint8_t *data = read_view(b, node->size);
+            if (buffer_has_error(b))
+                return layout_buffer_error();
+            init_buffer_view(&fixed, data, node->size);
+            b = &fixed;
+        }
+
+        if (node->kind == LAYOUT_TUPLE)
+        {
+            PyObject *tuple = PyTuple_New((Py_ssize_t)node->n_children);
+            if (!tuple)
+                return NULL;
+            for (size_t i = 0; i < node->n_children; i++)
+            {
+                PyObject *item = layout_read_value(node->children[i], b, r);
+                if (!item)
+                {
+                    Py_DECREF(tuple);
+                    return NULL;
+                }
+                PyTuple_SET_ITEM(tuple, (Py_ssize_t)i, item);
+            }
+            return tuple;
+        }
+
+        PyObject *dict = PyDict_New();
+        if (!dict)
+            return NULL;
+        for (size_t i = 0; i < node->n_children; i++)
+        {
+            const LayoutNode *field = node->children[i];
+            if (field->kind == LAYOUT_PADDING)
+            {
+                // Padding is skipped and left out of the result
+                read_view(b, field->length);
+                if (buffer_has_error(b))
+                {
+                    Py_DECREF(dict);
+                    return layout_buffer_error();
+                }
+                continue;
+            }
+            PyObject *value = layout_read_value(field, b, r);
+            if (!value || PyDict_SetItem(dict, (PyObject *)field->name, value) < 0)
+            {
+                Py_XDECREF(value);
+                Py_DECREF(dict);
+                return NULL;
+            }
+            Py_DECREF(value);
+        }
+        if (!node->meta)
+            return dict;
+        result = PyObject_CallOneArg((PyObject *)node->meta, dict);
+        Py_DECREF(dict);
+        return result;
+    }
+    case LAYOUT_ENUM:
+    {
+        uint8_t tag = read_u8(b);
+        if (buffer_has_error(b))
+            return layout_buffer_error();
+        if (tag >= node->n_children)
+        {
+            PyErr_Format(PyExc_ValueError, "Invalid enum variant index %u.", (unsigned)tag);
+            return NULL;
+        }
+        // The tag indexes the variant table directly
+        const LayoutNode *variant = node->children[tag];
+        PyObject *payload = layout_read_value(variant, b, r);
+        if (!payload)
+            return NULL;
+        result = PyTuple_Pack(2, (PyObject *)variant->name, payload);
+        Py_DECREF(payload);
+        return result;
+    }
+    }
+
+    // Scalars: the reads above may have run past the data
+    if (result && buffer_has_error(b))
+    {
+        Py_DECREF(result);
+        return layout_buffer_error();
+    }
+    return result;
+}
+
+/*
+ * Writes an integer 'value' of at most 64 bits, range checked like the
+ * Buffer.write_* methods when validation is on.
+ */
+static int
+layout_write_int(const LayoutNode *node, Buffer *b, PyObject *value)
+{
+    if (!PyLong_Check(value))
+    {
+        PyErr_Format(PyExc_TypeError, "Expected int for %s, not %.200s", layout_kind_name(node->kind),
+                     Py_TYPE(value)->tp_name);
+        return -1;
+    }
+
+    int overflow = 0;
+    long long s = PyLong_AsLongLongAndOverflow(value, &overflow);
+    if (s == -1 && PyErr_Occurred())
+        return -1;
+
+    bool is_signed = node->kind >= LAYOUT_I8 && node->kind <= LAYOUT_I64;
+    int bits = 8 * (int)node->size;
+    if (is_signed)
+    {
+        long long max = bits == 64 ? LLONG_MAX : (1LL << (bits - 1)) - 1;
+        if (overflow || (g_validation_enabled && (s > max || s < -max - 1)))
+        {
+            PyErr_Format(PyExc_ValueError, "%s out of range", layout_kind_name(node->kind));
+            return -1;
+        }
+    }
+    else if (overflow < 0 || (overflow == 0 && s < 0))
+    {
+        if (g_validation_enabled)
+        {
+            PyErr_Format(PyExc_ValueError, "%s cannot be negative", layout_kind_name(node->kind));
+            return -1;
+        }
+    }
+    unsigned long long u = (unsigned long long)s;
+    if (!is_signed && overflow > 0)
+    {
+        u = PyLong_AsUnsignedLongLong(value);
+        if (u == (unsigned long long)-1 && PyErr_Occurred())
+        {
+            // 2**64 and up: the same error the Python path raises, not OverflowError
+            if (!PyErr_ExceptionMatches(PyExc_OverflowError))
+                return -1;
+            PyErr_Clear();
+            PyErr_Format(PyExc_ValueError, "%s out of range", layout_kind_name(node->kind));
+            return -1;
+        }
+    }
+    if (!is_signed && g_validation_enabled && bits < 64 && u >> bits)
+    {
+        PyErr_Format(PyExc_ValueError, "%s out of range", layout_kind_name(node->kind));
+        return -1;
+    }
+
+    switch (bits)
+    {
+    case 8:
+        write_u8(b, (uint8_t)u);
+        break;
+    case 16:
+        write_u16(b, (uint16_t)u);
+        break;
+    case 32:
+        write_u32(b, (uint32_t)u);
+        break;
+    default:
+        write_u64(b, (uint64_t)u);
+        break;
+    }
+    return 0;
+}
+
+static int
+layout_write_u128(const LayoutNode *node, Buffer *b, PyObject *value)
+{
+    LayoutNumber number;
+    if (!PyLong_Check(value))
+    {
+        PyErr_Format(PyExc_TypeError, "Expected int for %s, not %.200s", layout_kind_name(node->kind),
+                     Py_TYPE(value)->tp_name);
+        return -1;
+    }
+    if (LayoutNumber_FromObject(value, &number) < 0)
+        return -1;
+    if (node->kind == LAYOUT_U128 && number.type == LAYOUT_NUM_INT)
+    {
+        PyErr_SetString(PyExc_ValueError, "u128 cannot be negative");
+        return -1;
+    }
+    if (node->kind == LAYOUT_I128 && number.type == LAYOUT_NUM_UINT && number.u >> 127)
+    {
+        PyErr_SetString(PyExc_ValueError, "i128 out of range");
+        return -1;
+    }
+    write_u128(b, number.type == LAYOUT_NUM_INT ? (unsigned __int128)number.i : number.u);
+    return 0;
+}
+
+/*
+ * Writes 'length' bytes (zeros without 'data') in one step.
+ */
+static int
+layout_write_raw(Buffer *b, const void *data, size_t length)
+{
+    uint8_t *dest = buffer_reserve(b, length);
+    if (!dest)
+        return 0; // the buffer's error flag reports it
+    if (data)
+        memcpy(dest, data, length);
+    else
+        memset(dest, 0, length);
+    return 0;
+}
+
+/*
+ * Writes a u32 length prefix followed by 'length' bytes.
+ */
+static int
+layout_write_prefixed(Buffer *b, const void *data, Py_ssize_t length)
+{
+    if ((uint64_t)length > 0xFFFFFFFFULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "Value too large for u32 length");
+        return -1;
+    }
+    write_u32(b, (uint32_t)length);
+    return layout_write_raw(b, data, (size_t)length);
+}
+
+static int layout_write_value(const LayoutNode *node, Buffer *b, PyObject *value);
+
+/*
+ * Writes 'value' as a length-prefixed blob (an element of a Map or Set). The
+ * prefix is patched in once the element is written, so nothing is copied.
+ */
+static int
+layout_write_blob(const LayoutNode *node, Buffer *b, PyObject *value)
+{
+    size_t start = b->size;
+    write_u32(b, 0);
+    if (buffer_has_error(b) || layout_write_value(node, b, value) < 0)
+        return -1;
+    if (buffer_has_error(b))
+        return 0;
+
+    size_t length = b->size - start - 4;
+    if (length > 0xFFFFFFFFULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "Value too large for u32 length");
+        return -1;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        b->data[start + i] = (uint8_t)(length >> (8 * i));
+    }
+    return 0;
+}
+
+/*
+ * Writes 'value' as described by 'node'. Returns -1 with a Python exception
+ * set for values that do not fit the layout; buffer failures only set the
+ * buffer's error flag, checked by the caller.
+ */
+static int
+layout_write_value(const LayoutNode *node, Buffer *b, PyObject *value)
+{
+    switch (node->kind)
+    {
+    case LAYOUT_U8:
+    case LAYOUT_U16:
+    case LAYOUT_U32:
+    case LAYOUT_U64:
+    case LAYOUT_I8:
+    case LAYOUT_I16:
+    case LAYOUT_I32:
+    case LAYOUT_I64:
+        return layout_write_int(node, b, value);
+    case LAYOUT_U128:
+    case LAYOUT_I128:
+        return layout_write_u128(node, b, value);
+    case LAYOUT_F32:
+    case LAYOUT_F64:
+    {
+        double f = PyFloat_AsDouble(value);
+        if (f == -1.0 && PyErr_Occurred())
+            return -1;
+        if (node->kind == LAYOUT_F32)
+            write_f32(b, (float)f);
+        else
+            write_f64(b, f);
+        return 0;
+    }
+    case LAYOUT_BOOL:
+    {
+        // Same values as qborsh.Bool: booleans, 0 and 1
+        int truth = value == Py_True;
+        if (value != Py_True && value != Py_False)
+        {
+            long number = PyLong_Check(value) ? PyLong_AsLong(value) : -1;
+            if (number != 0 && number != 1)
+            {
+                PyErr_Clear();
+                PyErr_SetString(PyExc_TypeError, "Bool expects a bool or integer value of 0 or 1.");
+                return -1;
+            }
+            truth = (int)number;
+        }
+        write_bool(b, truth);
+        return 0;
+    }
+    case LAYOUT_PUBKEY:
+    {
+        uint8_t key[32];
+        if (pubkey_from_object(value, key) < 0)
+            return -1;
+        return layout_write_raw(b, (const char *)key, 32);
+    }
+    case LAYOUT_PADDING:
+        return layout_write_raw(b, NULL, node->length);
+    case LAYOUT_STRING:
+    {
+        if (!PyUnicode_Check(value))
+        {
+            PyErr_SetString(PyExc_TypeError, "String expects a string input.");
+            return -1;
+        }
+        Py_ssize_t length;
+        const char *data = PyUnicode_AsUTF8AndSize(value, &length);
+        if (!data)
+            return -1;
+        return layout_write_prefixed(b, data, length);
+    }
+    case LAYOUT_BYTES:
+        if (!PyBytes_Check(value))
+        {
+            PyErr_SetString(PyExc_TypeError, "Bytes expects a bytes input.");
+            return -1;
+        }
+        return layout_write_prefixed(b, PyBytes_AS_STRING(value), PyBytes_GET_SIZE(value));
+    case LAYOUT_FIXED_BYTES:
+    case LAYOUT_SHORT_BYTES:
+    case LAYOUT_VIEW:
+    {
+        // Any bytes-like value, e.g. a view decoded earlier
+        const LayoutNode *bytes = node->kind == LAYOUT_VIEW ? node->children[0] : node;
+        Py_buffer view;
+        if (PyObject_GetBuffer(value, &view, PyBUF_SIMPLE) < 0)
+            return -1;
+        int status = 0;
+        if (bytes->kind == LAYOUT_FIXED_BYTES && (size_t)view.len != bytes->length)
+        {
+            PyErr_Format(PyExc_ValueError, "Expected %zu bytes. Received: %zd", bytes->length, view.len);
+            status = -1;
+        }
+        else if (bytes->kind == LAYOUT_SHORT_BYTES && view.len > 0xFFFF)
+        {
+            PyErr_SetString(PyExc_ValueError, "Too many bytes for a shortvec length");
+            status = -1;
+        }
+        else if (bytes->kind == LAYOUT_BYTES)
+        {
+            status = layout_write_prefixed(b, view.buf, view.len);
+        }
+        else
+        {
+            if (bytes->kind == LAYOUT_SHORT_BYTES)
+                write_short_u16(b, (uint16_t)view.len);
+            status = layout_write_raw(b, view.buf, (size_t)view.len);
+        }
+        PyBuffer_Release(&view);
+        return status;
+    }
+    case LAYOUT_VERSIONED:
+    {
+        // "legacy" (or no version) writes no prefix
+        PyObject *version = PyMapping_Check(value) ? PyMapping_GetItemString(value, "version") : NULL;
+        if (!version)
+            PyErr_Clear();
+        size_t index = 0;
+        if (version && !(PyUnicode_Check(version) && PyUnicode_CompareWithASCIIString(version, "legacy") == 0))
+        {
+            long number = PyLong_AsLong(version);
+            if (number < 0 || (size_t)number + 1 >= node->n_children)
+            {
+                Py_DECREF(version);
+                PyErr_Clear();
+                PyErr_Format(PyExc_ValueError, "Unsupported message version %ld.", number);
+                return -1;
+            }
+            index = (size_t)number + 1;
+            write_u8(b, (uint8_t)(0x80 | number));
+        }
+        Py_XDECREF(version);
+        return layout_write_value(node->children[index], b, value);
+    }
+    case LAYOUT_VAR_U64:
+    case LAYOUT_VAR_I64:
+    {
+        uint64_t raw;
+        if (var_int_from_object(value, node->kind == LAYOUT_VAR_I64, &raw) < 0)
+            return -1;
+        write_var_u64(b, raw);
+        return 0;
+    }
+    case LAYOUT_SHORT_U16:
+    {
+        long count = PyLong_AsLong(value);
+        if (count == -1 && PyErr_Occurred())
+            return -1;
+        if (count < 0 || count > 0xFFFF)
+        {
+            PyErr_SetString(PyExc_ValueError, "short_u16 out of range (0..65535)");
+            return -1;
+        }
+        write_short_u16(b, (uint16_t)count);
+        return 0;
+    }
+    case LAYOUT_VEC:
+    case LAYOUT_SHORT_VEC:
+    case LAYOUT_ARRAY:
+    {
+        if (!PyList_Check(value))
+        {
+            PyErr_Format(PyExc_TypeError, "Expected list. Received: %S", value);
+            return -1;
+        }
+        Py_ssize_t count = PyList_GET_SIZE(value);
+        if (node->kind == LAYOUT_ARRAY && (size_t)count != node->length)
+        {
+            PyErr_Format(PyExc_ValueError, "Expected list of size %zu. Received: %S of size %zd", node->length,
+                         value, count);
+            return -1;
+        }
+        if (node->kind == LAYOUT_VEC)
+        {
+            if ((uint64_t)count > 0xFFFFFFFFULL)
+            {
+                PyErr_SetString(PyExc_ValueError, "Too many items for u32 length");
+                return -1;
+            }
+            write_u32(b, (uint32_t)count);
+        }
+        else if (node->kind == LAYOUT_SHORT_VEC)
+        {
+            if (count > 0xFFFF)
+            {
+                PyErr_SetString(PyExc_ValueError, "Too many items for a shortvec length");
+                return -1;
+            }
+            write_short_u16(b, (uint16_t)count);
+        }
+        for (Py_ssize_t i = 0; i < count && i < PyList_GET_SIZE(value); i++)
+        {
+            PyObject *item = Py_NewRef(PyList_GET_ITEM(value, i));
+            int status = layout_write_value(node->children[0], b, item);
+            Py_DECREF(item);
+            if (status < 0)
+                return -1;
+        }
+        return 0;
+    }
+    case LAYOUT_OPTION:
+        write_bool(b, value != Py_None);
+        if (value == Py_None)
+            return 0;
+        return layout_write_value(node->children[0], b, value);
+    case LAYOUT_COPTION:
+        write_u32(b, value != Py_None);
+        if (value == Py_None)
+            return layout_write_raw(b, NULL, node->children[0]->size);
+        return layout_write_value(node->children[0], b, value);
+    case LAYOUT_MAP:
+    {
+        if (!PyDict_Check(value))
+        {
+            PyErr_Format(PyExc_TypeError, "Expected dict. Received: %S", (PyObject *)Py_TYPE(value));
+            return -1;
+        }
+        write_u32(b, (uint32_t)PyDict_Size(value));
+        PyObject *key, *item;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(value, &pos, &key, &item))
+        {
+            if (layout_write_blob(node->children[0], b, key) < 0 ||
+                layout_write_blob(node->children[1], b, item) < 0)
+                return -1;
+        }
+        return 0;
+    }
+    case LAYOUT_SET:
+    {
+        if (!PyAnySet_Check(value))
+        {
+            PyErr_Format(PyExc_TypeError, "Expected set. Received: %S", (PyObject *)Py_TYPE(value));
+            return -1;
+        }
+        write_u32(b, (uint32_t)PySet_GET_SIZE(value));
+        PyObject *it = PyObject_GetIter(value);
+        if (!it)
+            return -1;
+        PyObject *item;
+        while ((item = PyIter_Next(it)))
+        {
+            int status = layout_write_blob(node->children[0], b, item);
+            Py_DECREF(item);
+            if (status < 0)
+            {
+                Py_DECREF(it);
+                return -1;
+            }
+        }
+        Py_DECREF(it);
+        return PyErr_Occurred() ? -1 : 0;
+    }
+    case LAYOUT_STRUCT:
+        for (size_t i = 0; i < node->n_children; i++)
+        {
+            const LayoutNode *field = node->children[i];
+            if (field->kind == LAYOUT_PADDING)
+            {
+                // Padding needs no value, zeros are written
+                if (layout_write_raw(b, NULL, field->length) < 0)
+                    return -1;
+                continue;
+            }
+            PyObject *item = PyObject_GetItem(value, (PyObject *)field->name);
+            if (!item)
+                return -1;
+            int status = layout_write_value(field, b, item);
+            Py_DECREF(item);
+            if (status < 0)
+                return -1;
+        }
+        return 0;
+    case LAYOUT_TUPLE:
+    {
+        PyObject *items = PySequence_Fast(value, "Expected a tuple");
+        if (!items)
+            return -1;
+        if ((size_t)PySequence_Fast_GET_SIZE(items) != node->n_children)
+        {
+            PyErr_Format(PyExc_ValueError, "Expected %zu items. Received: %zd", node->n_children,
+                         PySequence_Fast_GET_SIZE(items));
+            Py_DECREF(items);
+            return -1;
+        }
+        for (size_t i = 0; i < node->n_children; i++)
+        {
+            if (layout_write_value(node->children[i], b, PySequence_Fast_GET_ITEM(items, i)) < 0)
+            {
+                Py_DECREF(items);
+                return -1;
+            }
+        }
+        Py_DECREF(items);
+        return 0;
+    }
+    case LAYOUT_ENUM:
+    {
+        // A unit variant may be given by its name alone
+        PyObject *name = value, *payload = Py_None;
+        if (PyTuple_Check(value) && PyTuple_GET_SIZE(value) == 2)
+        {
+            name = PyTuple_GET_ITEM(value, 0);
+            payload = PyTuple_GET_ITEM(value, 1);
+        }
+        else if (!PyUnicode_Check(value))
+        {
+            PyErr_Format(PyExc_TypeError, "Expected (variant, payload) tuple. Received: %R", value);
+            return -1;
+        }
+        PyObject *index = PyDict_GetItemWithError((PyObject *)node->meta, name);
+        if (!index)
+        {
+            if (!PyErr_Occurred())
+                PyErr_Format(PyExc_ValueError, "Unknown enum variant %R.", name);
+            return -1;
+        }
+        size_t tag = PyLong_AsSize_t(index);
+        const LayoutNode *variant = node->children[tag];
+        if (name == value && !(variant->kind == LAYOUT_PADDING && variant->length == 0))
+        {
+            PyErr_Format(PyExc_ValueError, "Enum variant %R needs a payload.", name);
+            return -1;
+        }
+        write_u8(b, (uint8_t)tag);
+        return layout_write_value(variant, b, payload);
+    }
+    }
+    PyErr_SetString(PyExc_ValueError, "Unsupported layout kind");
+    return -1;
+}
+
+static PyObject *
+PyLayout_read(PyLayoutObject *self, PyObject *arg)
+{
+    LayoutNode *root = GetLayout((PyObject *)self);
+    if (!root)
+        return NULL;
+    if (!PyObject_TypeCheck(arg, &PyBufferType))
+    {
+        PyErr_SetString(PyExc_TypeError, "Expected a Buffer");
+        return NULL;
+    }
+    PyBufferObject *source = (PyBufferObject *)arg;
+    Buffer *b = GetBuffer(source);
+    if (!b || CheckBufferError(b) < 0)
+        return NULL;
+
+    LayoutReader reader = {NULL, NULL, NULL};
+    if (source->attached && source->view.obj)
+    {
+        reader.source = source->view.obj;
+        reader.base = (const uint8_t *)source->view.buf;
+    }
+    PyObject *result = layout_read_value(root, b, &reader);
+    Py_XDECREF(reader.memory);
+    return result;
+}
+
+/*
+ * read_all(data) -> list of the values stored back to back in 'data'
+ */
+static PyObject *
+PyLayout_read_all(PyLayoutObject *self, PyObject *data)
+{
+    LayoutNode *root = GetLayout((PyObject *)self);
+    if (!root)
+        return NULL;
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    size_t size = (size_t)view.len;
+    if (root->size != LAYOUT_VARIABLE && (root->size == 0 || size % root->size != 0))
+    {
+        PyErr_Format(PyExc_ValueError, "%zu bytes are not a whole number of %zu-byte records", size, root->size);
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    Buffer b;
+    init_buffer_view(&b, (const uint8_t *)view.buf, size);
+    LayoutReader reader = {data, (const uint8_t *)view.buf, NULL};
+    PyObject *result = NULL;
+
+    if (root->size != LAYOUT_VARIABLE)
+    {
+        // Fixed-size records: the count is known, fill a preallocated list
+        Py_ssize_t count = (Py_ssize_t)(size / root->size);
+        result = PyList_New(count);
+        for (Py_ssize_t i = 0; result && i < count; i++)
+        {
+            PyObject *item = layout_read_value(root, &b, &reader);
+            if (!item)
+                Py_CLEAR(result);
+            else
+                PyList_SET_ITEM(result, i, item);
+        }
+    }
+    else
+    {
+        result = PyList_New(0);
+        while (result && b.offset < size)
+        {
+            PyObject *item = layout_read_value(root, &b, &reader);
+            if (!item || PyList_Append(result, item) < 0)
+                Py_CLEAR(result);
+            Py_XDECREF(item);
+        }
+    }
+    Py_XDECREF(reader.memory);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+static PyObject *
+PyLayout_write(PyLayoutObject *self, PyObject *args)
+{
+    PyObject *target, *value;
+    if (!PyArg_ParseTuple(args, "O!O", &PyBufferType, &target, &value))
+        return NULL;
+    LayoutNode *root = GetLayout((PyObject *)self);
+    if (!root)
+        return NULL;
+    Buffer *b = GetBuffer((PyBufferObject *)target);
+    if (!b || CheckBufferError(b) < 0)
+        return NULL;
+
+    if (layout_write_value(root, b, value) < 0)
+        return NULL;
+    if (CheckBufferError(b) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef PyLayout_methods[] = {
+    {"read", (PyCFunction)PyLayout_read, METH_O,
+     "Read one value at the buffer's offset and advance past it.\n\n"
+     "Usage:\n  layout.read(buffer)\n"},
+    {"read_all", (PyCFunction)PyLayout_read_all, METH_O,
+     "Read every value stored back to back in a bytes-like object.\n\n"
+     "Usage:\n  layout.read_all(data)\n"},
+    {"write", (PyCFunction)PyLayout_write, METH_VARARGS,
+     "Append the encoding of 'value' to the buffer.\n\n"
+     "Usage:\n  layout.write(buffer, value)\n"},
+    {NULL, NULL, 0, NULL}};
+
+static PyGetSetDef PyLayout_getset[] = {
+    {"size", (getter)PyLayout_get_size, NULL, NULL, NULL},
+    {NULL, NULL, NULL, NULL, NULL}};
+
+static PyTypeObject PyLayoutType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "py_borsh.Layout",
+    .tp_basicsize = sizeof(PyLayoutObject),
+    .tp_dealloc = (destructor)PyLayout_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Compiled native layout of a borsh type",
+    .tp_methods = PyLayout_methods,
+    .tp_getset = PyLayout_getset,
+    .tp_init = (initproc)PyLayout_init,
+    .tp_new = PyType_GenericNew,
+};
+
+/*
+ * Parses a sequence of struct field indices into a LayoutPath and checks
+ * that it addresses a field of 'root'. Returns the field's node.
+ */
+static const LayoutNode *
+LayoutPath_FromObject(PyObject *obj, const LayoutNode *root, LayoutPath *path)
+{
+    PyObject *seq = PySequence_Fast(obj, "field path must be a sequence of indices");
+    if (!seq)
+        return NULL;
+
+    Py_ssize_t depth = PySequence_Fast_GET_SIZE(seq);
+    if (depth > LAYOUT_MAX_DEPTH)
+    {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_ValueError, "Field path too deep");
+        return NULL;
+    }
+    path->depth = (size_t)depth;
+    for (Py_ssize_t d = 0; d < depth; d++)
+    {
+        Py_ssize_t index = PyLong_AsSsize_t(PySequence_Fast_GET_ITEM(seq, d));
+        if (index < 0)
+        {
+            Py_DECREF(seq);
+            if (!PyErr_Occurred())
+                PyErr_SetString(PyExc_ValueError, "Field index must not be negative");
+            return NULL;
+        }
+        path->index[d] = (size_t)index;
+    }
+    Py_DECREF(seq);
+
+    const LayoutNode *node = layout_field(root, path);
+    if (!node)
+    {
+        PyErr_Format(PyExc_ValueError, "Field path %R does not address a field", obj);
+    }
+    return node;
+}
+
+/* -----------------------------------------------------
+ * Numbers
+ * ----------------------------------------------------- */
+
+/*
+ * Converts a Python int to 16 little-endian bytes, raising OverflowError
+ * when it does not fit.
+ */
+static int
+long_as_bytes16(PyObject *obj, unsigned char bytes[16], int is_signed)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+    return _PyLong_AsByteArray((PyLongObject *)obj, bytes, 16, 1, is_signed, 1);
+#else
+    return _PyLong_AsByteArray((PyLongObject *)obj, bytes, 16, 1, is_signed);
+#endif
+}
+
+static int
+LayoutNumber_FromObject(PyObject *obj, LayoutNumber *out)
+{
+    if (PyFloat_Check(obj))
+    {
+        out->type = LAYOUT_NUM_FLOAT;
+        out->f = PyFloat_AS_DOUBLE(obj);
+        return 0;
+    }
+    if (!PyLong_Check(obj))
+    {
+        PyErr_Format(PyExc_TypeError, "Expected int or float, not %.200s", Py_TYPE(obj)->tp_name);
+        return -1;
+    }
+
+    PyObject *zero = PyLong_FromLong(0);
+    if (!zero)
+        return -1;
+    int negative = PyObject_RichCompareBool(obj, zero, Py_LT);
+    Py_DECREF(zero);
+    if (negative < 0)
+        return -1;
+
+    unsigned char bytes[16];
+    if (long_as_bytes16(obj, bytes, negative) < 0)
+        return -1;
+
+    unsigned __int128 raw = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        raw |= ((unsigned __int128)bytes[i]) << (8 * i);
+    }
+    if (negative)
+    {
+        out->type = LAYOUT_NUM_INT;
+        out->i = (__int128)raw;
+    }
+    else
+    {
+        out->type = LAYOUT_NUM_UINT;
+        out->u = raw;
+    }
+    return 0;
+}
+
+static PyObject *
+LayoutNumber_AsObject(const LayoutNumber *n)
+{
+    if (n->type == LAYOUT_NUM_FLOAT)
+        return PyFloat_FromDouble(n->f);
+
+    unsigned __int128 raw = n->type == LAYOUT_NUM_INT ? (unsigned __int128)n->i : n->u;
+    unsigned char bytes[16];
+    for (int i = 0; i < 16; i++)
+    {
+        bytes[i] = (unsigned char)((raw >> (8 * i)) & 0xFF);
+    }
+    return _PyLong_FromByteArray(bytes, 16, 1, n->type == LAYOUT_NUM_INT);
+}
+
+/*
+ * Converts an exact 256-bit two's complement sum to a Python int.
+ */
+static PyObject *
+Sum256_AsObject(const uint64_t sum[4])
+{
+    unsigned char bytes[32];
+    for (int i = 0; i < 32; i++)
+    {
+        bytes[i] = (unsigned char)((sum[i / 8] >> (8 * (i % 8))) & 0xFF);
+    }
+    return _PyLong_FromByteArray(bytes, 32, 1, 1);
+}
+
+/* -----------------------------------------------------
+ * Record Sources
+ * ----------------------------------------------------- */
+
+/*
+ * Pins the memory of a record source for native engines: either one
+ * bytes-like object of back-to-back records, or a sequence of bytes-like
+ * objects with one record each. Nothing is copied.
+ */
+typedef struct
+{
+    RecordSet rs;
+    Py_buffer block;
+    bool has_block;
+    Py_buffer *items;
+    Py_ssize_t n_items;
+} RecordSource;
+
+static void
+RecordSource_Release(RecordSource *src)
+{
+    records_clear(&src->rs);
+    if (src->has_block)
+    {
+        PyBuffer_Release(&src->block);
+        src->has_block = false;
+    }
+    for (Py_ssize_t i = 0; i < src->n_items; i++)
+    {
+        PyBuffer_Release(&src->items[i]);
+    }
+    PyMem_Free(src->items);
+    src->items = NULL;
+    src->n_items = 0;
+}
+
+static int
+RecordSource_Acquire(RecordSource *src, PyObject *source, const LayoutNode *layout)
+{
+    memset(src, 0, sizeof(RecordSource));
+
+    if (PyObject_CheckBuffer(source))
+    {
+        if (PyObject_GetBuffer(source, &src->block, PyBUF_SIMPLE) < 0)
+            return -1;
+        src->has_block = true;
+
+        bool framed;
+        size_t bad = 0;
+        Py_BEGIN_ALLOW_THREADS
+        framed = records_frame(&src->rs, layout, (const uint8_t *)src->block.buf,
+                               (size_t)src->block.len, &bad);
+        Py_END_ALLOW_THREADS
+        if (!framed)
+        {
+            RecordSource_Release(src);
+            PyErr_Format(PyExc_ValueError, "Record %zu is malformed or truncated", bad);
+            return -1;
+        }
+        return 0;
+    }
+
+    PyObject *seq = PySequence_Fast(source, "records must be a bytes-like object or a sequence of them");
+    if (!seq)
+        return -1;
+
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    src->items = (Py_buffer *)PyMem_Calloc(n ? (size_t)n : 1, sizeof(Py_buffer));
+    src->rs.ptrs = (const uint8_t **)malloc((n ? (size_t)n : 1) * sizeof(uint8_t *));
+    src->rs.lens = (size_t *)malloc((n ? (size_t)n : 1) * sizeof(size_t));
+    if (!src->items || !src->rs.ptrs || !src->rs.lens)
+    {
+        Py_DECREF(seq);
+        RecordSource_Release(src);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (Py_ssize_t i = 0; i < n; i++)
+    {
+        if (PyObject_GetBuffer(PySequence_Fast_GET_ITEM(seq, i), &src->items[i], PyBUF_SIMPLE) < 0)
+        {
+            Py_DECREF(seq);
+            RecordSource_Release(src);
+            return -1;
+        }
+        src->n_items = i + 1;
+        src->rs.ptrs[i] = (const uint8_t *)src->items[i].buf;
+        src->rs.lens[i] = (size_t)src->items[i].len;
+    }
+    src->rs.count = (size_t)n;
+
+    // Each Py_buffer holds its own reference to the record object
+    Py_DECREF(seq);
+    return 0;
+}
+
+/* -----------------------------------------------------
+ * Scan
+ * ----------------------------------------------------- */
+
+static const struct
+{
+    const char *name;
+    ScanCmp cmp;
+} scan_cmp_names[] = {
+    {"==", SCAN_EQ},
+    {"!=", SCAN_NE},
+    {"<", SCAN_LT},
+    {"<=", SCAN_LE},
+    {">", SCAN_GT},
+    {">=", SCAN_GE},
+    {NULL, SCAN_EQ}};
+
+static const struct
+{
+    const char *name;
+    ScanAggKind kind;
+} scan_agg_names[] = {
+    {"count", SCAN_COUNT},
+    {"sum", SCAN_SUM},
+    {"min", SCAN_MIN},
+    {"max", SCAN_MAX},
+    {NULL, SCAN_COUNT}};
+
+/*
+ * Filters and aggregates parsed from Python, plus the buffers they pin.
+ */
+typedef struct
+{
+    ScanFilter *filters;
+    Py_buffer *filter_bytes;
+    size_t n_filters;
+    ScanAgg *aggs;
+    bool *agg_float;
+    size_t n_aggs;
+} ScanSpec;
+
+static void
+ScanSpec_Release(ScanSpec *spec)
+{
+    for (size_t i = 0; i < spec->n_filters; i++)
+    {
+        if (spec->filter_bytes[i].obj)
+            PyBuffer_Release(&spec->filter_bytes[i]);
+    }
+    PyMem_Free(spec->filters);
+    PyMem_Free(spec->filter_bytes);
+    PyMem_Free(spec->aggs);
+    PyMem_Free(spec->agg_float);
+    memset(spec, 0, sizeof(ScanSpec));
+}
+
+/*
+ * filters: sequence of (path, cmp, value)
+ * aggregates: sequence of (kind, path or None)
+ */
+static int
+ScanSpec_Parse(ScanSpec *spec, const LayoutNode *layout, PyObject *filters_obj, PyObject *aggs_obj)
+{
+    memset(spec, 0, sizeof(ScanSpec));
+
+    PyObject *filters = PySequence_Fast(filters_obj, "filters must be a sequence");
+    if (!filters)
+        return -1;
+    PyObject *aggs = PySequence_Fast(aggs_obj, "aggregates must be a sequence");
+    if (!aggs)
+    {
+        Py_DECREF(filters);
+        return -1;
+    }
+
+    Py_ssize_t n_filters = PySequence_Fast_GET_SIZE(filters);
+    Py_ssize_t n_aggs = PySequence_Fast_GET_SIZE(aggs);
+    spec->filters = (ScanFilter *)PyMem_Calloc((size_t)n_filters + 1, sizeof(ScanFilter));
+    spec->filter_bytes = (Py_buffer *)PyMem_Calloc((size_t)n_filters + 1, sizeof(Py_buffer));
+    spec->aggs = (ScanAgg *)PyMem_Calloc((size_t)n_aggs + 1, sizeof(ScanAgg));
+    spec->agg_float = (bool *)PyMem_Calloc((size_t)n_aggs + 1, sizeof(bool));
+    if (!spec->filters || !spec->filter_bytes || !spec->aggs || !spec->agg_float)
+    {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    for (Py_ssize_t i = 0; i < n_filters; i++)
+    {
+        ScanFilter *filter = &spec->filters[i];
+        PyObject *path_obj, *value;
+        const char *cmp_name;
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(filters, i), "OsO", &path_obj, &cmp_name, &value))
+            goto error;
+        spec->n_filters = (size_t)i + 1;
+
+        const LayoutNode *node = LayoutPath_FromObject(path_obj, layout, &filter->field);
+        if (!node)
+            goto error;
+
+        int found = -1;
+        for (int k = 0; scan_cmp_names[k].name; k++)
+        {
+            if (strcmp(scan_cmp_names[k].name, cmp_name) == 0)
+                found = k;
+        }
+        if (found < 0)
+        {
+            PyErr_Format(PyExc_ValueError, "Unknown comparison '%s'", cmp_name);
+            goto error;
+        }
+        filter->cmp = scan_cmp_names[found].cmp;
+
+        if (layout_is_numeric(node->kind))
+        {
+            filter->numeric = true;
+            if (LayoutNumber_FromObject(value, &filter->number) < 0)
+                goto error;
+            continue;
+        }
+        if (filter->cmp != SCAN_EQ && filter->cmp != SCAN_NE)
+        {
+            PyErr_SetString(PyExc_ValueError, "Only '==' and '!=' apply to non-numeric fields");
+            goto error;
+        }
+        if (PyObject_GetBuffer(value, &spec->filter_bytes[i], PyBUF_SIMPLE) < 0)
+            goto error;
+        filter->bytes = (const uint8_t *)spec->filter_bytes[i].buf;
+        filter->bytes_len = (size_t)spec->filter_bytes[i].len;
+    }
+
+    for (Py_ssize_t i = 0; i < n_aggs; i++)
+    {
+        ScanAgg *agg = &spec->aggs[i];
+        PyObject *path_obj;
+        const char *kind_name;
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(aggs, i), "sO", &kind_name, &path_obj))
+            goto error;
+        spec->n_aggs = (size_t)i + 1;
+
+        int found = -1;
+        for (int k = 0; scan_agg_names[k].name; k++)
+        {
+            if (strcmp(scan_agg_names[k].name, kind_name) == 0)
+                found = k;
+        }
+        if (found < 0)
+        {
+            PyErr_Format(PyExc_ValueError, "Unknown aggregate '%s'", kind_name);
+            goto error;
+        }
+        agg->kind = scan_agg_names[found].kind;
+        if (agg->kind == SCAN_COUNT)
+            continue;
+
+        const LayoutNode *node = LayoutPath_FromObject(path_obj, layout, &agg->field);
+        if (!node)
+            goto error;
+        if (!layout_is_numeric(node->kind))
+        {
+            PyErr_Format(PyExc_TypeError, "Cannot compute '%s' of a non-numeric field", kind_name);
+            goto error;
+        }
+        spec->agg_float[i] = node->kind == LAYOUT_F32 || node->kind == LAYOUT_F64;
+    }
+
+    Py_DECREF(filters);
+    Py_DECREF(aggs);
+    return 0;
+
+error:
+    Py_DECREF(filters);
+    Py_DECREF(aggs);
+    ScanSpec_Release(spec);
+    return -1;
+}
+
+static PyObject *
+ScanAcc_AsObject(ScanAggKind kind, const ScanAcc *acc, bool is_float)
+{
+    switch (kind)
+    {
+    case SCAN_COUNT:
+        return PyLong_FromUnsignedLongLong(acc->count);
+    case SCAN_SUM:
+        if (is_float)
+            return PyFloat_FromDouble(acc->fsum);
+        return Sum256_AsObject(acc->sum);
+    case SCAN_MIN:
+        if (acc->count == 0)
+            Py_RETURN_NONE;
+        return LayoutNumber_AsObject(&acc->min);
+    default:
+        if (acc->count == 0)
+            Py_RETURN_NONE;
+        return LayoutNumber_AsObject(&acc->max);
+    }
+}
+
+/*
+ * Raises the Python exception matching a failed ScanStatus.
+ */
+static PyObject *
+ScanStatus_SetError(ScanStatus status, size_t bad_record)
+{
+    if (status == SCAN_ERR_NOMEM)
+        return PyErr_NoMemory();
+    if (status == SCAN_ERR_IO)
+        return PyErr_SetFromErrno(PyExc_OSError);
+    PyErr_Format(PyExc_ValueError, "Record %zu is malformed or truncated", bad_record);
+    return NULL;
+}
+
+static PyObject *
+PyBorsh_scan(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"layout", "records", "filters", "aggregates", "workers", NULL};
+    PyObject *layout_obj, *records, *filters, *aggs;
+    Py_ssize_t workers = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!OOO|n", kwlist, &PyLayoutType, &layout_obj,
+                                     &records, &filters, &aggs, &workers))
+    {
+        return NULL;
+    }
+    if (workers < 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "workers must be at least 1");
+        return NULL;
+    }
+    LayoutNode *layout = GetLayout(layout_obj);
+    if (!layout)
+        return NULL;
+
+    ScanSpec spec;
+    if (ScanSpec_Parse(&spec, layout, filters, aggs) < 0)
+        return NULL;
+
+    ScanAcc *out = (ScanAcc *)PyMem_Calloc(spec.n_aggs + 1, sizeof(ScanAcc));
+    if (!out)
+    {
+        ScanSpec_Release(&spec);
+        return PyErr_NoMemory();
+    }
+
+    RecordSource src;
+    if (RecordSource_Acquire(&src, records, layout) < 0)
+    {
+        PyMem_Free(out);
+        ScanSpec_Release(&spec);
+        return NULL;
+    }
+
+    ScanQuery query = {layout, &src.rs, spec.filters, spec.n_filters, spec.aggs, spec.n_aggs};
+    ScanStatus status;
+    size_t bad_record = 0;
+    Py_BEGIN_ALLOW_THREADS
+    status = scan_run(&query, (size_t)workers, out, &bad_record);
+    Py_END_ALLOW_THREADS
+    RecordSource_Release(&src);
+
+    PyObject *result = NULL;
+    if (status != SCAN_OK)
+    {
+        ScanStatus_SetError(status, bad_record);
+        goto done;
+    }
+
+    result = PyList_New((Py_ssize_t)spec.n_aggs);
+    if (!result)
+        goto done;
+    for (size_t a = 0; a < spec.n_aggs; a++)
+    {
+        PyObject *value = ScanAcc_AsObject(spec.aggs[a].kind, &out[a], spec.agg_float[a]);
+        if (!value)
+        {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, (Py_ssize_t)a, value);
+    }
+
+done:
+    PyMem_Free(out);
+    ScanSpec_Release(&spec);
+    return result;
+}
+
+/* -----------------------------------------------------
+ * Aggregate
+ * ----------------------------------------------------- */
+
+static const struct
+{
+    const char *name;
+    GroupOp op;
+} group_op_names[] = {
+    {"count", GROUP_COUNT},
+    {"sum", GROUP_SUM},
+    {"min", GROUP_MIN},
+    {"max", GROUP_MAX},
+    {"histogram", GROUP_HISTOGRAM},
+    {NULL, GROUP_COUNT}};
+
+/*
+ * The result of one group: an int/float (or None) for scalar ops, a list of
+ * bucket counts for histograms. 'entry' is NULL for an empty ungrouped input.
+ */
+static PyObject *
+GroupEntry_AsObject(GroupOp op, const GroupEntry *entry, size_t n_hist, bool is_float)
+{
+    if (op == GROUP_HISTOGRAM)
+    {
+        PyObject *counts = PyList_New((Py_ssize_t)n_hist);
+        if (!counts)
+            return NULL;
+        for (size_t b = 0; b < n_hist; b++)
+        {
+            PyObject *count = PyLong_FromUnsignedLongLong(entry ? entry->hist[b] : 0);
+            if (!count)
+            {
+                Py_DECREF(counts);
+                return NULL;
+            }
+            PyList_SET_ITEM(counts, (Py_ssize_t)b, count);
+        }
+        return counts;
+    }
+
+    static const ScanAggKind kinds[] = {SCAN_COUNT, SCAN_SUM, SCAN_MIN, SCAN_MAX};
+    ScanAcc empty;
+    memset(&empty, 0, sizeof(ScanAcc));
+    return ScanAcc_AsObject(kinds[op], entry ? &entry->acc : &empty, is_float);
+}
+
+static PyObject *
+GroupTable_AsObject(const GroupQuery *query, const GroupTable *table, bool is_float)
+{
+    size_t n_hist = query->op == GROUP_HISTOGRAM ? query->n_bins - 1 : 0;
+    if (!query->grouped)
+    {
+        const GroupEntry *entry = NULL;
+        for (size_t i = 0; i < table->capacity && !entry; i++)
+        {
+            if (table->entries[i].used)
+                entry = &table->entries[i];
+        }
+        return GroupEntry_AsObject(query->op, entry, n_hist, is_float);
+    }
+
+    PyObject *result = PyDict_New();
+    if (!result)
+        return NULL;
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        const GroupEntry *entry = &table->entries[i];
+        if (!entry->used)
+            continue;
+
+        PyObject *key = PyBytes_FromStringAndSize((const char *)entry->key, (Py_ssize_t)entry->key_len);
+        PyObject *value = key ? GroupEntry_AsObject(query->op, entry, n_hist, is_float) : NULL;
+        if (!value || PyDict_SetItem(result, key, value) < 0)
+        {
+            Py_XDECREF(key);
+            Py_XDECREF(value);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(key);
+        Py_DECREF(value);
+    }
+    return result;
+}
+
+/*
+ * Parses histogram bin edges, which must be sorted and at least two.
+ */
+static LayoutNumber *
+parse_bins(PyObject *bins_obj, size_t *n_bins)
+{
+    PyObject *bins = PySequence_Fast(bins_obj, "bins must be a sequence of numbers");
+    if (!bins)
+        return NULL;
+
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(bins);
+    if (n < 2)
+    {
+        Py_DECREF(bins);
+        PyErr_SetString(PyExc_ValueError, "bins must hold at least two edges");
+        return NULL;
+    }
+    LayoutNumber *edges = (LayoutNumber *)PyMem_Calloc((size_t)n, sizeof(LayoutNumber));
+    if (!edges)
+    {
+        Py_DECREF(bins);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < n; i++)
+    {
+        if (LayoutNumber_FromObject(PySequence_Fast_GET_ITEM(bins, i), &edges[i]) < 0)
+            goto error;
+        if (i > 0 && layout_number_compare(&edges[i - 1], &edges[i]) >= 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "bins must be strictly increasing");
+            goto error;
+        }
+    }
+    Py_DECREF(bins);
+    *n_bins = (size_t)n;
+    return edges;
+
+error:
+    Py_DECREF(bins);
+    PyMem_Free(edges);
+    return NULL;
+}
+
+static PyObject *
+PyBorsh_aggregate(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"layout", "records", "op", "field", "group_by", "bins", "filters", "workers", NULL};
+    PyObject *layout_obj, *records, *field_obj = Py_None, *group_obj = Py_None;
+    PyObject *bins_obj = Py_None, *filters = NULL;
+    const char *op_name;
+    Py_ssize_t workers = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!Os|OOOOn", kwlist, &PyLayoutType, &layout_obj,
+                                     &records, &op_name, &field_obj, &group_obj, &bins_obj,
+                                     &filters, &workers))
+    {
+        return NULL;
+    }
+    if (workers < 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "workers must be at least 1");
+        return NULL;
+    }
+    LayoutNode *layout = GetLayout(layout_obj);
+    if (!layout)
+        return NULL;
+
+    GroupQuery query;
+    memset(&query, 0, sizeof(GroupQuery));
+    int found = -1;
+    for (int k = 0; group_op_names[k].name; k++)
+    {
+        if (strcmp(group_op_names[k].name, op_name) == 0)
+            found = k;
+    }
+    if (found < 0)
+    {
+        PyErr_Format(PyExc_ValueError, "Unknown aggregate '%s'", op_name);
+        return NULL;
+    }
+    query.op = group_op_names[found].op;
+
+    bool is_float = false;
+    if (query.op != GROUP_COUNT)
+    {
+        if (field_obj == Py_None)
+        {
+            PyErr_Format(PyExc_ValueError, "'%s' needs a field", op_name);
+            return NULL;
+        }
+        const LayoutNode *node = LayoutPath_FromObject(field_obj, layout, &query.field);
+        if (!node)
+            return NULL;
+        if (!layout_is_numeric(node->kind))
+        {
+            PyErr_Format(PyExc_TypeError, "Cannot compute '%s' of a non-numeric field", op_name);
+            return NULL;
+        }
+        is_float = node->kind == LAYOUT_F32 || node->kind == LAYOUT_F64;
+    }
+    if (group_obj != Py_None)
+    {
+        if (!LayoutPath_FromObject(group_obj, layout, &query.key))
+            return NULL;
+        query.grouped = true;
+    }
+
+    LayoutNumber *bins = NULL;
+    if (query.op == GROUP_HISTOGRAM)
+    {
+        if (bins_obj == Py_None)
+        {
+            PyErr_SetString(PyExc_ValueError, "'histogram' needs bins");
+            return NULL;
+        }
+        bins = parse_bins(bins_obj, &query.n_bins);
+        if (!bins)
+            return NULL;
+        query.bins = bins;
+    }
+
+    PyObject *no_aggs = PyTuple_New(0);
+    if (!no_aggs)
+    {
+        PyMem_Free(bins);
+        return NULL;
+    }
+    ScanSpec spec;
+    int parsed = ScanSpec_Parse(&spec, layout, filters ? filters : no_aggs, no_aggs);
+    Py_DECREF(no_aggs);
+    if (parsed < 0)
+    {
+        PyMem_Free(bins);
+        return NULL;
+    }
+
+    RecordSource src;
+    if (RecordSource_Acquire(&src, records, layout) < 0)
+    {
+        ScanSpec_Release(&spec);
+        PyMem_Free(bins);
+        return NULL;
+    }
+
+    ScanQuery scan = {layout, &src.rs, spec.filters, spec.n_filters, NULL, 0};
+    query.scan = &scan;
+    GroupTable table;
+    ScanStatus status;
+    size_t bad_record = 0;
+    Py_BEGIN_ALLOW_THREADS
+    status = group_run(&query, (size_t)workers, &table, &bad_record);
+    Py_END_ALLOW_THREADS
+
+    // Group keys point into the records, so convert before releasing them
+    PyObject *result;
+    if (status != SCAN_OK)
+    {
+        result = ScanStatus_SetError(status, bad_record);
+    }
+    else
+    {
+        result = GroupTable_AsObject(&query, &table, is_float);
+        group_table_free(&table);
+    }
+
+    RecordSource_Release(&src);
+    ScanSpec_Release(&spec);
+    PyMem_Free(bins);
+    return result;
+}
+
+/* -----------------------------------------------------
+ * Sort
+ * ----------------------------------------------------- */
+
+static int
+SortKey_FromObject(SortKey *key, PyObject *path_obj, const LayoutNode *layout, int reverse)
+{
+    LayoutPath path;
+    if (!LayoutPath_FromObject(path_obj, layout, &path))
+        return -1;
+    sort_key_init(key, layout, &path, reverse != 0);
+    return 0;
+}
+
+static PyObject *
+PyBorsh_sort(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"layout", "records", "key", "reverse", "permutation", "workers", NULL};
+    PyObject *layout_obj, *records, *key_obj;
+    int reverse = 0, permutation = 0;
+    Py_ssize_t workers = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!OO|ppn", kwlist, &PyLayoutType, &layout_obj,
+                                     &records, &key_obj, &reverse, &permutation, &workers))
+    {
+        return NULL;
+    }
+    if (workers < 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "workers must be at least 1");
+        return NULL;
+    }
+    LayoutNode *layout = GetLayout(layout_obj);
+    if (!layout)
+        return NULL;
+
+    SortKey key;
+    if (SortKey_FromObject(&key, key_obj, layout, reverse) < 0)
+        return NULL;
+
+    RecordSource src;
+    if (RecordSource_Acquire(&src, records, layout) < 0)
+        return NULL;
+
+    size_t n = src.rs.count;
+    PyObject *perm_obj = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(n * sizeof(uint64_t)));
+    if (!perm_obj)
+    {
+        RecordSource_Release(&src);
+        return NULL;
+    }
+    uint64_t *perm = (uint64_t *)PyBytes_AS_STRING(perm_obj);
+
+    ScanStatus status;
+    size_t bad_record = 0;
+    Py_BEGIN_ALLOW_THREADS
+    status = sort_records(&src.rs, &key, (size_t)workers, perm, &bad_record);
+    Py_END_ALLOW_THREADS
+    if (status != SCAN_OK)
+    {
+        RecordSource_Release(&src);
+        Py_DECREF(perm_obj);
+        return ScanStatus_SetError(status, bad_record);
+    }
+    if (permutation)
+    {
+        RecordSource_Release(&src);
+        return perm_obj;
+    }
+
+    // Gather the records in key order
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint8_t *data;
+        size_t len;
+        record_get(&src.rs, i, &data, &len);
+        total += len;
+    }
+    PyObject *result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)total);
+    if (result)
+    {
+        uint8_t *out = (uint8_t *)PyBytes_AS_STRING(result);
+        Py_BEGIN_ALLOW_THREADS
+        for (size_t i = 0; i < n; i++)
+        {
+            const uint8_t *data;
+            size_t len;
+            record_get(&src.rs, (size_t)perm[i], &data, &len);
+            memcpy(out, data, len);
+            out += len;
+        }
+        Py_END_ALLOW_THREADS
+    }
+    Py_DECREF(perm_obj);
+    RecordSource_Release(&src);
+    return result;
+}
+
+static PyObject *
+PyBorsh_merge_sorted(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"layout", "runs", "key", "fd", "reverse", NULL};
+    PyObject *layout_obj, *runs_obj, *key_obj;
+    int fd, reverse = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!OOi|p", kwlist, &PyLayoutType, &layout_obj,
+                                     &runs_obj, &key_obj, &fd, &reverse))
+    {
+        return NULL;
+    }
+    LayoutNode *layout = GetLayout(layout_obj);
+    if (!layout)
+        return NULL;
+
+    SortKey key;
+    if (SortKey_FromObject(&key, key_obj, layout, reverse) < 0)
+        return NULL;
+
+    PyObject *seq = PySequence_Fast(runs_obj, "runs must be a sequence of bytes-like objects");
+    if (!seq)
+        return NULL;
+    Py_ssize_t n_runs = PySequence_Fast_GET_SIZE(seq);
+    size_t count = n_runs ? (size_t)n_runs : 1;
+    Py_buffer *views = (Py_buffer *)PyMem_Calloc(count, sizeof(Py_buffer));
+    const uint8_t **runs = (const uint8_t **)PyMem_Calloc(count, sizeof(uint8_t *));
+    size_t *sizes = (size_t *)PyMem_Calloc(count, sizeof(size_t));
+    Py_ssize_t acquired = 0;
+    PyObject *result = NULL;
+    if (!views || !runs || !sizes)
+    {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (; acquired < n_runs; acquired++)
+    {
+        if (PyObject_GetBuffer(PySequence_Fast_GET_ITEM(seq, acquired), &views[acquired], PyBUF_SIMPLE) < 0)
+            goto done;
+        runs[acquired] = (const uint8_t *)views[acquired].buf;
+        sizes[acquired] = (size_t)views[acquired].len;
+    }
+
+    ScanStatus status;
+    size_t bad_run = 0;
+    Py_BEGIN_ALLOW_THREADS
+    status = sort_merge(&key, runs, sizes, (size_t)n_runs, fd, &bad_run);
+    Py_END_ALLOW_THREADS
+    if (status == SCAN_ERR_MALFORMED)
+        PyErr_Format(PyExc_ValueError, "Run %zu is malformed or truncated", bad_run);
+    else if (status != SCAN_OK)
+        ScanStatus_SetError(status, bad_run);
+    else
+    {
+        Py_INCREF(Py_None);
+        result = Py_None;
+    }
+
+done:
+    for (Py_ssize_t i = 0; i < acquired; i++)
+    {
+        PyBuffer_Release(&views[i]);
+    }
+    PyMem_Free(views);
+    PyMem_Free(runs);
+    PyMem_Free(sizes);
+    Py_DECREF(seq);
+    return result;
+}
+
+/*
+ * split_records(layout, data, max_bytes) -> list[int]
+ *
+ * Offsets splitting back-to-back records into chunks of at most 'max_bytes'
+ * (or one record, if larger), ending with len(data).
+ */
+static PyObject *
+PyBorsh_split_records(PyObject *self, PyObject *args)
+{
+    PyObject *layout_obj;
+    Py_buffer data;
+    Py_ssize_t max_bytes;
+
+    if (!PyArg_ParseTuple(args, "O!y*n", &PyLayoutType, &layout_obj, &data, &max_bytes))
+        return NULL;
+    LayoutNode *layout = GetLayout(layout_obj);
+    PyObject *result = layout ? PyList_New(0) : NULL;
+    if (!result)
+    {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    size_t size = (size_t)data.len, chunk = 0, record = 0;
+    Buffer view;
+    init_buffer_view(&view, (const uint8_t *)data.buf, size);
+    while (view.offset < size)
+    {
+        size_t start = view.offset;
+        if (!layout_skip(layout, &view))
+        {
+            PyErr_Format(PyExc_ValueError, "Record %zu is malformed or truncated", record);
+            goto error;
+        }
+        record++;
+        if (start > chunk && view.offset - chunk > (size_t)max_bytes)
+        {
+            PyObject *offset = PyLong_FromSize_t(start);
+            if (!offset || PyList_Append(result, offset) < 0)
+            {
+                Py_XDECREF(offset);
+                goto error;
+            }
+            Py_DECREF(offset);
+            chunk = start;
+        }
+    }
+    PyObject *end = PyLong_FromSize_t(size);
+    if (!end || PyList_Append(result, end) < 0)
+    {
+        Py_XDECREF(end);
+        goto error;
+    }
+    Py_DECREF(end);
+    PyBuffer_Release(&data);
+    return result;
+
+error:
+    Py_DECREF(result);
+    PyBuffer_Release(&data);
+    return NULL;
+}
+
+/* -----------------------------------------------------
+ * Index Type
+ * ----------------------------------------------------- */
+
+/*
+ * A hash index opened over its record block. Both buffers stay pinned for
+ * the lifetime of the object; lookups return byte ranges into the block.
+ */
+typedef struct
+{
+    PyObject_HEAD
+    PyObject *layout_obj;
+    Py_buffer index;
+    Py_buffer records;
+    bool opened;
+    IndexView view;
+} PyIndexObject;
+
+static void
+PyIndex_dealloc(PyIndexObject *self)
+{
+    if (self->opened)
+    {
+        PyBuffer_Release(&self->index);
+        PyBuffer_Release(&self->records);
+        self->opened = false;
+    }
+    Py_CLEAR(self->layout_obj);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int
+PyIndex_init(PyIndexObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"layout", "index", "records", NULL};
+    PyObject *layout_obj, *index_obj, *records_obj;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!OO", kwlist, &PyLayoutType, &layout_obj,
+                                     &index_obj, &records_obj))
+    {
+        return -1;
+    }
+    if (self->opened)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Index is already open");
+        return -1;
+    }
+    LayoutNode *layout = GetLayout(layout_obj);
+    if (!layout)
+        return -1;
+
+    if (PyObject_GetBuffer(index_obj, &self->index, PyBUF_SIMPLE) < 0)
+        return -1;
+    if (PyObject_GetBuffer(records_obj, &self->records, PyBUF_SIMPLE) < 0)
+    {
+        PyBuffer_Release(&self->index);
+        return -1;
+    }
+    if (!index_open(&self->view, self->index.buf, (size_t)self->index.len, layout,
+                    (const uint8_t *)self->records.buf, (size_t)self->records.len))
+    {
+        PyBuffer_Release(&self->index);
+        PyBuffer_Release(&self->records);
+        PyErr_SetString(PyExc_ValueError, "Index is corrupt or does not match the layout");
+        return -1;
+    }
+    Py_INCREF(layout_obj);
+    self->layout_obj = layout_obj;
+    self->opened = true;
+    return 0;
+}
+
+static inline IndexView *
+GetIndexView(PyIndexObject *self)
+{
+    if (!self->opened)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Index is not open");
+        return NULL;
+    }
+    return &self->view;
+}
+
+/*
+ * find(key) -> (offset, length) | None
+ *
+ * Byte range of the first record whose field encodes to 'key'.
+ */
+static PyObject *
+PyIndex_find(PyIndexObject *self, PyObject *arg)
+{
+    IndexView *view = GetIndexView(self);
+    if (!view)
+        return NULL;
+
+    Py_buffer key;
+    if (PyObject_GetBuffer(arg, &key, PyBUF_SIMPLE) < 0)
+        return NULL;
+    uint64_t cursor = 0, offset, length;
+    bool found = index_next(view, (const uint8_t *)key.buf, (size_t)key.len, &cursor, &offset, &length);
+    PyBuffer_Release(&key);
+    if (!found)
+        Py_RETURN_NONE;
+    return Py_BuildValue("(KK)", (unsigned long long)offset, (unsigned long long)length);
+}
+
+/*
+ * find_all(key) -> list[(offset, length)]
+ */
+static PyObject *
+PyIndex_find_all(PyIndexObject *self, PyObject *arg)
+{
+    IndexView *view = GetIndexView(self);
+    if (!view)
+        return NULL;
+
+    Py_buffer key;
+    if (PyObject_GetBuffer(arg, &key, PyBUF_SIMPLE) < 0)
+        return NULL;
+    PyObject *result = PyList_New(0);
+    uint64_t cursor = 0, offset, length;
+    while (result && index_next(view, (const uint8_t *)key.buf, (size_t)key.len, &cursor, &offset, &length))
+    {
+        PyObject *range = Py_BuildValue("(KK)", (unsigned long long)offset, (unsigned long long)length);
+        if (!range || PyList_Append(result, range) < 0)
+            Py_CLEAR(result);
+        Py_XDECREF(range);
+    }
+    PyBuffer_Release(&key);
+    return result;
+}
+
+static Py_ssize_t
+PyIndex_len(PyIndexObject *self)
+{
+    IndexView *view = GetIndexView(self);
+    if (!view)
+        return -1;
+    return (Py_ssize_t)view->header->count;
+}
+
+static PyObject *
+PyIndex_get_path(PyIndexObject *self, void *closure)
+{
+    IndexView *view = GetIndexView(self);
+    if (!view)
+        return NULL;
+    PyObject *path = PyTuple_New((Py_ssize_t)view->path.depth);
+    for (size_t d = 0; path && d < view->path.depth; d++)
+    {
+        PyObject *index = PyLong_FromSize_t(view->path.index[d]);
+        if (!index)
+        {
+            Py_CLEAR(path);
+            break;
+        }
+        PyTuple_SET_ITEM(path, (Py_ssize_t)d, index);
+    }
+    return path;
+}
+
+static PyMethodDef PyIndex_methods[] = {
+    {"find", (PyCFunction)PyIndex_find, METH_O, ""},
+    {"find_all", (PyCFunction)PyIndex_find_all, METH_O, ""},
+    {NULL, NULL, 0, NULL}};
+
+static PyGetSetDef PyIndex_getset[] = {
+    {"path", (getter)PyIndex_get_path, NULL, "Field path of the indexed key", NULL},
+    {NULL, NULL, NULL, NULL, NULL}};
+
+static PySequenceMethods PyIndex_as_sequence = {
+    .sq_length = (lenfunc)PyIndex_len,
+};
+
+static PyTypeObject PyIndexType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "py_borsh.Index",
+    .tp_basicsize = sizeof(PyIndexObject),
+    .tp_dealloc = (destructor)PyIndex_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Open-addressing hash index over encoded records",
+    .tp_methods = PyIndex_methods,
+    .tp_getset = PyIndex_getset,
+    .tp_as_sequence = &PyIndex_as_sequence,
+    .tp_init = (initproc)PyIndex_init,
+    .tp_new = PyType_GenericNew,
+};
+
+/*
+ * build_index(layout, records, key, workers=1) -> bytes
+ *
+ * Serialized index of the 'key' field over back-to-back records.
+ */
+static PyObject *
+PyBorsh_build_index(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"layout", "records", "key", "workers", NULL};
+    PyObject *layout_obj, *records, *key_obj;
+    Py_ssize_t workers = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!OO|n", kwlist, &PyLayoutType, &layout_obj,
+                                     &records, &key_obj, &workers))
+    {
+        return NULL;
+    }
+    if (workers < 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "workers must be at least 1");
+        return NULL;
+    }
+    if (!PyObject_CheckBuffer(records))
+    {
+        PyErr_SetString(PyExc_TypeError, "records must be one bytes-like object of back-to-back records");
+        return NULL;
+    }
+    LayoutNode *layout = GetLayout(layout_obj);
+    if (!layout)
+        return NULL;
+
+    LayoutPath path;
+    if (!LayoutPath_FromObject(key_obj, layout, &path))
+        return NULL;
+
+    RecordSource src;
+    if (RecordSource_Acquire(&src, records, layout) < 0)
+        return NULL;
+
+    PyObject *result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)index_bytes(src.rs.count));
+    if (!result)
+    {
+        RecordSource_Release(&src);
+        return NULL;
+    }
+
+    ScanStatus status;
+    size_t bad_record = 0;
+    Py_BEGIN_ALLOW_THREADS
+    status = index_build(layout, &path, &src.rs, (size_t)workers, PyBytes_AS_STRING(result), &bad_record);
+    Py_END_ALLOW_THREADS
+    RecordSource_Release(&src);
+    if (status != SCAN_OK)
+    {
+        Py_DECREF(result);
+        return ScanStatus_SetError(status, bad_record);
+    }
+    return result;
+}
+
+/* -----------------------------------------------------
+ * Record Frames
+ * ----------------------------------------------------- */
+
+/*
+ * crc32c(data, value=0) -> int
+ */
+static PyObject *
+PyBorsh_crc32c(PyObject *self, PyObject *args)
+{
+    Py_buffer data;
+    unsigned int value = 0;
+
+    if (!PyArg_ParseTuple(args, "y*|I", &data, &value))
+        return NULL;
+    uint32_t crc;
+    if (data.len > 4096)
+    {
+        Py_BEGIN_ALLOW_THREADS
+        crc = crc32c(value, (const uint8_t *)data.buf, (size_t)data.len);
+        Py_END_ALLOW_THREADS
+    }
+    else
+    {
+        crc = crc32c(value, (const uint8_t *)data.buf, (size_t)data.len);
+    }
+    PyBuffer_Release(&data);
+    return PyLong_FromUnsignedLong(crc);
+}
+
+/*
+ * frame_span(data, offset, verify=True) -> (payload_offset, length)
+ */
+static PyObject *
+PyBorsh_frame_span(PyObject *self, PyObject *args)
+{
+    Py_buffer data;
+    Py_ssize_t offset;
+    int verify = 1;
+
+    if (!PyArg_ParseTuple(args, "y*n|p", &data, &offset, &verify))
+        return NULL;
+    size_t len = 0;
+    const uint8_t *payload = offset < 0 ? NULL
+                                        : frame_payload((const uint8_t *)data.buf, (size_t)data.len,
+                                                        (size_t)offset, verify != 0, &len);
+    PyBuffer_Release(&data);
+    if (!payload)
+    {
+        PyErr_Format(PyExc_ValueError, "Frame at offset %zd is truncated or corrupt", offset);
+        return NULL;
+    }
+    return Py_BuildValue("(nn)", offset + FRAME_HEADER, (Py_ssize_t)len);
+}
+
+/*
+ * scan_frames(data, start, verify=True) -> (offsets, end)
+ *
+ * 'offsets' packs the frame offsets as native uint64 values; 'end' is where
+ * the last good frame ends.
+ */
+static PyObject *
+PyBorsh_scan_frames(PyObject *self, PyObject *args)
+{
+    Py_buffer data;
+    Py_ssize_t start;
+    int verify = 1;
+
+    if (!PyArg_ParseTuple(args, "y*n|p", &data, &start, &verify))
+        return NULL;
+    if (start < 0 || start > data.len)
+    {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "start is out of range");
+        return NULL;
+    }
+
+    uint64_t *offsets = NULL;
+    size_t count = 0, end;
+    Py_BEGIN_ALLOW_THREADS
+    end = frames_scan((const uint8_t *)data.buf, (size_t)data.len, (size_t)start,
+                      verify != 0, &offsets, &count);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&data);
+    if (end == SIZE_MAX)
+        return PyErr_NoMemory();
+
+    PyObject *packed = PyBytes_FromStringAndSize((const char *)offsets, (Py_ssize_t)(count * sizeof(uint64_t)));
+    free(offsets);
+    if (!packed)
+        return NULL;
+    return Py_BuildValue("(Nn)", packed, (Py_ssize_t)end);
+}
+
+/* -----------------------------------------------------
+ * Read-ahead Types
+ * ----------------------------------------------------- */
+
+/*
+ * A block delivered by the read-ahead thread. Owns its malloc'ed bytes and
+ * exposes them read-only through the buffer protocol, so records are
+ * decoded from it without a copy.
+ */
+typedef struct
+{
+    PyObject_HEAD
+    ReadaheadBlock block;
+} PyBlockObject;
+
+static void
+PyBlock_dealloc(PyBlockObject *self)
+{
+    readahead_block_free(&self->block);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int
+PyBlock_getbuffer(PyBlockObject *self, Py_buffer *view, int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *)self, self->block.data,
+                             (Py_ssize_t)self->block.len, 1, flags);
+}
+
+static Py_ssize_t
+PyBlock_len(PyBlockObject *self)
+{
+    return (Py_ssize_t)self->block.len;
+}
+
+static PyBufferProcs PyBlock_as_buffer = {
+    .bf_getbuffer = (getbufferproc)PyBlock_getbuffer,
+};
+
+static PySequenceMethods PyBlock_as_sequence = {
+    .sq_length = (lenfunc)PyBlock_len,
+};
+
+static PyTypeObject PyBlockType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "py_borsh.Block",
+    .tp_basicsize = sizeof(PyBlockObject),
+    .tp_dealloc = (destructor)PyBlock_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Read-only block loaded by a Readahead",
+    .tp_as_buffer = &PyBlock_as_buffer,
+    .tp_as_sequence = &PyBlock_as_sequence,
+};
+
+/*
+ * Iterator over block frames read, checked and optionally inflated by a
+ * background thread.
+ */
+typedef struct
+{
+    PyObject_HEAD
+    Readahead ra;
+    bool running;
+} PyReadaheadObject;
+
+static void
+PyReadahead_dealloc(PyReadaheadObject *self)
+{
+    if (self->running)
+    {
+        Py_BEGIN_ALLOW_THREADS
+        readahead_stop(&self->ra);
+        Py_END_ALLOW_THREADS
+        self->running = false;
+    }
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int
+PyReadahead_init(PyReadaheadObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"fd", "bounds", "depth", "verify", "inflate", NULL};
+    int fd, verify = 1, inflate = 0;
+    Py_buffer bounds;
+    Py_ssize_t depth = 4;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iy*|npp", kwlist, &fd, &bounds, &depth,
+                                     &verify, &inflate))
+    {
+        return -1;
+    }
+    if (self->running)
+    {
+        PyBuffer_Release(&bounds);
+        PyErr_SetString(PyExc_RuntimeError, "Readahead is already running");
+        return -1;
+    }
+    if (depth < 1 || bounds.len < (Py_ssize_t)sizeof(uint64_t) || bounds.len % sizeof(uint64_t))
+    {
+        PyBuffer_Release(&bounds);
+        PyErr_SetString(PyExc_ValueError, "depth must be >= 1 and bounds must pack at least one uint64");
+        return -1;
+    }
+
+    size_t n_blocks = (size_t)bounds.len / sizeof(uint64_t) - 1;
+    ScanStatus status = readahead_start(&self->ra, fd, (const uint64_t *)bounds.buf, n_blocks,
+                                        (size_t)depth, verify != 0, inflate != 0);
+    PyBuffer_Release(&bounds);
+    if (status != SCAN_OK)
+    {
+        ScanStatus_SetError(status, SIZE_MAX);
+        return -1;
+    }
+    self->running = true;
+    return 0;
+}
+
+/*
+ * __next__() -> (index, Block, offsets | None)
+ *
+ * 'offsets' packs the record frame offsets inside inflated blocks.
+ */
+static PyObject *
+PyReadahead_next(PyReadaheadObject *self)
+{
+    if (!self->running)
+        return NULL;
+
+    ReadaheadBlock block;
+    bool has_block;
+    size_t bad;
+    ScanStatus status;
+    Py_BEGIN_ALLOW_THREADS
+    status = readahead_next(&self->ra, &block, &has_block, &bad);
+    Py_END_ALLOW_THREADS
+
+    if (status == SCAN_ERR_MALFORMED)
+    {
+        PyErr_Format(PyExc_ValueError, "Block %zu is truncated or corrupt", bad);
+        return NULL;
+    }
+    if (status != SCAN_OK)
+        return ScanStatus_SetError(status, bad);
+    if (!has_block)
+        return NULL;
+
+    PyBlockObject *obj = PyObject_New(PyBlockObject, &PyBlockType);
+    if (!obj)
+    {
+        readahead_block_free(&block);
+        return NULL;
+    }
+    obj->block = block;
+
+    PyObject *offsets;
+    if (block.offsets)
+    {
+        offsets = PyBytes_FromStringAndSize((const char *)block.offsets,
+                                            (Py_ssize_t)(block.count * sizeof(uint64_t)));
+        if (!offsets)
+        {
+            Py_DECREF(obj);
+            return NULL;
+        }
+    }
+    else
+    {
+        Py_INCREF(Py_None);
+        offsets = Py_None;
+    }
+    return Py_BuildValue("(nNN)", (Py_ssize_t)block.index, (PyObject *)obj, offsets);
+}
+
+static PyObject *
+PyReadahead_close(PyReadaheadObject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (self->running)
+    {
+        Py_BEGIN_ALLOW_THREADS
+        readahead_stop(&self->ra);
+        Py_END_ALLOW_THREADS
+        self->running = false;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef PyReadahead_methods[] = {
+    {"close", (PyCFunction)PyReadahead_close, METH_NOARGS, "Stop the I/O thread and drop queued blocks"},
+    {NULL, NULL, 0, NULL}};
+
+static PyTypeObject PyReadaheadType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "py_borsh.Readahead",
+    .tp_basicsize = sizeof(PyReadaheadObject),
+    .tp_dealloc = (destructor)PyReadahead_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Pipelined reader of checksummed block frames",
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc)PyReadahead_next,
+    .tp_methods = PyReadahead_methods,
+    .tp_init = (initproc)PyReadahead_init,
+    .tp_new = PyType_GenericNew,
+};
+
+/* -----------------------------------------------------
+ * Ring Type
+ * ----------------------------------------------------- */
+
+/*
+ * A message ring over shared memory (see ring.h). The memory stays pinned
+ * until close(); payloads are addressed by byte offsets into it, so the
+ * caller slices its own view of the memory.
+ */
+typedef struct
+{
+    PyObject_HEAD
+    Py_buffer mem;
+    bool opened;
+} PyRingObject;
+
+static void
+PyRing_dealloc(PyRingObject *self)
+{
+    if (self->opened)
+    {
+        PyBuffer_Release(&self->mem);
+        self->opened = false;
+    }
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int
+PyRing_init(PyRingObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"mem", "slot_size", "slots", "multi_producer", NULL};
+    PyObject *mem_obj;
+    unsigned int slot_size = 0, n_slots = 0;
+    int multi = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|IIp", kwlist, &mem_obj, &slot_size, &n_slots, &multi))
+        return -1;
+    if (self->opened)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Ring is already open");
+        return -1;
+    }
+    if (PyObject_GetBuffer(mem_obj, &self->mem, PyBUF_WRITABLE) < 0)
+        return -1;
+
+    uint8_t *mem = (uint8_t *)self->mem.buf;
+    size_t size = (size_t)self->mem.len;
+    bool ok;
+    if (slot_size || n_slots)
+        ok = ring_init(mem, size, slot_size, n_slots, multi ? RING_MULTI_PRODUCER : 0);
+    else
+        ok = ring_check(mem, size);
+    if (!ok)
+    {
+        PyBuffer_Release(&self->mem);
+        PyErr_SetString(PyExc_ValueError,
+                        slot_size || n_slots ? "Invalid ring size (slots must be a power of two that fits the memory)"
+                                             : "Memory does not hold a ring");
+        return -1;
+    }
+    self->opened = true;
+    return 0;
+}
+
+static inline uint8_t *
+GetRing(PyRingObject *self)
+{
+    if (!self->opened)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Ring is closed");
+        return NULL;
+    }
+    return (uint8_t *)self->mem.buf;
+}
+
+/*
+ * claim() -> (position, payload offset) | None
+ */
+static PyObject *
+PyRing_claim(PyRingObject *self, PyObject *Py_UNUSED(ignored))
+{
+    uint8_t *mem = GetRing(self);
+    if (!mem)
+        return NULL;
+    uint64_t pos;
+    uint8_t *payload;
+    if (!ring_claim(mem, &pos, &payload))
+        Py_RETURN_NONE;
+    return Py_BuildValue("(Kn)", (unsigned long long)pos, (Py_ssize_t)(payload - mem));
+}
+
+/*
+ * commit(position, length) -> None
+ *
+ * Publishes a claimed slot. A length of None abandons it instead.
+ */
+static PyObject *
+PyRing_commit(PyRingObject *self, PyObject *args)
+{
+    uint8_t *mem = GetRing(self);
+    unsigned long long pos;
+    PyObject *length_obj;
+    if (!mem || !PyArg_ParseTuple(args, "KO", &pos, &length_obj))
+        return NULL;
+
+    uint32_t length = RING_SKIP;
+    if (length_obj != Py_None)
+    {
+        Py_ssize_t n = PyLong_AsSsize_t(length_obj);
+        if (n == -1 && PyErr_Occurred())
+            return NULL;
+        if (n < 0 || (size_t)n > ((const RingHeader *)mem)->slot_size)
+        {
+            PyErr_SetString(PyExc_ValueError, "length does not fit the slot");
+            return NULL;
+        }
+        length = (uint32_t)n;
+    }
+    ring_commit(mem, (uint64_t)pos, length);
+    Py_RETURN_NONE;
+}
+
+/*
+ * put(data) -> bool
+ *
+ * Claims a slot, copies 'data' into it and publishes it in one call. False
+ * when the ring is full.
+ */
+static PyObject *
+PyRing_put(PyRingObject *self, PyObject *arg)
+{
+    uint8_t *mem = GetRing(self);
+    if (!mem)
+        return NULL;
+    Py_buffer data;
+    if (PyObject_GetBuffer(arg, &data, PyBUF_SIMPLE) < 0)
+        return NULL;
+    if ((size_t)data.len > ((const RingHeader *)mem)->slot_size)
+    {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "Message does not fit the slot");
+        return NULL;
+    }
+
+    uint64_t pos;
+    uint8_t *payload;
+    bool claimed = ring_claim(mem, &pos, &payload);
+    if (claimed)
+    {
+        memcpy(payload, data.buf, (size_t)data.len);
+        ring_commit(mem, pos, (uint32_t)data.len);
+    }
+    PyBuffer_Release(&data);
+    return PyBool_FromLong(claimed);
+}
+
+/*
+ * peek() -> (position, payload offset, length) | None
+ */
+static PyObject *
+PyRing_peek(PyRingObject *self, PyObject *Py_UNUSED(ignored))
+{
+    uint8_t *mem = GetRing(self);
+    if (!mem)
+        return NULL;
+    uint64_t pos;
+    const uint8_t *payload;
+    uint32_t len;
+    if (!ring_peek(mem, &pos, &payload, &len))
+        Py_RETURN_NONE;
+    return Py_BuildValue("(KnI)", (unsigned long long)pos, (Py_ssize_t)(payload - mem), len);
+}
+
+static PyObject *
+PyRing_release(PyRingObject *self, PyObject *arg)
+{
+    uint8_t *mem = GetRing(self);
+    if (!mem)
+        return NULL;
+    unsigned long long pos = PyLong_AsUnsignedLongLong(arg);
+    if (pos == (unsigned long long)-1 && PyErr_Occurred())
+        return NULL;
+    ring_release(mem, (uint64_t)pos);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PyRing_close(PyRingObject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (self->opened)
+    {
+        PyBuffer_Release(&self->mem);
+        self->opened = false;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PyRing_get_slot_size(PyRingObject *self, void *closure)
+{
+    uint8_t *mem = GetRing(self);
+    return mem ? PyLong_FromUnsignedLong(((const RingHeader *)mem)->slot_size) : NULL;
+}
+
+static PyObject *
+PyRing_get_slots(PyRingObject *self, void *closure)
+{
+    uint8_t *mem = GetRing(self);
+    return mem ? PyLong_FromUnsignedLong(((const RingHeader *)mem)->n_slots) : NULL;
+}
+
+static PyObject *
+PyRing_get_multi_producer(PyRingObject *self, void *closure)
+{
+    uint8_t *mem = GetRing(self);
+    return mem ? PyBool_FromLong(((const RingHeader *)mem)->flags & RING_MULTI_PRODUCER) : NULL;
+}
+
+static Py_ssize_t
+PyRing_len(PyRingObject *self)
+{
+    uint8_t *mem = GetRing(self);
+    return mem ? (Py_ssize_t)ring_pending(mem) : -1;
+}
+
+static PyMethodDef PyRing_methods[] = {
+    {"claim", (PyCFunction)PyRing_claim, METH_NOARGS, ""},
+    {"commit", (PyCFunction)PyRing_commit, METH_VARARGS, ""},
+    {"put", (PyCFunction)PyRing_put, METH_O, ""},
+    {"peek", (PyCFunction)PyRing_peek, METH_NOARGS, ""},
+    {"release", (PyCFunction)PyRing_release, METH_O, ""},
+    {"close", (PyCFunction)PyRing_close, METH_NOARGS, ""},
+    {NULL, NULL, 0, NULL}};
+
+static PyGetSetDef PyRing_getset[] = {
+    {"slot_size", (getter)PyRing_get_slot_size, NULL, "Payload bytes per slot", NULL},
+    {"slots", (getter)PyRing_get_slots, NULL, "Number of slots", NULL},
+    {"multi_producer", (getter)PyRing_get_multi_producer, NULL, "Whether producers claim slots with CAS", NULL},
+    {NULL, NULL, NULL, NULL, NULL}};
+
+static PySequenceMethods PyRing_as_sequence = {
+    .sq_length = (lenfunc)PyRing_len,
+};
+
+static PyTypeObject PyRingType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "py_borsh.Ring",
+    .tp_basicsize = sizeof(PyRingObject),
+    .tp_dealloc = (destructor)PyRing_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Lock-free message ring over shared memory",
+    .tp_methods = PyRing_methods,
+    .tp_getset = PyRing_getset,
+    .tp_as_sequence = &PyRing_as_sequence,
+    .tp_init = (initproc)PyRing_init,
+    .tp_new = PyType_GenericNew,
+};
+
+/*
+ * ring_bytes(slot_size, slots) -> int
+ */
+static PyObject *
+PyBorsh_ring_bytes(PyObject *self, PyObject *args)
+{
+    unsigned int slot_size, n_slots;
+    if (!PyArg_ParseTuple(args, "II", &slot_size, &n_slots))
+        return NULL;
+    size_t bytes = ring_bytes(slot_size, n_slots);
+    if (bytes == 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "slot_size must be > 0 and slots a power of two");
+        return NULL;
+    }
+    return PyLong_FromSize_t(bytes);
+}
+
+/* -----------------------------------------------------
+ * Dispatch Type
+ * ----------------------------------------------------- */
+
+/*
+ * Decodes payloads that start with a discriminator by the layout registered
+ * for it, found in a hash table keyed by the discriminator. Layouts can be
+ * added after decoding started without rebuilding the table.
+ */
+typedef struct
+{
+    PyObject_HEAD DispatchTable table;
+    bool built;
+    PyObject *layouts; /* list of Layout, by entry */
+    PyObject *tags;    /* list of tags returned with tagged decodes */
+} PyDispatchObject;
+
+static void
+PyDispatch_dealloc(PyDispatchObject *self)
+{
+    if (self->built)
+        dispatch_free(&self->table);
+    Py_CLEAR(self->layouts);
+    Py_CLEAR(self->tags);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+/*
+ * Registers one (discriminator, layout, tag) entry.
+ */
+static int
+dispatch_add_entry(PyDispatchObject *self, PyObject *entry)
+{
+    const char *prefix;
+    Py_ssize_t prefix_len;
+    PyObject *layout, *tag;
+    if (!PyArg_ParseTuple(entry, "y#O!O", &prefix, &prefix_len, &PyLayoutType, &layout, &tag))
+        return -1;
+    if ((size_t)prefix_len != self->table.width || !GetLayout(layout))
+    {
+        if (!PyErr_Occurred())
+            PyErr_Format(PyExc_ValueError, "Discriminator of %zd bytes, expected %zu", prefix_len, self->table.width);
+        return -1;
+    }
+
+    Py_ssize_t index = PyList_GET_SIZE(self->layouts);
+    if (PyList_Append(self->layouts, layout) < 0)
+        return -1;
+    if (PyList_Append(self->tags, tag) < 0)
+        goto undo;
+    switch (dispatch_insert(&self->table, dispatch_key((const uint8_t *)prefix, self->table.width), (size_t)index))
+    {
+    case 1:
+        return 0;
+    case 0:
+        PyErr_SetString(PyExc_ValueError, "Duplicate discriminator");
+        break;
+    default:
+        PyErr_NoMemory();
+    }
+    PyList_SetSlice(self->tags, index, PY_SSIZE_T_MAX, NULL);
+undo:
+    PyList_SetSlice(self->layouts, index, PY_SSIZE_T_MAX, NULL);
+    return -1;
+}
+
+/*
+ * Dispatch(width, entries): 'entries' is a sequence of (discriminator,
+ * layout, tag) with distinct discriminators of 'width' (1 to 8) bytes.
+ */
+static int
+PyDispatch_init(PyDispatchObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"width", "entries", NULL};
+    Py_ssize_t width;
+    PyObject *entries_obj;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "nO", kwlist, &width, &entries_obj))
+        return -1;
+    if (self->built)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Dispatch is already built");
+        return -1;
+    }
+    if (width < 1 || width > 8)
+    {
+        PyErr_SetString(PyExc_ValueError, "Discriminators are 1 to 8 bytes");
+        return -1;
+    }
+    PyObject *entries = PySequence_Fast(entries_obj, "entries must be a sequence");
+    if (!entries)
+        return -1;
+
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(entries);
+    self->layouts = PyList_New(0);
+    self->tags = PyList_New(0);
+    if (!self->layouts || !self->tags)
+        goto fail;
+    if (!dispatch_init(&self->table, (size_t)width, (size_t)n))
+    {
+        PyErr_NoMemory();
+        goto fail;
+    }
+    self->built = true;
+    for (Py_ssize_t i = 0; i < n; i++)
+    {
+        if (dispatch_add_entry(self, PySequence_Fast_GET_ITEM(entries, i)) < 0)
+            goto fail;
+    }
+    Py_DECREF(entries);
+    return 0;
+
+fail:
+    if (self->built)
+        dispatch_free(&self->table);
+    self->built = false;
+    Py_CLEAR(self->layouts);
+    Py_CLEAR(self->tags);
+    Py_DECREF(entries);
+    return -1;
+}
+
+/*
+ * Decodes one payload. Raises KeyError for an unknown discriminator.
+ */
+static PyObject *
+dispatch_decode(PyDispatchObject *self, PyObject *data, bool tagged)
+{
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    const uint8_t *bytes = (const uint8_t *)view.buf;
+    size_t width = self->table.width;
+    size_t entry = DISPATCH_EMPTY;
+    if ((size_t)view.len >= width)
+        entry = dispatch_find(&self->table, dispatch_key(bytes, width));
+    if (entry == DISPATCH_EMPTY)
+    {
+        PyObject *prefix = PyBytes_FromStringAndSize((const char *)bytes, (Py_ssize_t)width < view.len ? (Py_ssize_t)width : view.len);
+        if (prefix)
+        {
+            PyErr_SetObject(PyExc_KeyError, prefix);
+            Py_DECREF(prefix);
+        }
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    Buffer b;
+    init_buffer_view(&b, bytes + width, (size_t)view.len - width);
+    LayoutReader reader = {data, bytes, NULL};
+    PyObject *value = layout_read_value(((PyLayoutObject *)PyList_GET_ITEM(self->layouts, entry))->root, &b, &reader);
+    Py_XDECREF(reader.memory);
+    PyBuffer_Release(&view);
+    if (!value || !tagged)
+        return value;
+
+    PyObject *result = PyTuple_Pack(2, PyList_GET_ITEM(self->tags, entry), value);
+    Py_DECREF(value);
+    return result;
+}
+
+static inline bool
+GetDispatch(PyDispatchObject *self)
+{
+    if (!self->built)
+        PyErr_SetString(PyExc_RuntimeError, "Dispatch is not built");
+    return self->built;
+}
+
+/*
+ * decode(data, tagged=False) -> value, or (tag, value) when tagged
+ */
+static PyObject *
+PyDispatch_decode(PyDispatchObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"data", "tagged", NULL};
+    PyObject *data;
+    int tagged = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p", kwlist, &data, &tagged) || !GetDispatch(self))
+        return NULL;
+    return dispatch_decode(self, data, tagged);
+}
+
+/*
+ * decode_many(records, tagged=False) -> list
+ */
+static PyObject *
+PyDispatch_decode_many(PyDispatchObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"records", "tagged", NULL};
+    PyObject *records;
+    int tagged = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p", kwlist, &records, &tagged) || !GetDispatch(self))
+        return NULL;
+
+    PyObject *seq = PySequence_Fast(records, "records must be a sequence of bytes-like objects");
+    if (!seq)
+        return NULL;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    PyObject *result = PyList_New(n);
+    for (Py_ssize_t i = 0; result && i < n; i++)
+    {
+        PyObject *value = dispatch_decode(self, PySequence_Fast_GET_ITEM(seq, i), tagged);
+        if (!value)
+            Py_CLEAR(result);
+        else
+            PyList_SET_ITEM(result, i, value);
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+/*
+ * add(discriminator, layout, tag) -> None
+ */
+static PyObject *
+PyDispatch_add(PyDispatchObject *self, PyObject *args)
+{
+    if (!GetDispatch(self) || dispatch_add_entry(self, args) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+/*
+ * find(data) -> tag or None
+ */
+static PyObject *
+PyDispatch_find(PyDispatchObject *self, PyObject *data)
+{
+    if (!GetDispatch(self))
+        return NULL;
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+    size_t entry = DISPATCH_EMPTY;
+    if ((size_t)view.len >= self->table.width)
+        entry = dispatch_find(&self->table, dispatch_key((const uint8_t *)view.buf, self->table.width));
+    PyBuffer_Release(&view);
+    if (entry == DISPATCH_EMPTY)
+        Py_RETURN_NONE;
+    return Py_NewRef(PyList_GET_ITEM(self->tags, entry));
+}
+
+static PyMethodDef PyDispatch_methods[] = {
+    {"decode", (PyCFunction)PyDispatch_decode, METH_VARARGS | METH_KEYWORDS, ""},
+    {"decode_many", (PyCFunction)PyDispatch_decode_many, METH_VARARGS | METH_KEYWORDS, ""},
+    {"find", (PyCFunction)PyDispatch_find, METH_O, ""},
+    {"add", (PyCFunction)PyDispatch_add, METH_VARARGS, ""},
+    {NULL, NULL, 0, NULL}};
+
+static PyTypeObject PyDispatchType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "py_borsh.Dispatch",
+    .tp_basicsize = sizeof(PyDispatchObject),
+    .tp_dealloc = (destructor)PyDispatch_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Discriminator-dispatched decoding over a hash table",
+    .tp_methods = PyDispatch_methods,
+    .tp_init = (initproc)PyDispatch_init,
+    .tp_new = PyType_GenericNew,
+};
+
+/* -----------------------------------------------------
+ * Module-level method table
+ * ----------------------------------------------------- */
+
+/*
+ * set_validation( bool ) -> None
  *
  * Enable or disable numeric range checks at runtime.
  *  - True => enforce checks (default)
@@ -1748,6 +6125,56 @@ static PyMethodDef module_methods[] = {
      "  import py_borsh\n"
      "  py_borsh.set_validation(True)   # enable checks\n"
      "  py_borsh.set_validation(False)  # disable checks\n"},
+    {"clear_interned", PyBorsh_clear_interned, METH_NOARGS,
+     "Drop every cached object from the intern tables.\n\n"
+     "Usage:\n"
+     "  py_borsh.clear_interned()\n"},
+    {"set_lazy_pubkeys", PyBorsh_set_lazy_pubkeys, METH_VARARGS,
+     "Decode PubKey values to PublicKey objects (True) or base58 str (False).\n\n"
+     "Usage:\n"
+     "  py_borsh.set_lazy_pubkeys(True)\n"},
+    {"scan", (PyCFunction)PyBorsh_scan, METH_VARARGS | METH_KEYWORDS,
+     "Aggregate fields over encoded records in parallel, without decoding them.\n\n"
+     "Usage:\n"
+     "  py_borsh.scan(layout, records, filters, aggregates, workers=1)\n"},
+    {"aggregate", (PyCFunction)PyBorsh_aggregate, METH_VARARGS | METH_KEYWORDS,
+     "Aggregate one field over encoded records, optionally grouped by another.\n\n"
+     "Usage:\n"
+     "  py_borsh.aggregate(layout, records, op, field=None, group_by=None,\n"
+     "                     bins=None, filters=(), workers=1)\n"},
+    {"sort", (PyCFunction)PyBorsh_sort, METH_VARARGS | METH_KEYWORDS,
+     "Sort encoded records by a field, returning the reordered records or the\n"
+     "permutation as native uint64 values.\n\n"
+     "Usage:\n"
+     "  py_borsh.sort(layout, records, key, reverse=False, permutation=False, workers=1)\n"},
+    {"merge_sorted", (PyCFunction)PyBorsh_merge_sorted, METH_VARARGS | METH_KEYWORDS,
+     "Merge runs of records sorted by the same key into a file descriptor.\n\n"
+     "Usage:\n"
+     "  py_borsh.merge_sorted(layout, runs, key, fd, reverse=False)\n"},
+    {"split_records", PyBorsh_split_records, METH_VARARGS,
+     "Split back-to-back records into chunks of at most max_bytes.\n\n"
+     "Usage:\n"
+     "  py_borsh.split_records(layout, data, max_bytes)\n"},
+    {"build_index", (PyCFunction)PyBorsh_build_index, METH_VARARGS | METH_KEYWORDS,
+     "Build a hash index of a field over back-to-back records.\n\n"
+     "Usage:\n"
+     "  py_borsh.build_index(layout, records, key, workers=1)\n"},
+    {"crc32c", PyBorsh_crc32c, METH_VARARGS,
+     "CRC-32C (Castagnoli) of a bytes-like object.\n\n"
+     "Usage:\n"
+     "  py_borsh.crc32c(data, value=0)\n"},
+    {"frame_span", PyBorsh_frame_span, METH_VARARGS,
+     "Check one length-prefixed, checksummed frame and locate its payload.\n\n"
+     "Usage:\n"
+     "  py_borsh.frame_span(data, offset, verify=True)\n"},
+    {"scan_frames", PyBorsh_scan_frames, METH_VARARGS,
+     "Find the offsets of consecutive frames, stopping at a torn tail.\n\n"
+     "Usage:\n"
+     "  py_borsh.scan_frames(data, start, verify=True)\n"},
+    {"ring_bytes", PyBorsh_ring_bytes, METH_VARARGS,
+     "Size of the shared memory needed by a Ring.\n\n"
+     "Usage:\n"
+     "  py_borsh.ring_bytes(slot_size, slots)\n"},
     {NULL, NULL, 0, NULL}};
 
 /* -----------------------------------------------------
@@ -1766,10 +6193,39 @@ PyInit_py_borsh(void)
 {
     PyObject *m;
 
+    crc32c_init();
     if (PyType_Ready(&PyBufferType) < 0)
     {
         return NULL;
     }
+    if (PyType_Ready(&PyLayoutType) < 0)
+    {
+        return NULL;
+    }
+    if (PyType_Ready(&PyIndexType) < 0)
+    {
+        return NULL;
+    }
+    if (PyType_Ready(&PyBlockType) < 0)
+    {
+        return NULL;
+    }
+    if (PyType_Ready(&PyReadaheadType) < 0)
+    {
+        return NULL;
+    }
+    if (PyType_Ready(&PyRingType) < 0)
+    {
+        return NULL;
+    }
+    if (PyType_Ready(&PyPublicKeyType) < 0)
+    {
+        return NULL;
+    }
+    if (PyType_Ready(&PyDispatchType) < 0)
+    {
+        return NULL;
+    }
     m = PyModule_Create(&moduledef);
     if (!m)
     {
@@ -1782,5 +6238,47 @@ PyInit_py_borsh(void)
         Py_DECREF(m);
         return NULL;
     }
+    Py_INCREF(&PyLayoutType);
+    if (PyModule_AddObject(m, "Layout", (PyObject *)&PyLayoutType) < 0)
+    {
+        Py_DECREF(&PyLayoutType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(&PyIndexType);
+    if (PyModule_AddObject(m, "Index", (PyObject *)&PyIndexType) < 0)
+    {
+        Py_DECREF(&PyIndexType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(&PyReadaheadType);
+    if (PyModule_AddObject(m, "Readahead", (PyObject *)&PyReadaheadType) < 0)
+    {
+        Py_DECREF(&PyReadaheadType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(&PyRingType);
+    if (PyModule_AddObject(m, "Ring", (PyObject *)&PyRingType) < 0)
+    {
+        Py_DECREF(&PyRingType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(&PyPublicKeyType);
+    if (PyModule_AddObject(m, "PublicKey", (PyObject *)&PyPublicKeyType) < 0)
+    {
+        Py_DECREF(&PyPublicKeyType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(&PyDispatchType);
+    if (PyModule_AddObject(m, "Dispatch", (PyObject *)&PyDispatchType) < 0)
+    {
+        Py_DECREF(&PyDispatchType);
+        Py_DECREF(m);
+        return NULL;
+    }
     return m;
 }
@@ -1,6 +1,103 @@
-from typing import Dict, Optional, Set
+from typing import Any, Dict, List, Optional, Sequence, Set, Tuple
 
 def set_validation(validate: bool) -> None: ...
+def set_lazy_pubkeys(enable: bool) -> None: ...
+def clear_interned() -> None: ...
+def scan(
+    layout: Layout,
+    records: Any,
+    filters: Sequence[Tuple[Sequence[int], str, Any]],
+    aggregates: Sequence[Tuple[str, Optional[Sequence[int]]]],
+    workers: int = 1,
+) -> List[Any]: ...
+
+def aggregate(
+    layout: Layout,
+    records: Any,
+    op: str,
+    field: Optional[Sequence[int]] = None,
+    group_by: Optional[Sequence[int]] = None,
+    bins: Optional[Sequence[Any]] = None,
+    filters: Sequence[Tuple[Sequence[int], str, Any]] = (),
+    workers: int = 1,
+) -> Any: ...
+
+def sort(
+    layout: Layout,
+    records: Any,
+    key: Sequence[int],
+    reverse: bool = False,
+    permutation: bool = False,
+    workers: int = 1,
+) -> bytes: ...
+def merge_sorted(
+    layout: Layout,
+    runs: Sequence[Any],
+    key: Sequence[int],
+    fd: int,
+    reverse: bool = False,
+) -> None: ...
+def split_records(layout: Layout, data: Any, max_bytes: int) -> List[int]: ...
+
+def build_index(layout: Layout, records: Any, key: Sequence[int], workers: int = 1) -> bytes: ...
+
+def crc32c(data: Any, value: int = 0) -> int: ...
+def frame_span(data: Any, offset: int, verify: bool = True) -> Tuple[int, int]: ...
+def scan_frames(data: Any, start: int, verify: bool = True) -> Tuple[bytes, int]: ...
+
+class Index:
+    def __init__(self, layout: Layout, index: Any, records: Any) -> None: ...
+    def find(self, key: Any) -> Optional[Tuple[int, int]]: ...
+    def find_all(self, key: Any) -> List[Tuple[int, int]]: ...
+    def __len__(self) -> int: ...
+    @property
+    def path(self) -> Tuple[int, ...]: ...
+
+class Readahead:
+    def __init__(self, fd: int, bounds: Any, depth: int = 4, verify: bool = True, inflate: bool = False) -> None: ...
+    def __iter__(self) -> "Readahead": ...
+    def __next__(self) -> Tuple[int, Any, Optional[bytes]]: ...
+    def close(self) -> None: ...
+
+def ring_bytes(slot_size: int, slots: int) -> int: ...
+
+class Ring:
+    def __init__(self, mem: Any, slot_size: int = 0, slots: int = 0, multi_producer: bool = False) -> None: ...
+    def claim(self) -> Optional[Tuple[int, int]]: ...
+    def commit(self, position: int, length: Optional[int]) -> None: ...
+    def put(self, data: Any) -> bool: ...
+    def peek(self) -> Optional[Tuple[int, int, int]]: ...
+    def release(self, position: int) -> None: ...
+    def close(self) -> None: ...
+    def __len__(self) -> int: ...
+    @property
+    def slot_size(self) -> int: ...
+    @property
+    def slots(self) -> int: ...
+    @property
+    def multi_producer(self) -> bool: ...
+
+class Dispatch:
+    def __init__(self, width: int, entries: Sequence[Tuple[bytes, Layout, Any]]) -> None: ...
+    def decode(self, data: Any, tagged: bool = False) -> Any: ...
+    def decode_many(self, records: Sequence[Any], tagged: bool = False) -> List[Any]: ...
+    def find(self, data: Any) -> Any: ...
+    def add(self, discriminator: bytes, layout: Layout, tag: Any) -> None: ...
+
+class PublicKey:
+    def __new__(cls, value: bytes | str | PublicKey) -> PublicKey: ...
+    def __bytes__(self) -> bytes: ...
+    def __hash__(self) -> int: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __lt__(self, other: PublicKey) -> bool: ...
+
+class Layout:
+    def __init__(self, spec: tuple) -> None: ...
+    @property
+    def size(self) -> Optional[int]: ...
+    def read(self, buffer: Buffer) -> Any: ...
+    def read_all(self, data: Any) -> List[Any]: ...
+    def write(self, buffer: Buffer, value: Any) -> None: ...
 
 class Buffer:
     def __init__(self, capacity: int) -> None: ...
@@ -11,10 +108,18 @@ class Buffer:
     @property
     def offset(self) -> int: ...
     @property
+    def error(self) -> bool: ...
+    @property
     def data(self) -> memoryview: ...
     def free(self) -> None: ...
     def reset(self) -> None: ...
     def reset_offset(self) -> None: ...
+    def attach(self, data: Any, writable: bool = False) -> None: ...
+    def detach(self) -> None: ...
+    def read_from(self, fd: int, offset: int, length: int) -> int: ...
+    def reserve(self, size: int) -> None: ...
+    def read_base64(self, text: str | bytes) -> int: ...
+    def read_base58(self, text: str | bytes) -> int: ...
 
     # --- Write Methods ---
     def write_u8(self, val: int) -> None: ...
@@ -30,6 +135,10 @@ class Buffer:
     def write_f32(self, val: float) -> None: ...
     def write_f64(self, val: float) -> None: ...
     def write_bool(self, val: bool) -> None: ...
+    def write_short_u16(self, value: int) -> None: ...
+    def write_pubkey(self, value: bytes | str | PublicKey) -> None: ...
+    def write_var_u64(self, value: int) -> None: ...
+    def write_var_i64(self, value: int) -> None: ...
     def write_fixed_array(self, data: bytes) -> None: ...
     def write_vec(self, data: bytes) -> None: ...
     def write_option(self, data: Optional[bytes]) -> None: ...
@@ -51,9 +160,13 @@ class Buffer:
     def read_f32(self) -> float: ...
     def read_f64(self) -> float: ...
     def read_bool(self) -> bool: ...
+    def read_short_u16(self) -> int: ...
+    def read_pubkey(self) -> str | PublicKey: ...
+    def read_var_u64(self) -> int: ...
+    def read_var_i64(self) -> int: ...
     def read_fixed_array(self, length: int) -> bytes: ...
     def read_vec(self) -> bytes: ...
-    def read_option(self) -> Optional[bytes]: ...
+    def read_option(self, length: int) -> Optional[bytes]: ...
     def read_enum_variant(self) -> int: ...
     def read_enum_data(self, length: int) -> bytes: ...
     def read_hashmap(self) -> Dict[bytes, bytes]: ...
@@ -0,0 +1,325 @@
+#include "readahead.h"
+#include "crc32c.h"
+#include "frames.h"
+#include <errno.h>  // for errno, EINTR
+#include <limits.h> // for UINT_MAX
+#include <stdlib.h> // for malloc, realloc, calloc, free
+#include <string.h> // for memcpy, memset
+#include <unistd.h> // for pread, dup, close
+#include <zlib.h>   // for inflate
+
+static inline uint32_t load_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* -----------------------------------------------------
+ * Loading One Block
+ * ----------------------------------------------------- */
+
+/*
+ * Reads exactly 'size' bytes at 'offset'. A short file is a truncated
+ * block, reported as SCAN_ERR_MALFORMED.
+ */
+static ScanStatus pread_all(int fd, uint8_t *data, size_t size, uint64_t offset)
+{
+    while (size > 0)
+    {
+        ssize_t got = pread(fd, data, size, (off_t)offset);
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return SCAN_ERR_IO;
+        }
+        if (got == 0)
+            return SCAN_ERR_MALFORMED;
+        data += got;
+        size -= (size_t)got;
+        offset += (uint64_t)got;
+    }
+    return SCAN_OK;
+}
+
+/*
+ * Inflates a zlib stream into a fresh buffer, growing it as needed.
+ */
+static ScanStatus inflate_all(const uint8_t *in, size_t in_len, uint8_t **out, size_t *out_len)
+{
+    if (in_len > UINT_MAX)
+        return SCAN_ERR_MALFORMED;
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit(&stream) != Z_OK)
+        return SCAN_ERR_NOMEM;
+
+    size_t capacity = in_len * 4 + 256;
+    uint8_t *data = (uint8_t *)malloc(capacity);
+    ScanStatus status = data ? SCAN_OK : SCAN_ERR_NOMEM;
+    stream.next_in = (Bytef *)in;
+    stream.avail_in = (uInt)in_len;
+
+    while (status == SCAN_OK)
+    {
+        size_t used = (size_t)stream.total_out;
+        if (used == capacity)
+        {
+            uint8_t *grown = (uint8_t *)realloc(data, capacity * 2);
+            if (!grown)
+            {
+                status = SCAN_ERR_NOMEM;
+                break;
+            }
+            data = grown;
+            capacity *= 2;
+        }
+        size_t room = capacity - used;
+        stream.next_out = data + used;
+        stream.avail_out = room > UINT_MAX ? UINT_MAX : (uInt)room;
+
+        int rc = inflate(&stream, Z_NO_FLUSH);
+        if (rc == Z_STREAM_END)
+            break;
+        if (rc == Z_MEM_ERROR)
+            status = SCAN_ERR_NOMEM;
+        else if (rc != Z_OK && !(rc == Z_BUF_ERROR && stream.avail_out == 0))
+            status = SCAN_ERR_MALFORMED;
+    }
+    if (status == SCAN_OK && stream.avail_in != 0)
+        status = SCAN_ERR_MALFORMED;
+
+    *out_len = (size_t)stream.total_out;
+    inflateEnd(&stream);
+    if (status != SCAN_OK)
+    {
+        free(data);
+        return status;
+    }
+    *out = data;
+    return SCAN_OK;
+}
+
+/*
+ * Reads block 'b': its frame must span exactly [bounds[b], bounds[b + 1]).
+ */
+static ScanStatus load_block(const Readahead *ra, size_t b, ReadaheadBlock *block)
+{
+    memset(block, 0, sizeof(ReadaheadBlock));
+    block->index = b;
+
+    uint64_t begin = ra->bounds[b], end = ra->bounds[b + 1];
+    uint8_t header[FRAME_HEADER];
+    if (end < begin || end - begin < FRAME_HEADER)
+        return SCAN_ERR_MALFORMED;
+    ScanStatus status = pread_all(ra->fd, header, FRAME_HEADER, begin);
+    if (status != SCAN_OK)
+        return status;
+
+    uint32_t len = load_u32(header), crc = load_u32(header + 4);
+    if ((uint64_t)len != end - begin - FRAME_HEADER)
+        return SCAN_ERR_MALFORMED;
+
+    uint8_t *payload = (uint8_t *)malloc(len ? len : 1);
+    if (!payload)
+        return SCAN_ERR_NOMEM;
+    status = pread_all(ra->fd, payload, len, begin + FRAME_HEADER);
+    if (status == SCAN_OK && ra->verify && crc32c(0, payload, len) != crc)
+        status = SCAN_ERR_MALFORMED;
+    if (status != SCAN_OK)
+    {
+        free(payload);
+        return status;
+    }
+
+    if (!ra->inflate)
+    {
+        block->data = payload;
+        block->len = len;
+        return SCAN_OK;
+    }
+
+    status = inflate_all(payload, len, &block->data, &block->len);
+    free(payload);
+    if (status != SCAN_OK)
+        return status;
+
+    // Every byte of the block must belong to an intact record frame
+    size_t tail = frames_scan(block->data, block->len, 0, ra->verify, &block->offsets, &block->count);
+    if (tail == SIZE_MAX)
+        status = SCAN_ERR_NOMEM;
+    else if (tail != block->len)
+        status = SCAN_ERR_MALFORMED;
+    if (status != SCAN_OK)
+        readahead_block_free(block);
+    return status;
+}
+
+void readahead_block_free(ReadaheadBlock *block)
+{
+    free(block->data);
+    free(block->offsets);
+    block->data = NULL;
+    block->offsets = NULL;
+}
+
+/* -----------------------------------------------------
+ * I/O Thread
+ * ----------------------------------------------------- */
+
+static void *readahead_main(void *arg)
+{
+    Readahead *ra = (Readahead *)arg;
+
+    for (size_t b = 0; b < ra->n_blocks; b++)
+    {
+        // Wait for a free slot first, so at most 'depth' blocks are in memory
+        pthread_mutex_lock(&ra->lock);
+        while (!ra->stop && ra->count == ra->depth)
+            pthread_cond_wait(&ra->space, &ra->lock);
+        bool stop = ra->stop;
+        pthread_mutex_unlock(&ra->lock);
+        if (stop)
+            return NULL;
+
+        ReadaheadBlock block;
+        ScanStatus status = load_block(ra, b, &block);
+        int error = errno;
+
+        pthread_mutex_lock(&ra->lock);
+        if (status != SCAN_OK)
+        {
+            ra->status = status;
+            ra->bad = b;
+            ra->error = error;
+            ra->done = true;
+            pthread_cond_signal(&ra->ready);
+            pthread_mutex_unlock(&ra->lock);
+            return NULL;
+        }
+        ra->queue[(ra->head + ra->count) % ra->depth] = block;
+        ra->count++;
+        pthread_cond_signal(&ra->ready);
+        pthread_mutex_unlock(&ra->lock);
+    }
+
+    pthread_mutex_lock(&ra->lock);
+    ra->done = true;
+    pthread_cond_signal(&ra->ready);
+    pthread_mutex_unlock(&ra->lock);
+    return NULL;
+}
+
+/* -----------------------------------------------------
+ * Consumer
+ * ----------------------------------------------------- */
+
+ScanStatus readahead_start(Readahead *ra, int fd, const uint64_t *bounds,
+                           size_t n_blocks, size_t depth, bool verify, bool inflate)
+{
+    memset(ra, 0, sizeof(Readahead));
+    ra->fd = -1;
+    ra->n_blocks = n_blocks;
+    ra->depth = depth ? depth : 1;
+    ra->verify = verify;
+    ra->inflate = inflate;
+    ra->status = SCAN_OK;
+
+    ra->bounds = (uint64_t *)malloc((n_blocks + 1) * sizeof(uint64_t));
+    ra->queue = (ReadaheadBlock *)calloc(ra->depth, sizeof(ReadaheadBlock));
+    if (!ra->bounds || !ra->queue)
+    {
+        free(ra->bounds);
+        free(ra->queue);
+        ra->bounds = NULL;
+        ra->queue = NULL;
+        errno = ENOMEM;
+        return SCAN_ERR_NOMEM;
+    }
+    memcpy(ra->bounds, bounds, (n_blocks + 1) * sizeof(uint64_t));
+
+    ra->fd = dup(fd);
+    if (ra->fd < 0)
+    {
+        free(ra->bounds);
+        free(ra->queue);
+        ra->bounds = NULL;
+        ra->queue = NULL;
+        return SCAN_ERR_IO;
+    }
+
+    pthread_mutex_init(&ra->lock, NULL);
+    pthread_cond_init(&ra->ready, NULL);
+    pthread_cond_init(&ra->space, NULL);
+    int rc = pthread_create(&ra->thread, NULL, readahead_main, ra);
+    if (rc != 0)
+    {
+        readahead_stop(ra);
+        errno = rc;
+        return SCAN_ERR_IO;
+    }
+    ra->started = true;
+    return SCAN_OK;
+}
+
+ScanStatus readahead_next(Readahead *ra, ReadaheadBlock *block, bool *has_block, size_t *bad)
+{
+    *has_block = false;
+    *bad = SIZE_MAX;
+
+    pthread_mutex_lock(&ra->lock);
+    while (ra->count == 0 && !ra->done)
+        pthread_cond_wait(&ra->ready, &ra->lock);
+
+    ScanStatus status = SCAN_OK;
+    if (ra->count > 0)
+    {
+        *block = ra->queue[ra->head];
+        memset(&ra->queue[ra->head], 0, sizeof(ReadaheadBlock));
+        ra->head = (ra->head + 1) % ra->depth;
+        ra->count--;
+        *has_block = true;
+        pthread_cond_signal(&ra->space);
+    }
+    else if (ra->status != SCAN_OK)
+    {
+        // Report the failure once every good block before it was consumed
+        status = ra->status;
+        *bad = ra->bad;
+        errno = ra->error;
+    }
+    pthread_mutex_unlock(&ra->lock);
+    return status;
+}
+
+void readahead_stop(Readahead *ra)
+{
+    if (!ra->queue)
+        return;
+
+    if (ra->started)
+    {
+        pthread_mutex_lock(&ra->lock);
+        ra->stop = true;
+        pthread_cond_signal(&ra->space);
+        pthread_mutex_unlock(&ra->lock);
+        pthread_join(ra->thread, NULL);
+        ra->started = false;
+    }
+    pthread_mutex_destroy(&ra->lock);
+    pthread_cond_destroy(&ra->ready);
+    pthread_cond_destroy(&ra->space);
+
+    for (size_t i = 0; i < ra->count; i++)
+    {
+        readahead_block_free(&ra->queue[(ra->head + i) % ra->depth]);
+    }
+    if (ra->fd >= 0)
+        close(ra->fd);
+    free(ra->queue);
+    free(ra->bounds);
+    ra->queue = NULL;
+    ra->bounds = NULL;
+    ra->count = 0;
+    ra->fd = -1;
+}
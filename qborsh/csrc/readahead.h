@@ -0,0 +1,81 @@
+#ifndef READAHEAD_H
+#define READAHEAD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <pthread.h> // for pthread_t, pthread_mutex_t, pthread_cond_t
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint8_t, uint64_t
+#include <stddef.h>  // for size_t
+#include "scan.h"    // for ScanStatus
+
+    /*
+     * One block handed from the I/O thread to the reader. 'data' holds the
+     * frame payload (inflated when the reader asked for it) and 'offsets' the
+     * record frames found inside it. Both are malloc'ed and owned by the
+     * receiver.
+     */
+    typedef struct
+    {
+        size_t index;
+        uint8_t *data;
+        size_t len;
+        uint64_t *offsets; /* NULL unless inflated */
+        size_t count;
+    } ReadaheadBlock;
+
+    /*
+     * Pipelined reader of consecutive block frames. A background thread
+     * preads, checks, and optionally inflates (zlib) the blocks in order,
+     * keeping at most 'depth' of them queued ahead of the consumer.
+     */
+    typedef struct
+    {
+        int fd;
+        uint64_t *bounds; /* n_blocks + 1 frame offsets, the last one the end */
+        size_t n_blocks;
+        bool verify;
+        bool inflate;
+
+        ReadaheadBlock *queue; /* ring of 'depth' slots */
+        size_t depth, head, count;
+        bool done, stop, started;
+        ScanStatus status; /* of the block after the last queued one */
+        size_t bad;
+        int error;
+
+        pthread_mutex_t lock;
+        pthread_cond_t ready, space;
+        pthread_t thread;
+    } Readahead;
+
+    /*
+     * Starts reading blocks [bounds[i], bounds[i + 1]) of 'fd' (which is
+     * duplicated, so the caller may close it). Returns SCAN_OK, or
+     * SCAN_ERR_NOMEM / SCAN_ERR_IO with errno set.
+     */
+    ScanStatus readahead_start(Readahead *ra, int fd, const uint64_t *bounds,
+                               size_t n_blocks, size_t depth, bool verify, bool inflate);
+
+    /*
+     * Waits for the next block. Returns SCAN_OK with '*has_block' set (false
+     * once all blocks were delivered), or the error that stopped the thread
+     * with the failing block in '*bad' (and errno set for SCAN_ERR_IO).
+     */
+    ScanStatus readahead_next(Readahead *ra, ReadaheadBlock *block, bool *has_block, size_t *bad);
+
+    /*
+     * Stops the thread and frees every queued block.
+     */
+    void readahead_stop(Readahead *ra);
+
+    void readahead_block_free(ReadaheadBlock *block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* READAHEAD_H */
@@ -0,0 +1,69 @@
+#include "records.h"
+#include <stdlib.h> // for malloc, realloc, free
+#include <string.h> // for memset
+
+bool records_frame(RecordSet *rs, const LayoutNode *layout,
+                   const uint8_t *data, size_t size, size_t *bad_record)
+{
+    memset(rs, 0, sizeof(RecordSet));
+    rs->base = data;
+
+    if (layout->size != LAYOUT_VARIABLE)
+    {
+        if (layout->size == 0 || size % layout->size != 0)
+        {
+            *bad_record = layout->size ? size / layout->size : 0;
+            return false;
+        }
+        rs->stride = layout->size;
+        rs->count = size / layout->size;
+        return true;
+    }
+
+    size_t capacity = 1024;
+    size_t *offsets = (size_t *)malloc(capacity * sizeof(size_t));
+    if (!offsets)
+    {
+        *bad_record = 0;
+        return false;
+    }
+
+    Buffer view;
+    init_buffer_view(&view, data, size);
+    size_t count = 0;
+    offsets[0] = 0;
+    while (view.offset < size)
+    {
+        if (!layout_skip(layout, &view))
+        {
+            free(offsets);
+            *bad_record = count;
+            return false;
+        }
+        if (count + 2 > capacity)
+        {
+            capacity = capacity * 3 / 2;
+            size_t *grown = (size_t *)realloc(offsets, capacity * sizeof(size_t));
+            if (!grown)
+            {
+                free(offsets);
+                *bad_record = count;
+                return false;
+            }
+            offsets = grown;
+        }
+        offsets[++count] = view.offset;
+    }
+
+    rs->offsets = offsets;
+    rs->count = count;
+    return true;
+}
+
+void records_clear(RecordSet *rs)
+{
+    free(rs->offsets);
+    free(rs->ptrs);
+    free(rs->lens);
+    memset(rs, 0, sizeof(RecordSet));
+}
@@ -0,0 +1,69 @@
+#ifndef RECORDS_H
+#define RECORDS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint8_t
+#include <stddef.h>  // for size_t
+#include "layout.h"
+
+    /*
+     * A read-only set of encoded records, addressed by record number.
+     *
+     * Records live either back to back in one block ('base', with a fixed
+     * 'stride' or 'offsets' of count + 1 entries) or anywhere in memory
+     * ('ptrs' and 'lens', one entry per record).
+     */
+    typedef struct
+    {
+        const uint8_t *base;
+        size_t stride;
+        size_t *offsets;
+        const uint8_t **ptrs;
+        size_t *lens;
+        size_t count;
+    } RecordSet;
+
+    static inline void record_get(const RecordSet *rs, size_t i,
+                                  const uint8_t **data, size_t *len)
+    {
+        if (rs->ptrs)
+        {
+            *data = rs->ptrs[i];
+            *len = rs->lens[i];
+        }
+        else if (rs->offsets)
+        {
+            *data = rs->base + rs->offsets[i];
+            *len = rs->offsets[i + 1] - rs->offsets[i];
+        }
+        else
+        {
+            *data = rs->base + rs->stride * i;
+            *len = rs->stride;
+        }
+    }
+
+    /*
+     * Frames 'size' bytes of back-to-back records of 'layout'. Fixed-size
+     * layouts only need a stride; variable ones are walked once to find each
+     * record boundary. On malformed data, returns false and stores the index
+     * of the offending record in 'bad_record'.
+     */
+    bool records_frame(RecordSet *rs, const LayoutNode *layout,
+                       const uint8_t *data, size_t size, size_t *bad_record);
+
+    /*
+     * Frees the arrays owned by 'rs' (never the record bytes themselves).
+     */
+    void records_clear(RecordSet *rs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RECORDS_H */
@@ -0,0 +1,142 @@
+#include "ring.h"
+#include <string.h> // for memcmp, memcpy, memset
+
+/*
+ * Slots start on a cache line and are padded to whole cache lines, so two
+ * processes working on neighbouring slots do not share one.
+ */
+#define RING_LINE 64
+
+static inline size_t slot_stride(uint32_t slot_size)
+{
+    size_t bytes = sizeof(RingSlot) + (size_t)slot_size;
+    return (bytes + RING_LINE - 1) / RING_LINE * RING_LINE;
+}
+
+static inline RingSlot *slot_at(uint8_t *mem, uint64_t pos)
+{
+    const RingHeader *header = (const RingHeader *)mem;
+    size_t index = (size_t)(pos & (header->n_slots - 1));
+    return (RingSlot *)(mem + sizeof(RingHeader) + index * slot_stride(header->slot_size));
+}
+
+size_t ring_bytes(uint32_t slot_size, uint32_t n_slots)
+{
+    if (slot_size == 0 || n_slots == 0 || (n_slots & (n_slots - 1)) != 0)
+        return 0;
+    return sizeof(RingHeader) + (size_t)n_slots * slot_stride(slot_size);
+}
+
+bool ring_init(uint8_t *mem, size_t size, uint32_t slot_size, uint32_t n_slots, uint32_t flags)
+{
+    size_t needed = ring_bytes(slot_size, n_slots);
+    if (needed == 0 || size < needed || ((uintptr_t)mem % 8) != 0)
+        return false;
+
+    RingHeader *header = (RingHeader *)mem;
+    memset(header, 0, sizeof(RingHeader));
+    header->slot_size = slot_size;
+    header->n_slots = n_slots;
+    header->flags = flags;
+    for (uint32_t i = 0; i < n_slots; i++)
+    {
+        RingSlot *slot = slot_at(mem, i);
+        slot->len = 0;
+        __atomic_store_n(&slot->seq, (uint64_t)i, __ATOMIC_RELAXED);
+    }
+
+    // Publishing the magic last marks the ring as ready for attachers
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(header->magic, RING_MAGIC, sizeof(header->magic));
+    return true;
+}
+
+bool ring_check(const uint8_t *mem, size_t size)
+{
+    if (size < sizeof(RingHeader) || ((uintptr_t)mem % 8) != 0)
+        return false;
+    const RingHeader *header = (const RingHeader *)mem;
+    if (memcmp(header->magic, RING_MAGIC, sizeof(header->magic)) != 0)
+        return false;
+    size_t needed = ring_bytes(header->slot_size, header->n_slots);
+    return needed != 0 && size >= needed;
+}
+
+bool ring_claim(uint8_t *mem, uint64_t *pos, uint8_t **payload)
+{
+    RingHeader *header = (RingHeader *)mem;
+    bool multi = (header->flags & RING_MULTI_PRODUCER) != 0;
+    uint64_t head = __atomic_load_n(&header->head, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        RingSlot *slot = slot_at(mem, head);
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - head);
+        if (diff < 0)
+            return false; // the consumer has not released this slot yet
+        if (diff > 0)
+        {
+            // Another producer took this position; retry at the current head
+            head = __atomic_load_n(&header->head, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (!multi)
+        {
+            __atomic_store_n(&header->head, head + 1, __ATOMIC_RELAXED);
+        }
+        else if (!__atomic_compare_exchange_n(&header->head, &head, head + 1, true,
+                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            continue; // 'head' now holds the winner's update
+        }
+        *pos = head;
+        *payload = (uint8_t *)(slot + 1);
+        return true;
+    }
+}
+
+void ring_commit(uint8_t *mem, uint64_t pos, uint32_t len)
+{
+    RingSlot *slot = slot_at(mem, pos);
+    slot->len = len;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+bool ring_peek(uint8_t *mem, uint64_t *pos, const uint8_t **payload, uint32_t *len)
+{
+    RingHeader *header = (RingHeader *)mem;
+    for (;;)
+    {
+        uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_RELAXED);
+        RingSlot *slot = slot_at(mem, tail);
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != tail + 1)
+            return false;
+        if (slot->len == RING_SKIP)
+        {
+            ring_release(mem, tail);
+            continue;
+        }
+        *pos = tail;
+        *payload = (const uint8_t *)(slot + 1);
+        *len = slot->len;
+        return true;
+    }
+}
+
+void ring_release(uint8_t *mem, uint64_t pos)
+{
+    RingHeader *header = (RingHeader *)mem;
+    RingSlot *slot = slot_at(mem, pos);
+    __atomic_store_n(&header->tail, pos + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->seq, pos + header->n_slots, __ATOMIC_RELEASE);
+}
+
+uint64_t ring_pending(const uint8_t *mem)
+{
+    const RingHeader *header = (const RingHeader *)mem;
+    uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+    uint64_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+    return head > tail ? head - tail : 0;
+}
@@ -0,0 +1,93 @@
+#ifndef RING_H
+#define RING_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint8_t, uint32_t, uint64_t
+#include <stddef.h>  // for size_t
+
+#define RING_MAGIC "QBRING\0\0"
+#define RING_MULTI_PRODUCER 1u
+
+/*
+ * Length committed for a claimed slot whose message was abandoned (e.g. it
+ * failed to encode); the consumer skips it.
+ */
+#define RING_SKIP UINT32_MAX
+
+    /*
+     * Bounded message queue living in memory shared between processes
+     * (Vyukov's sequence-numbered slots). Every slot carries a sequence
+     * number that tells producers and the single consumer whose turn it is,
+     * so neither side ever takes a lock or makes a syscall. Producers only
+     * contend on 'head' (with a CAS when several of them share the ring);
+     * 'head' and 'tail' sit on separate cache lines.
+     */
+    typedef struct
+    {
+        uint8_t magic[8];
+        uint32_t slot_size; /* payload bytes per slot */
+        uint32_t n_slots;   /* power of two */
+        uint32_t flags;
+        uint8_t pad0[44];
+        uint64_t head; /* next position to claim */
+        uint8_t pad1[56];
+        uint64_t tail; /* next position to consume */
+        uint8_t pad2[56];
+    } RingHeader;
+
+    typedef struct
+    {
+        uint64_t seq; /* pos: free for pos, pos + 1: holds message pos */
+        uint32_t len;
+        uint32_t reserved;
+    } RingSlot;
+
+    /*
+     * Bytes needed by a ring of 'n_slots' slots of 'slot_size' bytes, or 0
+     * if the sizes are invalid.
+     */
+    size_t ring_bytes(uint32_t slot_size, uint32_t n_slots);
+
+    /*
+     * Formats 'mem' as an empty ring.
+     */
+    bool ring_init(uint8_t *mem, size_t size, uint32_t slot_size, uint32_t n_slots, uint32_t flags);
+
+    /*
+     * Validates the header of an existing ring.
+     */
+    bool ring_check(const uint8_t *mem, size_t size);
+
+    /*
+     * Producer: reserves the next slot. Returns false when the ring is full.
+     * The payload at '*payload' (slot_size bytes) must then be filled and
+     * published with ring_commit.
+     */
+    bool ring_claim(uint8_t *mem, uint64_t *pos, uint8_t **payload);
+
+    void ring_commit(uint8_t *mem, uint64_t pos, uint32_t len);
+
+    /*
+     * Consumer: finds the oldest message, releasing abandoned slots on the
+     * way. Returns false when the ring is empty. The payload stays valid
+     * until ring_release.
+     */
+    bool ring_peek(uint8_t *mem, uint64_t *pos, const uint8_t **payload, uint32_t *len);
+
+    void ring_release(uint8_t *mem, uint64_t pos);
+
+    /*
+     * Number of claimed slots not consumed yet (a snapshot).
+     */
+    uint64_t ring_pending(const uint8_t *mem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_H */
@@ -0,0 +1,259 @@
+#include "scan.h"
+#include "pool.h"
+#include <stdlib.h> // for calloc, free
+#include <string.h> // for memcmp, memset
+
+/*
+ * Records per work-stealing chunk. Large enough to amortize the deque lock,
+ * small enough to balance skewed record sizes.
+ */
+#define SCAN_GRAIN 4096
+
+/* -----------------------------------------------------
+ * Accumulators
+ * ----------------------------------------------------- */
+
+static void sum256_add(uint64_t sum[4], const uint64_t add[4])
+{
+    unsigned __int128 carry = 0;
+    for (int k = 0; k < 4; k++)
+    {
+        carry += (unsigned __int128)sum[k] + add[k];
+        sum[k] = (uint64_t)carry;
+        carry >>= 64;
+    }
+}
+
+void scan_acc_add(ScanAcc *acc, const LayoutNumber *value)
+{
+    if (acc->count == 0)
+    {
+        acc->min = *value;
+        acc->max = *value;
+    }
+    else
+    {
+        if (layout_number_compare(value, &acc->min) < 0)
+            acc->min = *value;
+        if (layout_number_compare(value, &acc->max) > 0)
+            acc->max = *value;
+    }
+    acc->count++;
+
+    if (value->type == LAYOUT_NUM_FLOAT)
+    {
+        acc->is_float = true;
+        acc->fsum += value->f;
+        return;
+    }
+
+    // Sign-extend the 128-bit value to 256 bits
+    unsigned __int128 raw = value->type == LAYOUT_NUM_INT ? (unsigned __int128)value->i : value->u;
+    uint64_t ext = (value->type == LAYOUT_NUM_INT && value->i < 0) ? ~0ULL : 0;
+    uint64_t limbs[4] = {(uint64_t)raw, (uint64_t)(raw >> 64), ext, ext};
+    sum256_add(acc->sum, limbs);
+}
+
+void scan_acc_merge(ScanAcc *into, const ScanAcc *from)
+{
+    if (from->count == 0)
+        return;
+    if (into->count == 0)
+    {
+        into->min = from->min;
+        into->max = from->max;
+    }
+    else
+    {
+        if (layout_number_compare(&from->min, &into->min) < 0)
+            into->min = from->min;
+        if (layout_number_compare(&from->max, &into->max) > 0)
+            into->max = from->max;
+    }
+    into->count += from->count;
+    into->fsum += from->fsum;
+    into->is_float = into->is_float || from->is_float;
+    sum256_add(into->sum, from->sum);
+}
+
+/* -----------------------------------------------------
+ * Filters
+ * ----------------------------------------------------- */
+
+static bool cmp_holds(ScanCmp cmp, int order)
+{
+    switch (cmp)
+    {
+    case SCAN_EQ:
+        return order == 0;
+    case SCAN_NE:
+        return order != 0;
+    case SCAN_LT:
+        return order < 0;
+    case SCAN_LE:
+        return order <= 0;
+    case SCAN_GT:
+        return order > 0;
+    default:
+        return order >= 0;
+    }
+}
+
+bool scan_filter_record(const ScanQuery *query, const uint8_t *data,
+                        size_t len, bool *malformed)
+{
+    *malformed = false;
+    for (size_t f = 0; f < query->n_filters; f++)
+    {
+        const ScanFilter *filter = &query->filters[f];
+        Buffer view;
+        init_buffer_view(&view, data, len);
+
+        const LayoutNode *node = layout_locate(query->layout, &filter->field, &view);
+        if (!node)
+        {
+            *malformed = true;
+            return false;
+        }
+
+        int order;
+        if (filter->numeric)
+        {
+            LayoutNumber value;
+            if (!layout_read_number(node, &view, &value))
+            {
+                *malformed = true;
+                return false;
+            }
+            order = layout_number_compare(&value, &filter->number);
+        }
+        else
+        {
+            size_t start = view.offset;
+            if (!layout_skip(node, &view))
+            {
+                *malformed = true;
+                return false;
+            }
+            size_t n = view.offset - start;
+            order = !(n == filter->bytes_len && memcmp(data + start, filter->bytes, n) == 0);
+        }
+        if (!cmp_holds(filter->cmp, order))
+            return false;
+    }
+    return true;
+}
+
+/* -----------------------------------------------------
+ * Parallel Scan
+ * ----------------------------------------------------- */
+
+typedef struct
+{
+    const ScanQuery *query;
+    ScanAcc *partials; /* n_workers x n_aggs */
+    size_t *bad;       /* per worker, SIZE_MAX when clean */
+    int failed;
+} ScanJob;
+
+static void scan_task(void *ctx, size_t worker, size_t begin, size_t end)
+{
+    ScanJob *job = (ScanJob *)ctx;
+    const ScanQuery *query = job->query;
+    ScanAcc *accs = job->partials + worker * query->n_aggs;
+
+    // Another worker hit malformed data: the result is discarded anyway
+    if (__atomic_load_n(&job->failed, __ATOMIC_RELAXED))
+        return;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const uint8_t *data;
+        size_t len;
+        bool malformed;
+        record_get(query->records, i, &data, &len);
+
+        if (!scan_filter_record(query, data, len, &malformed))
+        {
+            if (malformed)
+                goto fail;
+            continue;
+        }
+
+        for (size_t a = 0; a < query->n_aggs; a++)
+        {
+            const ScanAgg *agg = &query->aggs[a];
+            if (agg->kind == SCAN_COUNT)
+            {
+                accs[a].count++;
+                continue;
+            }
+
+            Buffer view;
+            LayoutNumber value;
+            init_buffer_view(&view, data, len);
+            const LayoutNode *node = layout_locate(query->layout, &agg->field, &view);
+            if (!node || !layout_read_number(node, &view, &value))
+                goto fail;
+            scan_acc_add(&accs[a], &value);
+        }
+        continue;
+
+    fail:
+        if (i < job->bad[worker])
+            job->bad[worker] = i;
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+}
+
+ScanStatus scan_run(const ScanQuery *query, size_t n_workers,
+                    ScanAcc *out, size_t *bad_record)
+{
+    if (n_workers == 0)
+        n_workers = 1;
+
+    size_t n_aggs = query->n_aggs;
+    ScanAcc *partials = (ScanAcc *)calloc(n_workers * (n_aggs ? n_aggs : 1), sizeof(ScanAcc));
+    size_t *bad = (size_t *)malloc(n_workers * sizeof(size_t));
+    if (!partials || !bad)
+    {
+        free(partials);
+        free(bad);
+        return SCAN_ERR_NOMEM;
+    }
+    for (size_t w = 0; w < n_workers; w++)
+    {
+        bad[w] = SIZE_MAX;
+    }
+
+    ScanJob job = {query, partials, bad, 0};
+    pool_run(query->records->count, SCAN_GRAIN, n_workers, scan_task, &job);
+
+    ScanStatus status = SCAN_OK;
+    *bad_record = SIZE_MAX;
+    for (size_t w = 0; w < n_workers; w++)
+    {
+        if (bad[w] < *bad_record)
+        {
+            *bad_record = bad[w];
+            status = SCAN_ERR_MALFORMED;
+        }
+    }
+
+    memset(out, 0, n_aggs * sizeof(ScanAcc));
+    for (size_t w = 0; w < n_workers && status == SCAN_OK; w++)
+    {
+        for (size_t a = 0; a < n_aggs; a++)
+        {
+            if (query->aggs[a].kind == SCAN_COUNT)
+                out[a].count += partials[w * n_aggs + a].count;
+            else
+                scan_acc_merge(&out[a], &partials[w * n_aggs + a]);
+        }
+    }
+
+    free(partials);
+    free(bad);
+    return status;
+}
@@ -0,0 +1,112 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint64_t
+#include <stddef.h>  // for size_t
+#include "layout.h"
+#include "records.h"
+
+    typedef enum
+    {
+        SCAN_EQ,
+        SCAN_NE,
+        SCAN_LT,
+        SCAN_LE,
+        SCAN_GT,
+        SCAN_GE,
+    } ScanCmp;
+
+    typedef enum
+    {
+        SCAN_COUNT,
+        SCAN_SUM,
+        SCAN_MIN,
+        SCAN_MAX,
+    } ScanAggKind;
+
+    /*
+     * Keeps records whose field compares true against a constant. Numeric
+     * fields compare by value; any other field compares its encoded bytes
+     * (SCAN_EQ / SCAN_NE only).
+     */
+    typedef struct
+    {
+        LayoutPath field;
+        ScanCmp cmp;
+        bool numeric;
+        LayoutNumber number;
+        const uint8_t *bytes;
+        size_t bytes_len;
+    } ScanFilter;
+
+    typedef struct
+    {
+        ScanAggKind kind;
+        LayoutPath field; /* unused by SCAN_COUNT */
+    } ScanAgg;
+
+    /*
+     * Running state of one aggregate. Integer sums are exact: they are kept
+     * as 256-bit two's complement little-endian limbs.
+     */
+    typedef struct
+    {
+        uint64_t count;
+        uint64_t sum[4];
+        double fsum;
+        bool is_float;
+        LayoutNumber min;
+        LayoutNumber max;
+    } ScanAcc;
+
+    typedef struct
+    {
+        const LayoutNode *layout;
+        const RecordSet *records;
+        const ScanFilter *filters;
+        size_t n_filters;
+        const ScanAgg *aggs;
+        size_t n_aggs;
+    } ScanQuery;
+
+    typedef enum
+    {
+        SCAN_OK = 0,
+        SCAN_ERR_MALFORMED = -1,
+        SCAN_ERR_NOMEM = -2,
+        SCAN_ERR_IO = -3, /* errno holds the cause */
+    } ScanStatus;
+
+    /*
+     * Runs 'query' over all records on 'n_workers' threads and merges the
+     * per-worker partials into 'out' (one ScanAcc per aggregate). On
+     * SCAN_ERR_MALFORMED, 'bad_record' holds the lowest failing record seen.
+     */
+    ScanStatus scan_run(const ScanQuery *query, size_t n_workers,
+                        ScanAcc *out, size_t *bad_record);
+
+    /*
+     * Adds a value to / merges partial accumulators. Exposed for other
+     * engines that aggregate encoded fields.
+     */
+    void scan_acc_add(ScanAcc *acc, const LayoutNumber *value);
+    void scan_acc_merge(ScanAcc *into, const ScanAcc *from);
+
+    /*
+     * Evaluates all filters against one record. Returns false if the record
+     * is filtered out or malformed ('malformed' tells which).
+     */
+    bool scan_filter_record(const ScanQuery *query, const uint8_t *data,
+                            size_t len, bool *malformed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCAN_H */
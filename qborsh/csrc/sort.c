@@ -0,0 +1,557 @@
+#include "sort.h"
+#include "pool.h"
+#include <errno.h>  // for errno, EINTR
+#include <stdlib.h> // for malloc, free
+#include <string.h> // for memcmp, memcpy, memset
+#include <unistd.h> // for write
+
+/*
+ * Records per work-stealing chunk while extracting keys.
+ */
+#define SORT_GRAIN 4096
+
+/*
+ * Size of the output buffer used when merging runs.
+ */
+#define SORT_WRITE_BUFFER (1 << 20)
+
+/* -----------------------------------------------------
+ * Keys
+ * ----------------------------------------------------- */
+
+/*
+ * A record's key: numeric keys are normalized so that unsigned comparison of
+ * (hi, lo) matches the key order, others point at their bytes.
+ */
+typedef struct
+{
+    uint64_t lo;
+    uint64_t hi;
+    const uint8_t *bytes;
+    size_t len;
+    uint64_t index;
+} SortItem;
+
+bool sort_key_init(SortKey *key, const LayoutNode *layout,
+                   const LayoutPath *path, bool reverse)
+{
+    key->layout = layout;
+    key->path = *path;
+    key->node = layout_field(layout, path);
+    key->reverse = reverse;
+    return key->node != NULL;
+}
+
+/*
+ * Maps a little-endian scalar to an unsigned integer with the same order:
+ * signed values get their sign bit flipped, floats their sign bit (positive)
+ * or every bit (negative).
+ */
+static void normalize_scalar(LayoutKind kind, const uint8_t *raw, size_t size, SortItem *item)
+{
+    unsigned __int128 v = 0;
+    for (size_t i = size; i-- > 0;)
+    {
+        v = (v << 8) | raw[i];
+    }
+    unsigned __int128 sign = (unsigned __int128)1 << (8 * size - 1);
+
+    switch (kind)
+    {
+    case LAYOUT_I8:
+    case LAYOUT_I16:
+    case LAYOUT_I32:
+    case LAYOUT_I64:
+    case LAYOUT_I128:
+        v ^= sign;
+        break;
+    case LAYOUT_F32:
+    case LAYOUT_F64:
+        if (v & sign)
+            v = ~v & ((sign << 1) - 1);
+        else
+            v |= sign;
+        break;
+    default:
+        break;
+    }
+    item->lo = (uint64_t)v;
+    item->hi = (uint64_t)(v >> 64);
+}
+
+static bool read_key(const SortKey *key, const uint8_t *data, size_t len, SortItem *item)
+{
+    Buffer view;
+    init_buffer_view(&view, data, len);
+    const LayoutNode *node = layout_locate(key->layout, &key->path, &view);
+    if (!node)
+        return false;
+
+    if (layout_is_numeric(node->kind))
+    {
+        const uint8_t *raw = read_view(&view, node->size);
+        if (!raw)
+            return false;
+        normalize_scalar(node->kind, raw, node->size, item);
+        if (key->reverse)
+        {
+            item->lo = ~item->lo;
+            item->hi = ~item->hi;
+        }
+        return true;
+    }
+
+    size_t start = view.offset;
+    if (!layout_skip(node, &view))
+        return false;
+    item->bytes = data + start;
+    item->len = view.offset - start;
+
+    // Strings and bytes order by content, not by their length prefix
+    if (node->kind == LAYOUT_STRING || node->kind == LAYOUT_BYTES)
+    {
+        item->bytes += 4;
+        item->len -= 4;
+    }
+    return true;
+}
+
+static int compare_items(const SortKey *key, const SortItem *a, const SortItem *b)
+{
+    int order;
+    if (layout_is_numeric(key->node->kind))
+    {
+        if (a->hi != b->hi)
+            return a->hi < b->hi ? -1 : 1;
+        if (a->lo != b->lo)
+            return a->lo < b->lo ? -1 : 1;
+        return 0;
+    }
+
+    size_t n = a->len < b->len ? a->len : b->len;
+    order = memcmp(a->bytes, b->bytes, n);
+    if (order == 0)
+        order = (a->len > b->len) - (a->len < b->len);
+    if (key->reverse)
+        order = -order;
+    return order;
+}
+
+/* -----------------------------------------------------
+ * Key Extraction
+ * ----------------------------------------------------- */
+
+typedef struct
+{
+    uint64_t key;
+    uint64_t index;
+} RadixPair;
+
+/*
+ * Byte keys are extracted into 'items'; numeric keys into 'pairs' (low
+ * halves) and 'hi' (high halves), which is all the radix sort touches.
+ */
+typedef struct
+{
+    const RecordSet *rs;
+    const SortKey *key;
+    SortItem *items;
+    RadixPair *pairs;
+    uint64_t *hi;
+    size_t *bad; /* per worker, SIZE_MAX when clean */
+    int failed;
+} ExtractJob;
+
+static void extract_task(void *ctx, size_t worker, size_t begin, size_t end)
+{
+    ExtractJob *job = (ExtractJob *)ctx;
+    if (__atomic_load_n(&job->failed, __ATOMIC_RELAXED))
+        return;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const uint8_t *data;
+        size_t len;
+        record_get(job->rs, i, &data, &len);
+
+        SortItem item;
+        if (!read_key(job->key, data, len, &item))
+        {
+            if (i < job->bad[worker])
+                job->bad[worker] = i;
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        item.index = i;
+        if (job->items)
+        {
+            job->items[i] = item;
+        }
+        else
+        {
+            job->pairs[i].key = item.lo;
+            job->pairs[i].index = i;
+            job->hi[i] = item.hi;
+        }
+    }
+}
+
+/* -----------------------------------------------------
+ * Sorting
+ * ----------------------------------------------------- */
+
+/*
+ * Digit width of the radix passes: 11 bits sorts 64-bit keys in six passes
+ * while the 2048 buckets stay cache resident.
+ */
+#define RADIX_BITS 11
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES ((64 + RADIX_BITS - 1) / RADIX_BITS)
+
+/*
+ * Stable LSD radix sort of 64-bit keys. Digits that are equal across all
+ * pairs (e.g. the top bits of small slots) are skipped.
+ */
+static bool radix_sort64(RadixPair *pairs, RadixPair *tmp, size_t n)
+{
+    size_t(*counts)[RADIX_BUCKETS] = calloc(RADIX_PASSES, sizeof(*counts));
+    if (!counts)
+        return false;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t key = pairs[i].key;
+        for (size_t d = 0; d < RADIX_PASSES; d++)
+        {
+            counts[d][(key >> (RADIX_BITS * d)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    RadixPair *src = pairs, *dst = tmp;
+    for (size_t d = 0; d < RADIX_PASSES; d++)
+    {
+        size_t shift = RADIX_BITS * d;
+        if (counts[d][(pairs[0].key >> shift) & (RADIX_BUCKETS - 1)] == n)
+            continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            size_t c = counts[d][b];
+            counts[d][b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            dst[counts[d][(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+        RadixPair *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != pairs)
+        memcpy(pairs, src, n * sizeof(RadixPair));
+    free(counts);
+    return true;
+}
+
+/*
+ * Orders numeric keys by (hi, lo): radix sort on the low halves, then a
+ * second stable pass on the high halves when they differ (128-bit keys).
+ */
+static bool radix_sort(RadixPair *pairs, const uint64_t *hi, uint64_t *perm, size_t n)
+{
+    RadixPair *tmp = (RadixPair *)malloc(n * sizeof(RadixPair));
+    if (!tmp || !radix_sort64(pairs, tmp, n))
+    {
+        free(tmp);
+        return false;
+    }
+
+    bool wide = false;
+    for (size_t i = 1; i < n && !wide; i++)
+    {
+        wide = hi[i] != hi[0];
+    }
+    if (wide)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            pairs[i].key = hi[pairs[i].index];
+        }
+        if (!radix_sort64(pairs, tmp, n))
+        {
+            free(tmp);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        perm[i] = pairs[i].index;
+    }
+    free(tmp);
+    return true;
+}
+
+/*
+ * Stable bottom-up merge sort for byte keys.
+ */
+static void merge_sort(const SortKey *key, SortItem *items, SortItem *tmp, size_t n)
+{
+    SortItem *src = items, *dst = tmp;
+    for (size_t width = 1; width < n; width *= 2)
+    {
+        for (size_t lo = 0; lo < n; lo += 2 * width)
+        {
+            size_t mid = lo + width < n ? lo + width : n;
+            size_t hi = lo + 2 * width < n ? lo + 2 * width : n;
+            size_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi)
+            {
+                dst[k++] = compare_items(key, &src[j], &src[i]) < 0 ? src[j++] : src[i++];
+            }
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
+        }
+        SortItem *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != items)
+        memcpy(items, src, n * sizeof(SortItem));
+}
+
+ScanStatus sort_records(const RecordSet *rs, const SortKey *key,
+                        size_t n_workers, uint64_t *perm, size_t *bad_record)
+{
+    if (n_workers == 0)
+        n_workers = 1;
+
+    size_t n = rs->count;
+    size_t alloc = n ? n : 1;
+    bool numeric = layout_is_numeric(key->node->kind);
+    *bad_record = SIZE_MAX;
+
+    ExtractJob job = {rs, key, NULL, NULL, NULL, NULL, 0};
+    job.bad = (size_t *)malloc(n_workers * sizeof(size_t));
+    if (numeric)
+    {
+        job.pairs = (RadixPair *)malloc(alloc * sizeof(RadixPair));
+        job.hi = (uint64_t *)malloc(alloc * sizeof(uint64_t));
+    }
+    else
+    {
+        job.items = (SortItem *)malloc(alloc * sizeof(SortItem));
+    }
+
+    ScanStatus status = SCAN_OK;
+    if (!job.bad || (numeric ? !job.pairs || !job.hi : !job.items))
+    {
+        status = SCAN_ERR_NOMEM;
+        goto done;
+    }
+    for (size_t w = 0; w < n_workers; w++)
+    {
+        job.bad[w] = SIZE_MAX;
+    }
+
+    pool_run(n, SORT_GRAIN, n_workers, extract_task, &job);
+    for (size_t w = 0; w < n_workers; w++)
+    {
+        if (job.bad[w] < *bad_record)
+        {
+            *bad_record = job.bad[w];
+            status = SCAN_ERR_MALFORMED;
+        }
+    }
+    if (status != SCAN_OK || n == 0)
+        goto done;
+
+    if (numeric)
+    {
+        if (!radix_sort(job.pairs, job.hi, perm, n))
+            status = SCAN_ERR_NOMEM;
+        goto done;
+    }
+
+    SortItem *tmp = (SortItem *)malloc(n * sizeof(SortItem));
+    if (!tmp)
+    {
+        status = SCAN_ERR_NOMEM;
+        goto done;
+    }
+    merge_sort(key, job.items, tmp, n);
+    free(tmp);
+    for (size_t i = 0; i < n; i++)
+    {
+        perm[i] = job.items[i].index;
+    }
+
+done:
+    free(job.items);
+    free(job.pairs);
+    free(job.hi);
+    free(job.bad);
+    return status;
+}
+
+/* -----------------------------------------------------
+ * Merging Runs
+ * ----------------------------------------------------- */
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+    size_t offset; /* start of the head record */
+    size_t end;    /* end of the head record */
+    SortItem item; /* head key; 'index' is the run number */
+} RunCursor;
+
+/*
+ * Frames the next record of 'run'. Returns 1 if there is one, 0 at the end
+ * and -1 on malformed data.
+ */
+static int cursor_next(const SortKey *key, RunCursor *run)
+{
+    run->offset = run->end;
+    if (run->offset >= run->size)
+        return 0;
+
+    Buffer view;
+    init_buffer_view(&view, run->data + run->offset, run->size - run->offset);
+    if (!layout_skip(key->layout, &view))
+        return -1;
+    run->end = run->offset + view.offset;
+    return read_key(key, run->data + run->offset, view.offset, &run->item) ? 1 : -1;
+}
+
+static bool cursor_less(const SortKey *key, const RunCursor *a, const RunCursor *b)
+{
+    int order = compare_items(key, &a->item, &b->item);
+    return order < 0 || (order == 0 && a->item.index < b->item.index);
+}
+
+static void heap_sift_down(const SortKey *key, RunCursor **heap, size_t n, size_t i)
+{
+    for (;;)
+    {
+        size_t least = i, left = 2 * i + 1, right = left + 1;
+        if (left < n && cursor_less(key, heap[left], heap[least]))
+            least = left;
+        if (right < n && cursor_less(key, heap[right], heap[least]))
+            least = right;
+        if (least == i)
+            return;
+        RunCursor *swap = heap[i];
+        heap[i] = heap[least];
+        heap[least] = swap;
+        i = least;
+    }
+}
+
+static bool write_all(int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+ScanStatus sort_merge(const SortKey *key, const uint8_t *const *runs,
+                      const size_t *run_sizes, size_t n_runs, int fd,
+                      size_t *bad_record)
+{
+    *bad_record = SIZE_MAX;
+    RunCursor *cursors = (RunCursor *)calloc(n_runs ? n_runs : 1, sizeof(RunCursor));
+    RunCursor **heap = (RunCursor **)malloc((n_runs ? n_runs : 1) * sizeof(RunCursor *));
+    uint8_t *out = (uint8_t *)malloc(SORT_WRITE_BUFFER);
+    ScanStatus status = SCAN_OK;
+    if (!cursors || !heap || !out)
+    {
+        status = SCAN_ERR_NOMEM;
+        goto done;
+    }
+
+    size_t n_heap = 0;
+    for (size_t r = 0; r < n_runs; r++)
+    {
+        RunCursor *run = &cursors[r];
+        run->data = runs[r];
+        run->size = run_sizes[r];
+        int more = cursor_next(key, run);
+        run->item.index = r;
+        if (more < 0)
+        {
+            *bad_record = r;
+            status = SCAN_ERR_MALFORMED;
+            goto done;
+        }
+        if (more)
+            heap[n_heap++] = run;
+    }
+    for (size_t i = n_heap / 2; i-- > 0;)
+    {
+        heap_sift_down(key, heap, n_heap, i);
+    }
+
+    size_t used = 0;
+    while (n_heap > 0)
+    {
+        RunCursor *run = heap[0];
+        size_t size = run->end - run->offset;
+        if (used + size > SORT_WRITE_BUFFER || size > SORT_WRITE_BUFFER)
+        {
+            if (!write_all(fd, out, used))
+            {
+                status = SCAN_ERR_IO;
+                goto done;
+            }
+            used = 0;
+        }
+        if (size > SORT_WRITE_BUFFER)
+        {
+            if (!write_all(fd, run->data + run->offset, size))
+            {
+                status = SCAN_ERR_IO;
+                goto done;
+            }
+        }
+        else
+        {
+            memcpy(out + used, run->data + run->offset, size);
+            used += size;
+        }
+
+        int more = cursor_next(key, run);
+        run->item.index = (size_t)(run - cursors);
+        if (more < 0)
+        {
+            *bad_record = (size_t)(run - cursors);
+            status = SCAN_ERR_MALFORMED;
+            goto done;
+        }
+        if (!more)
+            heap[0] = heap[--n_heap];
+        heap_sift_down(key, heap, n_heap, 0);
+    }
+    if (!write_all(fd, out, used))
+        status = SCAN_ERR_IO;
+
+done:
+    free(cursors);
+    free(heap);
+    free(out);
+    return status;
+}
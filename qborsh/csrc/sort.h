@@ -0,0 +1,55 @@
+#ifndef SORT_H
+#define SORT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h> // for bool
+#include <stdint.h>  // for uint8_t, uint64_t
+#include <stddef.h>  // for size_t
+#include "layout.h"
+#include "records.h"
+#include "scan.h"
+
+    /*
+     * The field records are ordered by. Numeric keys sort by value (radix
+     * sort); strings and bytes by their content, anything else by its
+     * encoded bytes (memcmp). Equal keys keep their input order.
+     */
+    typedef struct
+    {
+        const LayoutNode *layout;
+        LayoutPath path;
+        const LayoutNode *node; /* set by sort_key_init */
+        bool reverse;
+    } SortKey;
+
+    /*
+     * Resolves 'path' in 'layout'. Returns false if it addresses no field.
+     */
+    bool sort_key_init(SortKey *key, const LayoutNode *layout,
+                       const LayoutPath *path, bool reverse);
+
+    /*
+     * Stores in 'perm' the record numbers of 'rs' in key order. Keys are
+     * extracted on 'n_workers' threads.
+     */
+    ScanStatus sort_records(const RecordSet *rs, const SortKey *key,
+                            size_t n_workers, uint64_t *perm, size_t *bad_record);
+
+    /*
+     * Merges 'n_runs' blocks of back-to-back records, each already sorted by
+     * 'key', and writes the result to 'fd'. Equal keys are taken from earlier
+     * runs first.
+     */
+    ScanStatus sort_merge(const SortKey *key, const uint8_t *const *runs,
+                          const size_t *run_sizes, size_t n_runs, int fd,
+                          size_t *bad_record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SORT_H */
@@ -0,0 +1,288 @@
+import json
+import os
+import typing
+
+from qborsh.csrc import Buffer, Layout
+from qborsh.registry import Registry
+
+_PRIMITIVES = {
+    "bool": ("bool",),
+    "u8": ("u8",),
+    "u16": ("u16",),
+    "u32": ("u32",),
+    "u64": ("u64",),
+    "u128": ("u128",),
+    "i8": ("i8",),
+    "i16": ("i16",),
+    "i32": ("i32",),
+    "i64": ("i64",),
+    "i128": ("i128",),
+    "f32": ("f32",),
+    "f64": ("f64",),
+    "string": ("string",),
+    "bytes": ("bytes",),
+    "pubkey": ("pubkey",),
+    "publicKey": ("pubkey",),  # IDLs before Anchor 0.30
+}
+
+IdlSource = typing.Union[str, os.PathLike, dict]
+
+
+def _snake_case(name: str) -> str:
+    out = []
+    for i, char in enumerate(name):
+        if char.isupper() and i and (name[i - 1].islower() or (i + 1 < len(name) and name[i + 1].islower())):
+            out.append("_")
+        out.append(char.lower())
+    return "".join(out)
+
+
+class Idl:
+    """
+    An Anchor program's IDL compiled into native layouts, without building a
+    schema class per type.
+
+    Type definitions become layout specs (the tuples `BorshType.layout`
+    returns) straight from the JSON, and each type is compiled to a `Layout`
+    the first time it is used. Accounts, events and instructions are keyed by
+    their 8-byte discriminators in `Registry`s, so mixed account data or
+    event logs decode with one native dispatch. Both the current (Anchor
+    0.30+) IDL format and the legacy one are read; legacy IDLs carry no
+    discriminators, so Anchor's are derived from the names.
+
+    Values decode like natively decoded schemas: structs to dicts, enums to
+    (variant, payload) tuples, tuple structs to tuples. `[u8; N]` arrays
+    decode to bytes. Zero-copy types (bytemuck serialization, with repr(C)
+    padding) raise ValueError.
+
+    Example:
+        >>> idl = qborsh.idl.load("target/idl/amm.json")
+        >>> idl.decode_account(account_data)
+        ('Pool', {'mint_a': '...', 'liquidity': 1000, ...})
+        >>> idl.decode_type("SwapParams", data)
+    """
+
+    def __init__(self, idl: dict):
+        self.raw = idl
+        metadata = idl.get("metadata") or {}
+        self.name: typing.Optional[str] = idl.get("name") or metadata.get("name")
+        self.address: typing.Optional[str] = idl.get("address") or metadata.get("address")
+
+        self._defs: dict[str, dict] = {}
+        for definition in idl.get("types") or ():
+            body = definition["type"]
+            if definition.get("generics"):
+                body = dict(body, generics=definition["generics"])
+            if definition.get("serialization", "borsh") != "borsh":
+                body = dict(body, serialization=definition["serialization"])
+            self._defs[definition["name"]] = body
+        # Legacy IDLs define accounts (and event fields) inline
+        for account in idl.get("accounts") or ():
+            if "type" in account:
+                self._defs.setdefault(account["name"], account["type"])
+        for event in idl.get("events") or ():
+            if "fields" in event:
+                self._defs.setdefault(event["name"], {"kind": "struct", "fields": event["fields"]})
+
+        self._specs: dict[str, tuple] = {}
+        self._layouts: dict[str, Layout] = {}
+        self._resolving: set[str] = set()
+        self._accounts: typing.Optional[Registry] = None
+        self._events: typing.Optional[Registry] = None
+        self._instructions: typing.Optional[Registry] = None
+
+    # -----------------------------------------------------
+    # Specs
+    # -----------------------------------------------------
+
+    def spec(self, name: str) -> tuple:
+        """
+        Layout spec of the defined type `name`.
+        """
+        spec = self._specs.get(name)
+        if spec is not None:
+            return spec
+        definition = self._defs.get(name)
+        if definition is None:
+            raise KeyError(f"Type {name!r} is not defined in the IDL.")
+        if name in self._resolving:
+            raise ValueError(f"Type {name!r} is recursive, which has no native layout.")
+
+        self._resolving.add(name)
+        try:
+            spec = self._definition_spec(name, definition)
+        finally:
+            self._resolving.discard(name)
+        self._specs[name] = spec
+        return spec
+
+    def _definition_spec(self, name: str, definition: dict) -> tuple:
+        if definition.get("generics"):
+            raise ValueError(f"Type {name!r} is generic, which is not supported.")
+        serialization = definition.get("serialization", "borsh")
+        if serialization != "borsh":
+            # bytemuck (zero-copy) types are laid out with repr(C) padding, not as Borsh
+            raise ValueError(f"Type {name!r} uses {serialization} serialization, which is not supported.")
+        kind = definition["kind"]
+        if kind == "struct":
+            return self._fields_spec(definition.get("fields") or ())
+        if kind == "enum":
+            variants = []
+            for variant in definition["variants"]:
+                fields = variant.get("fields")
+                variants.append((variant["name"], self._fields_spec(fields) if fields else None))
+            return ("enum", tuple(variants))
+        if kind == "type":
+            return self.type_spec(definition["alias"])
+        raise ValueError(f"Type {name!r} is of unsupported kind {kind!r}.")
+
+    def _fields_spec(self, fields: typing.Sequence[typing.Any]) -> tuple:
+        # Named fields make a struct; bare types (tuple structs and variants) a tuple
+        if fields and isinstance(fields[0], dict) and "name" in fields[0]:
+            return ("struct", tuple((field["name"], self.type_spec(field["type"])) for field in fields))
+        return ("tuple", tuple(self.type_spec(field) for field in fields))
+
+    def type_spec(self, idl_type: typing.Any) -> tuple:
+        """
+        Layout spec of an IDL type expression, e.g. "u64" or {"vec": "pubkey"}.
+        """
+        if isinstance(idl_type, str):
+            spec = _PRIMITIVES.get(idl_type)
+            if spec is None:
+                raise ValueError(f"Unsupported IDL type {idl_type!r}.")
+            return spec
+
+        if "defined" in idl_type:
+            defined = idl_type["defined"]
+            if isinstance(defined, dict):
+                if defined.get("generics"):
+                    raise ValueError(f"Type {defined['name']!r} is generic, which is not supported.")
+                defined = defined["name"]
+            return self.spec(defined)
+        if "vec" in idl_type:
+            return ("vec", self.type_spec(idl_type["vec"]))
+        if "option" in idl_type:
+            return ("option", self.type_spec(idl_type["option"]))
+        if "array" in idl_type:
+            element, length = idl_type["array"]
+            if not isinstance(length, int):
+                raise ValueError(f"Array length {length!r} is generic, which is not supported.")
+            if element == "u8":
+                return ("fixed_bytes", length)
+            return ("array", self.type_spec(element), length)
+        raise ValueError(f"Unsupported IDL type {idl_type!r}.")
+
+    # -----------------------------------------------------
+    # Layouts
+    # -----------------------------------------------------
+
+    @property
+    def types(self) -> tuple[str, ...]:
+        """
+        Names of every defined type.
+        """
+        return tuple(self._defs)
+
+    def layout(self, name: str) -> Layout:
+        """
+        Compiled layout of the defined type `name`, compiled once and cached.
+        """
+        layout = self._layouts.get(name)
+        if layout is None:
+            layout = self._layouts[name] = Layout(self.spec(name))
+        return layout
+
+    def decode_type(self, name: str, data: typing.Union[bytes, bytearray, memoryview]) -> typing.Any:
+        """
+        Decode `data` as the defined type `name` (no discriminator).
+        """
+        buf = Buffer(1)
+        buf.attach(data)
+        try:
+            return self.layout(name).read(buf)
+        finally:
+            buf.detach()
+            buf.free()
+
+    # -----------------------------------------------------
+    # Discriminated Records
+    # -----------------------------------------------------
+
+    def _discriminator(self, entry: dict, namespace: str, name: str) -> bytes:
+        discriminator = entry.get("discriminator")
+        if discriminator is not None:
+            return bytes(discriminator)
+        return Registry.anchor_discriminator(namespace, name)
+
+    @property
+    def accounts(self) -> Registry:
+        """
+        Registry of the program's accounts by discriminator.
+        """
+        if self._accounts is None:
+            registry = Registry()
+            for account in self.raw.get("accounts") or ():
+                name = account["name"]
+                registry.register(self._discriminator(account, "account", name), self.layout(name), name)
+            self._accounts = registry
+        return self._accounts
+
+    @property
+    def events(self) -> Registry:
+        """
+        Registry of the program's events by discriminator.
+        """
+        if self._events is None:
+            registry = Registry()
+            for event in self.raw.get("events") or ():
+                name = event["name"]
+                registry.register(self._discriminator(event, "event", name), self.layout(name), name)
+            self._events = registry
+        return self._events
+
+    @property
+    def instructions(self) -> Registry:
+        """
+        Registry of the program's instruction arguments by discriminator.
+        """
+        if self._instructions is None:
+            registry = Registry()
+            for instruction in self.raw.get("instructions") or ():
+                name = instruction["name"]
+                spec = self._fields_spec(instruction.get("args") or ())
+                if spec == ("tuple", ()):
+                    spec = ("struct", ())
+                namespace_name = _snake_case(name)
+                registry.register(self._discriminator(instruction, "global", namespace_name), Layout(spec), name)
+            self._instructions = registry
+        return self._instructions
+
+    def decode_account(self, data: typing.Union[bytes, bytearray, memoryview]) -> tuple[str, typing.Any]:
+        """
+        Decode account data to (account name, value).
+        """
+        return self.accounts.decode(data, tagged=True)
+
+    def decode_event(self, data: typing.Union[bytes, bytearray, memoryview]) -> tuple[str, typing.Any]:
+        """
+        Decode event data to (event name, value).
+        """
+        return self.events.decode(data, tagged=True)
+
+    def decode_instruction(self, data: typing.Union[bytes, bytearray, memoryview]) -> tuple[str, typing.Any]:
+        """
+        Decode instruction data to (instruction name, arguments).
+        """
+        return self.instructions.decode(data, tagged=True)
+
+
+def load(source: IdlSource) -> Idl:
+    """
+    Load an Anchor IDL from a JSON file path, a JSON string or a parsed dict.
+    """
+    if isinstance(source, dict):
+        return Idl(source)
+    if isinstance(source, str) and source.lstrip().startswith("{"):
+        return Idl(json.loads(source))
+    with open(source, "rb") as f:
+        return Idl(json.load(f))
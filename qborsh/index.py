@@ -0,0 +1,133 @@
+import mmap
+import os
+import typing
+
+from qborsh import csrc
+from qborsh.query import _workers
+from qborsh.types import BorshType, Schema
+
+PathLike = typing.Union[str, os.PathLike]
+
+
+def _map(path: PathLike) -> typing.Union[mmap.mmap, bytes]:
+    with open(path, "rb") as f:
+        if os.fstat(f.fileno()).st_size == 0:
+            return b""
+        return mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+
+def _join(records: typing.Any) -> typing.Any:
+    if isinstance(records, (bytes, bytearray, memoryview, mmap.mmap)):
+        return records
+    return b"".join(records)
+
+
+class Index:
+    """
+    Hash index from the encoded bytes of one field to the records holding
+    it. Lookups probe the native table and decode only the matching record.
+
+    Build one with `Schema.build_index`, persist it with `save` and reopen
+    it (memory-mapped, nothing is rebuilt) with `Schema.load_index`.
+    """
+
+    def __init__(self, schema: Schema, data: typing.Any, records: typing.Any, owned: typing.Sequence[typing.Any] = ()):
+        self.schema = schema
+        self._data = data
+        self._records = records
+        self._owned = owned
+        self._native = csrc.Index(schema.compile(), data, records)
+
+        key_type: BorshType = schema
+        for index in self._native.path:
+            key_type = list(key_type.__borsh_fields__)[index][1]  # type: ignore[attr-defined]
+        self.key_type = key_type
+
+    def __len__(self) -> int:
+        return len(self._native)
+
+    def __contains__(self, key: typing.Any) -> bool:
+        return self._native.find(self.key_type.encode(key)) is not None
+
+    def _decode(self, span: tuple[int, int]) -> typing.Any:
+        offset, length = span
+        return self.schema.decode(bytes(self._records[offset : offset + length]))
+
+    def get(self, key: typing.Any, default: typing.Any = None) -> typing.Any:
+        """
+        Decode the first record (in record order) whose field equals `key`,
+        or return `default`.
+        """
+        span = self._native.find(self.key_type.encode(key))
+        if span is None:
+            return default
+        return self._decode(span)
+
+    def get_all(self, key: typing.Any) -> list[typing.Any]:
+        """
+        Decode every record whose field equals `key`, in record order.
+        """
+        return [self._decode(span) for span in self._native.find_all(self.key_type.encode(key))]
+
+    def offsets(self, key: typing.Any) -> list[tuple[int, int]]:
+        """
+        Byte ranges (offset, length) of the records whose field equals `key`.
+        """
+        return self._native.find_all(self.key_type.encode(key))
+
+    def save(self, path: PathLike) -> None:
+        """
+        Write the index to `path`. The records are not included.
+        """
+        with open(path, "wb") as f:
+            f.write(self._data)
+
+    def close(self) -> None:
+        """
+        Release the native table and any files it memory-mapped.
+        """
+        self._native = None
+        for mapped in self._owned:
+            if isinstance(mapped, mmap.mmap):
+                mapped.close()
+        self._owned = ()
+
+    def __enter__(self) -> "Index":
+        return self
+
+    def __exit__(self, *exc: typing.Any) -> None:
+        self.close()
+
+
+def build_index(
+    schema: Schema,
+    records: typing.Any,
+    field: str,
+    workers: typing.Optional[int] = None,
+) -> Index:
+    """
+    Index `field` over back-to-back `records` (bytes-like, a path, which is
+    memory-mapped, or a sequence of encoded records, which is joined).
+    """
+    path = schema.field_path(field)[0]
+    owned = []
+    if isinstance(records, (str, os.PathLike)):
+        records = _map(records)
+        owned.append(records)
+    records = _join(records)
+    data = csrc.build_index(schema.compile(), records, path, workers=_workers(workers))
+    return Index(schema, data, records, owned)
+
+
+def load_index(schema: Schema, path: PathLike, records: typing.Any) -> Index:
+    """
+    Open an index saved with `Index.save` over the `records` it was built
+    from (bytes-like, a path or a sequence of encoded records). Files are
+    memory-mapped.
+    """
+    data = _map(path)
+    owned = [data]
+    if isinstance(records, (str, os.PathLike)):
+        records = _map(records)
+        owned.append(records)
+    return Index(schema, data, _join(records), owned)
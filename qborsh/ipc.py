@@ -0,0 +1,181 @@
+import queue
+import sys
+import time
+import typing
+from multiprocessing import resource_tracker, shared_memory
+
+from qborsh import csrc
+from qborsh.types import BorshType
+
+_SPINS = 1000
+"""
+Polls of a full/empty ring before `put`/`get` start sleeping between polls.
+"""
+
+_BACKOFF = 50e-6
+"""
+Sleep (seconds) between polls once spinning gave up.
+"""
+
+
+def _attach(name: str) -> shared_memory.SharedMemory:
+    # Only the creator tracks the memory: before Python 3.13 attaching also
+    # registers it, and the attaching process's tracker unlinks it at exit
+    if sys.version_info >= (3, 13):
+        return shared_memory.SharedMemory(name, track=False)
+    shm = shared_memory.SharedMemory(name)
+    resource_tracker.unregister(shm._name, "shared_memory")  # type: ignore[attr-defined]
+    return shm
+
+
+class Ring:
+    """
+    Bounded queue of encoded messages in shared memory, for passing records
+    between processes without pipes.
+
+    Slots carry sequence numbers that producers and the consumer advance with
+    atomic loads and stores (compare-and-swap among producers when
+    `multi_producer`), so a busy ring costs no locks and no syscalls. `put`
+    encodes straight into a claimed slot and `get` decodes from the slot in
+    place before handing it back. There is a single consumer; producers are
+    one process, or any number with `multi_producer=True`.
+
+    The creator owns the memory: other processes attach with the ring's
+    `name` and `create=False`, and the creator calls `unlink` when done.
+
+    Example:
+        >>> ring = qborsh.ipc.Ring(slots=1024, slot_size=256, schema=Transfer)
+        >>> # producer process
+        >>> qborsh.ipc.Ring(ring.name, create=False, schema=Transfer).put(transfer)
+        >>> # consumer process
+        >>> ring.get()
+    """
+
+    def __init__(
+        self,
+        name: typing.Optional[str] = None,
+        create: bool = True,
+        slots: int = 1024,
+        slot_size: int = 4096,
+        schema: typing.Optional[BorshType] = None,
+        multi_producer: bool = False,
+    ):
+        self.schema = schema
+        if create:
+            size = csrc.ring_bytes(slot_size, slots)
+            self._shm = shared_memory.SharedMemory(name, create=True, size=size)
+            try:
+                self._ring = csrc.Ring(self._shm.buf, slot_size, slots, multi_producer)
+            except BaseException:
+                self._shm.close()
+                self._shm.unlink()
+                raise
+        else:
+            if name is None:
+                raise ValueError("Attaching to a ring needs its name.")
+            self._shm = _attach(name)
+            try:
+                self._ring = csrc.Ring(self._shm.buf)
+            except BaseException:
+                self._shm.close()
+                raise
+        self._view: typing.Optional[memoryview] = self._shm.buf
+        self.slot_size: int = self._ring.slot_size
+        self.slots: int = self._ring.slots
+        self.multi_producer: bool = self._ring.multi_producer
+
+    @property
+    def name(self) -> str:
+        return self._shm.name
+
+    def __len__(self) -> int:
+        return len(self._ring)
+
+    # -----------------------------------------------------
+    # Producing / Consuming
+    # -----------------------------------------------------
+
+    def _wait(self, step: typing.Callable, block: bool, timeout: typing.Optional[float], error: type) -> typing.Any:
+        result = step()
+        if result is not None:
+            return result
+        if not block:
+            raise error
+
+        # Spin first; only an idle ring pays for sleeping
+        deadline = None if timeout is None else time.monotonic() + timeout
+        spins = 0
+        while result is None:
+            if deadline is not None and time.monotonic() >= deadline:
+                raise error
+            spins += 1
+            if spins > _SPINS:
+                time.sleep(_BACKOFF)
+            result = step()
+        return result
+
+    def put(self, value: typing.Any, block: bool = True, timeout: typing.Optional[float] = None) -> None:
+        """
+        Send one message: `value` encoded with `schema`, or bytes-like
+        without one. Waits for a free slot like `queue.Queue.put` and raises
+        `queue.Full` when none frees up in time.
+        """
+        if self.schema is None:
+            if len(value) > self.slot_size:
+                raise ValueError(f"Message of {len(value)} bytes exceeds the slot size ({self.slot_size}).")
+            self._wait(lambda: self._ring.put(value) or None, block, timeout, queue.Full)
+            return
+
+        position, offset = self._wait(self._ring.claim, block, timeout, queue.Full)
+        length = None
+        try:
+            assert self._view is not None
+            with self._view[offset : offset + self.slot_size] as slot:
+                length = self.schema.encode_into(value, slot)
+        finally:
+            # A failed encode still hands the slot on, marked as abandoned
+            self._ring.commit(position, length)
+
+    def get(self, block: bool = True, timeout: typing.Optional[float] = None) -> typing.Any:
+        """
+        Receive the oldest message, decoded with `schema` in place (bytes
+        without one). Waits like `queue.Queue.get` and raises `queue.Empty`
+        when nothing arrives in time.
+        """
+        position, offset, length = self._wait(self._ring.peek, block, timeout, queue.Empty)
+        try:
+            assert self._view is not None
+            with self._view[offset : offset + length] as payload:
+                if self.schema is None:
+                    return bytes(payload)
+                return self.schema.decode(payload)
+        finally:
+            self._ring.release(position)
+
+    # -----------------------------------------------------
+    # Lifetime
+    # -----------------------------------------------------
+
+    def close(self) -> None:
+        """
+        Detach from the shared memory (it lives on until `unlink`).
+        """
+        if self._view is not None:
+            self._ring.close()
+            self._view = None
+            self._shm.close()
+
+    def unlink(self) -> None:
+        """
+        Destroy the shared memory once every process has closed it.
+        """
+        # An attach in a process sharing our resource tracker (e.g. a forked
+        # child) unregistered the name; unlink unregisters it again
+        resource_tracker.register(self._shm._name, "shared_memory")  # type: ignore[attr-defined]
+        self._shm.unlink()
+
+    def __enter__(self) -> "Ring":
+        return self
+
+    def __exit__(self, *exc: typing.Any) -> None:
+        self.close()
@@ -0,0 +1,142 @@
+import socket
+import threading
+import typing
+
+from qborsh.aio import FRAME_PREFIX, MAX_FRAME
+from qborsh.constants import BUFFER_SIZE
+from qborsh.csrc import Buffer
+from qborsh.types import BorshType
+
+IOV_MAX = 1024
+"""
+Segments per `sendmsg` call (the usual Linux IOV_MAX).
+"""
+
+_local = threading.local()
+
+
+def _buffer() -> Buffer:
+    """
+    This thread's reusable receive/send buffer.
+    """
+    buf = getattr(_local, "buffer", None)
+    if buf is None:
+        buf = _local.buffer = Buffer(BUFFER_SIZE)
+    return buf
+
+
+def _instance(schema: typing.Any) -> BorshType:
+    return schema if isinstance(schema, BorshType) else schema()
+
+
+def _recv_exactly(sock: socket.socket, view: memoryview) -> None:
+    received = 0
+    while received < len(view):
+        n = sock.recv_into(view[received:])
+        if n == 0:
+            if received:
+                raise ConnectionError("Connection closed in the middle of a frame.")
+            raise EOFError("Connection closed.")
+        received += n
+
+
+def recv_message(
+    sock: socket.socket,
+    schema: typing.Optional[BorshType] = None,
+    buffer: typing.Optional[Buffer] = None,
+    max_frame: int = MAX_FRAME,
+) -> typing.Any:
+    """
+    Receive one length-prefixed frame (see `qborsh.aio.FRAME_PREFIX`) and
+    decode it with `schema`, or return its bytes without one.
+
+    The payload is received with `recv_into` straight into `buffer` (by
+    default one reusable buffer per thread) and decoded from there. Raises
+    EOFError when the peer closed the connection between frames.
+    """
+    buf = buffer if buffer is not None else _buffer()
+
+    buf.reserve(FRAME_PREFIX.size)
+    with buf.data[: FRAME_PREFIX.size] as prefix:
+        _recv_exactly(sock, prefix)
+        (length,) = FRAME_PREFIX.unpack(prefix)
+    if length > max_frame:
+        raise ValueError(f"Frame of {length} bytes exceeds max_frame ({max_frame}).")
+
+    buf.reserve(length)
+    with buf.data[:length] as payload:
+        try:
+            _recv_exactly(sock, payload)
+        except EOFError:
+            raise ConnectionError("Connection closed in the middle of a frame.") from None
+        if schema is None:
+            return bytes(payload)
+    return _instance(schema).deserialize(buf)
+
+
+def _sendmsg_all(sock: socket.socket, segments: list) -> None:
+    """
+    Send `segments` with as few `sendmsg` calls as the kernel allows,
+    resuming after partial sends.
+    """
+    first = 0
+    while True:
+        # Consumed (or empty) segments are skipped, so a zero-byte send ends
+        while first < len(segments) and not len(segments[first]):
+            first += 1
+        if first == len(segments):
+            return
+        sent = sock.sendmsg(segments[first : first + IOV_MAX])
+        while sent:
+            head = segments[first]
+            if sent >= len(head):
+                sent -= len(head)
+                first += 1
+            else:
+                segments[first] = memoryview(head)[sent:]
+                sent = 0
+
+
+def send_messages(
+    sock: socket.socket,
+    schema: typing.Optional[BorshType],
+    records: typing.Iterable[typing.Any],
+    buffer: typing.Optional[Buffer] = None,
+) -> None:
+    """
+    Send `records` as length-prefixed frames in one batch.
+
+    With a `schema`, every frame is encoded back to back into `buffer` (by
+    default one reusable buffer per thread), with no bytes object per
+    record, and the batch goes out through `sendmsg`. Without one, records
+    are bytes-like and are sent as they are, their prefixes and payloads
+    gathered into `sendmsg` segments.
+    """
+    if schema is None:
+        segments: list = []
+        for record in records:
+            segments.append(FRAME_PREFIX.pack(len(record)))
+            segments.append(record)
+        _sendmsg_all(sock, segments)
+        return
+
+    instance = _instance(schema)
+    buf = buffer if buffer is not None else _buffer()
+    buf.reset()
+    for record in records:
+        start = buf.size
+        buf.write_u32(0)
+        instance.serialize(buf, record)
+        # Patch the length in now that the payload is written
+        with buf.data as data:
+            FRAME_PREFIX.pack_into(data, start, buf.size - start - FRAME_PREFIX.size)
+
+    with buf.data as data, data[: buf.size] as frames:
+        _sendmsg_all(sock, [frames])
+
+
+def send_message(sock: socket.socket, schema: typing.Optional[BorshType], record: typing.Any) -> None:
+    """
+    Send one record, see `send_messages`.
+    """
+    send_messages(sock, schema, (record,))
@@ -0,0 +1,195 @@
+import bisect
+import mmap
+import multiprocessing
+import os
+import pickle
+import typing
+from multiprocessing import resource_tracker, shared_memory
+
+from qborsh import csrc
+from qborsh.recordlog import MAGIC, RecordLog
+from qborsh.types import BorshType
+
+_job: typing.Optional[tuple] = None
+"""
+(schema, path, fn, indexed) of the running `decode_file`, set in every worker.
+"""
+
+
+def decode_all(schema: BorshType, data: typing.Any) -> list:
+    """
+    Decode records stored back to back in `data`, in place.
+    """
+    buf = csrc.Buffer(1)
+    buf.attach(data)
+    try:
+        size = len(data)
+        records = []
+        while buf.offset < size:
+            records.append(schema.deserialize(buf))
+        return records
+    finally:
+        buf.detach()
+        buf.free()
+
+
+def _init(schema: BorshType, path: str, fn: typing.Optional[typing.Callable], indexed: bool) -> None:
+    global _job
+    _job = (schema, path, fn, indexed)
+
+
+def _decode_shard(start: int, end: int) -> tuple[str, int]:
+    """
+    Decode a shard of the file and hand the (optionally processed) result
+    back in a shared memory block. Only the block's name goes through the
+    pool's pipe.
+
+    The shard is records [start, end) of a record log, or bytes [start, end)
+    of a file of back-to-back records.
+    """
+    assert _job is not None
+    schema, path, fn, indexed = _job
+    if indexed:
+        with RecordLog(path, schema=schema) as log:
+            records = [log[i] for i in range(start, end)]
+    else:
+        with (
+            open(path, "rb") as f,
+            mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped,
+            memoryview(mapped) as view,
+            view[start:end] as shard,
+        ):
+            records = decode_all(schema, shard)
+
+    result = fn(records) if fn is not None else records
+    data = pickle.dumps(result, protocol=pickle.HIGHEST_PROTOCOL)
+    block = shared_memory.SharedMemory(create=True, size=max(len(data), 1))
+    try:
+        block.buf[: len(data)] = data
+    except BaseException:
+        block.close()
+        block.unlink()
+        raise
+    # The parent owns (and unlinks) the block from here on; without this the
+    # worker's tracker could destroy it at exit before the parent reads it
+    resource_tracker.unregister(block._name, "shared_memory")  # type: ignore[attr-defined]
+    block.close()
+    return block.name, len(data)
+
+
+def _collect(name: str, size: int) -> typing.Any:
+    block = shared_memory.SharedMemory(name=name)
+    try:
+        return pickle.loads(block.buf[:size])
+    finally:
+        block.close()
+        block.unlink()
+
+
+def _unlink(name: str) -> None:
+    """
+    Unlink a block `_collect` did not get to.
+    """
+    try:
+        block = shared_memory.SharedMemory(name=name)
+    except FileNotFoundError:
+        return
+    block.close()
+    block.unlink()
+
+
+def _byte_shards(schema: BorshType, path: str, size: int, workers: int) -> list[tuple[int, int]]:
+    """
+    Shards of about size / workers bytes, cut at record boundaries found
+    natively (see `split_records`).
+    """
+    with open(path, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+        bounds = csrc.split_records(schema.compile(), mapped, max(1, size // (workers * 64)))
+    picked = set()
+    for k in range(1, workers):
+        cut = bounds[min(bisect.bisect_left(bounds, size * k // workers), len(bounds) - 1)]
+        if cut < size:
+            picked.add(cut)
+    cuts = sorted(picked) + [size]
+    return list(zip([0] + cuts[:-1], cuts))
+
+
+def decode_file(
+    schema: BorshType,
+    path: typing.Union[str, os.PathLike],
+    workers: typing.Optional[int] = None,
+    fn: typing.Optional[typing.Callable[[list], typing.Any]] = None,
+) -> list:
+    """
+    Decode a file of records on `workers` processes (one per core by
+    default). Meant for one-shot offline jobs where threads cannot decode in
+    parallel.
+
+    A `RecordLog` is split into equal runs of records using its index (the
+    footer, or the frames walked natively when the log was not closed), and
+    each worker opens the log and decodes its run. Any other file is taken
+    as back-to-back records and split into one shard per worker at record
+    boundaries found natively (see `split_records`); each worker
+    memory-maps and decodes its shard. With `fn`, a worker reduces its
+    shard's records to a result. Results come back through shared memory
+    rather than the pool's pipe, and every block is unlinked even when a
+    shard fails.
+
+    Returns the decoded records in file order, or the list of `fn` results
+    in shard order.
+
+    Example:
+        >>> totals = qborsh.parallel.decode_file(
+        ...     Transfer, "transfers.bin", workers=8,
+        ...     fn=lambda rs: sum(r["amount"] for r in rs),
+        ... )
+        >>> sum(totals)
+    """
+    path = os.fspath(path)
+    if workers is None:
+        workers = os.cpu_count() or 1
+    if workers < 1:
+        raise ValueError(f"workers must be >= 1. Received: {workers}")
+
+    size = os.path.getsize(path)
+    with open(path, "rb") as f:
+        indexed = f.read(len(MAGIC)) == MAGIC
+
+    if indexed:
+        with RecordLog(path, schema=schema) as log:
+            count = len(log)
+            shards = [(count * k // workers, count * (k + 1) // workers) for k in range(workers)]
+            shards = [shard for shard in shards if shard[0] < shard[1]]
+            if len(shards) <= 1:
+                records = list(log)
+                return [fn(records)] if fn is not None else records
+    else:
+        if size == 0:
+            return [fn([])] if fn is not None else []
+        shards = _byte_shards(schema, path, size, workers)
+        if len(shards) == 1:
+            with open(path, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+                with memoryview(mapped) as view:
+                    records = decode_all(schema, view)
+            return [fn(records)] if fn is not None else records
+
+    # Forked workers inherit the schema and `fn`, so neither has to pickle
+    methods = multiprocessing.get_all_start_methods()
+    context = multiprocessing.get_context("fork" if "fork" in methods else None)
+    with context.Pool(len(shards), initializer=_init, initargs=(schema, path, fn, indexed)) as pool:
+        pending = [pool.apply_async(_decode_shard, shard) for shard in shards]
+        # Let every shard finish before the pool goes, so no block is left behind
+        for result in pending:
+            result.wait()
+    blocks = [result.get() for result in pending if result.successful()]
+    try:
+        for result in pending:
+            result.get()  # the first failure, if any
+        results = [_collect(*block) for block in blocks]
+    finally:
+        for name, _ in blocks:
+            _unlink(name)
+
+    if fn is not None:
+        return results
+    return [record for shard in results for record in shard]
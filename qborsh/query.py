@@ -0,0 +1,129 @@
+import os
+import typing
+
+from qborsh import csrc
+from qborsh.records import RecordSource, open_records
+from qborsh.types import Bool, Schema
+from qborsh.types.numeric import _Numeric
+
+_COMPARISONS = {"==", "!=", "<", "<=", ">", ">="}
+_AGGREGATES = {"count", "sum", "min", "max"}
+_GROUP_OPS = _AGGREGATES | {"histogram"}
+
+
+def _workers(workers: typing.Optional[int]) -> int:
+    return workers if workers is not None else (os.cpu_count() or 1)
+
+
+def _filter(schema: Schema, field: str, cmp: str, value: typing.Any) -> tuple:
+    """
+    Native form of the filter `field cmp value`. Non-numeric values are
+    compared by their encoding.
+    """
+    if cmp not in _COMPARISONS:
+        raise ValueError(f"Unknown comparison: {cmp}")
+    path, field_type = schema.field_path(field)
+    if not isinstance(field_type, (_Numeric, Bool)):
+        value = field_type.encode(value)
+    return (path, cmp, value)
+
+
+def scan(
+    schema: Schema,
+    source: RecordSource,
+    ops: typing.Sequence[tuple],
+    workers: typing.Optional[int] = None,
+) -> list[typing.Any]:
+    """
+    Evaluate `ops` over every record in `source` natively: records are split
+    into chunks and processed on a work-stealing thread pool, without
+    creating Python objects per record. Returns one result per aggregate op,
+    in order.
+
+    Ops (field names may be dotted to reach into nested schemas):
+
+        ("count",)                      number of matching records
+        ("sum" | "min" | "max", field)  over a numeric field (exact ints)
+        ("filter", field, cmp, value)   keep records where `field cmp value`
+
+    All filters apply to all aggregates. `cmp` is one of ==, !=, <, <=, >, >=;
+    non-numeric fields (strings, pubkeys, ...) support == and != only.
+
+    Example:
+        >>> qborsh.scan(Transfer, "transfers.bin", [
+        ...     ("filter", "slot", ">=", 1000),
+        ...     ("count",),
+        ...     ("sum", "amount"),
+        ... ])
+        [52, 1093877]
+    """
+    filters = []
+    aggregates = []
+    for op in ops:
+        if isinstance(op, str):
+            op = (op,)
+        kind = op[0]
+        if kind == "filter":
+            if len(op) != 4 or op[2] not in _COMPARISONS:
+                raise ValueError(f"Expected ('filter', field, cmp, value). Received: {op}")
+            filters.append(_filter(schema, *op[1:]))
+        elif kind == "count":
+            aggregates.append(("count", None))
+        elif kind in _AGGREGATES and len(op) == 2:
+            aggregates.append((kind, schema.field_path(op[1])[0]))
+        else:
+            raise ValueError(f"Unknown scan op: {op}")
+
+    with open_records(source) as records:
+        return csrc.scan(schema.compile(), records, filters, aggregates, workers=_workers(workers))
+
+
+def aggregate(
+    schema: Schema,
+    source: RecordSource,
+    field: typing.Optional[str],
+    op: str,
+    group_by: typing.Optional[str] = None,
+    bins: typing.Optional[typing.Sequence[typing.Union[int, float]]] = None,
+    where: typing.Sequence[tuple] = (),
+    workers: typing.Optional[int] = None,
+) -> typing.Any:
+    """
+    Compute `op` over `field` of every record in `source` natively, like
+    `scan`. With `group_by`, returns a dict from each decoded key value to its
+    result; keys are hashed by their encoded bytes.
+
+    Ops:
+
+        "count"                         number of records (`field` may be None)
+        "sum" | "min" | "max"           exact for every integer width
+        "histogram"                     counts per bucket between sorted `bins`
+                                        edges; the last bucket includes its
+                                        upper edge, values outside are dropped
+
+    `where` holds (field, cmp, value) filters, as in `scan`.
+
+    Example:
+        >>> Transfer.aggregate("transfers.bin", "amount", "sum", group_by="mint")
+        {'So11111111111111111111111111111111111111112': 1093877, ...}
+    """
+    if op not in _GROUP_OPS:
+        raise ValueError(f"Unknown aggregate: {op}")
+    field_path = schema.field_path(field)[0] if field is not None else None
+    key_path, key_type = schema.field_path(group_by) if group_by is not None else (None, None)
+    filters = [_filter(schema, *condition) for condition in where]
+
+    with open_records(source) as records:
+        result = csrc.aggregate(
+            schema.compile(),
+            records,
+            op,
+            field=field_path,
+            group_by=key_path,
+            bins=bins,
+            filters=filters,
+            workers=_workers(workers),
+        )
+    if key_type is None:
+        return result
+    return {key_type.decode(key): value for key, value in result.items()}
@@ -0,0 +1,445 @@
+import array
+import bisect
+import mmap
+import os
+import struct
+import typing
+
+from qborsh import csrc
+from qborsh.codecs import Codec, ZlibCodec, get_codec
+from qborsh.types import BorshType
+
+MAGIC = b"QBRLOG\x00\x00"
+VERSION = 1
+
+FLAG_BLOCKED = 1
+"""
+Header flag: records are grouped into compressed blocks.
+"""
+
+DEFAULT_BLOCK_SIZE = 64 * 1024
+
+_HEADER = struct.Struct("<8sII")  # magic, version, flags
+_FRAME = struct.Struct("<II")  # payload length, crc32c(payload)
+_TRAILER = struct.Struct("<QQII8s")  # entries, footer offset, crc32c(footer), reserved, magic
+_TRAILER_MAGIC = b"QBRLEND\x00"
+
+
+def _frame(payload: typing.Union[bytes, bytearray, memoryview]) -> bytes:
+    length = len(payload)
+    if length > 0xFFFFFFFF:
+        raise ValueError("Record exceeds 4 GiB.")
+    return _FRAME.pack(length, csrc.crc32c(payload))
+
+
+class RecordLog:
+    """
+    Append-only file of Borsh records with random access.
+
+    Layout:
+
+        header      magic, version, flags
+        frames      u32 length | u32 CRC-32C | payload, one per record
+        footer      u64 offset of every frame (8-byte aligned)
+        trailer     footer entries, footer offset, CRC-32C of the footer, magic
+
+    The footer is written on `close`. A log that was not closed cleanly is
+    still readable: its frames are walked natively up to the first torn or
+    corrupt one. Offsets are stored in host byte order.
+
+    With a `codec` (e.g. "zlib", see `qborsh.codecs`), record frames are
+    packed into blocks of about `block_size` bytes and every block is
+    compressed into one frame, preceded by a frame naming the codec. The
+    footer then holds the offset of every block and its first record
+    number (each followed by a sentinel), so reads decompress only the
+    blocks they touch.
+
+    Reading memory-maps the file. `log[i]` checks the frame's checksum and
+    decodes the payload in place (no copy) with `schema`, or returns a
+    zero-copy memoryview of it without one.
+
+    Example:
+        >>> with qborsh.RecordLog("transfers.log", "w", schema=Transfer) as log:
+        ...     log.extend(transfers)
+        >>> with qborsh.RecordLog("transfers.log", schema=Transfer) as log:
+        ...     log[1_000_000]["amount"]
+    """
+
+    def __init__(
+        self,
+        path: typing.Union[str, os.PathLike],
+        mode: str = "r",
+        schema: typing.Optional[BorshType] = None,
+        verify: bool = True,
+        codec: typing.Union[str, Codec, None] = None,
+        block_size: int = DEFAULT_BLOCK_SIZE,
+    ):
+        if mode not in ("r", "w", "a"):
+            raise ValueError(f"Mode must be 'r', 'w' or 'a'. Received: {mode}")
+
+        self.path = path
+        self.mode = mode
+        self.schema = schema
+        self.verify = verify
+        self.codec: typing.Optional[Codec] = get_codec(codec) if codec is not None else None
+        self.block_size = block_size
+        self.recovered = False
+
+        self._file: typing.Optional[typing.BinaryIO] = None
+        self._map: typing.Optional[mmap.mmap] = None
+        self._view: typing.Optional[memoryview] = None
+        self._offsets: typing.Any = array.array("Q")
+        self._end = _HEADER.size
+
+        # Blocked logs: block offsets and first record numbers, each with a
+        # trailing sentinel (end of the last block, record count)
+        self._blocks: typing.Any = array.array("Q")
+        self._firsts: typing.Any = array.array("Q", [0])
+        self._pending = bytearray()
+        self._pending_count = 0
+        self._cached: typing.Optional[tuple[int, memoryview, typing.Any]] = None
+
+        # Appending to a missing (or empty) file starts a new log, like open(..., "ab")
+        if mode == "a" and (not os.path.exists(path) or os.path.getsize(path) == 0):
+            mode = "w"
+
+        if mode == "w":
+            self._file = open(path, "wb")
+            self._file.write(_HEADER.pack(MAGIC, VERSION, FLAG_BLOCKED if self.codec else 0))
+            if self.codec is not None:
+                name = self.codec.name.encode()
+                self._file.write(_frame(name) + name)
+                self._end += _FRAME.size + len(name)
+            self._blocks.append(self._end)
+        elif mode == "a":
+            self._open_map()
+            offsets = array.array("Q", self._offsets)
+            blocks = array.array("Q", self._blocks)
+            firsts = array.array("Q", self._firsts)
+            self._close_map()
+            self._offsets, self._blocks, self._firsts = offsets, blocks, firsts
+            self._file = open(path, "r+b")
+            self._file.truncate(self._end)
+            self._file.seek(self._end)
+        else:
+            self._open_map()
+
+    @property
+    def blocked(self) -> bool:
+        return self.codec is not None
+
+    # -----------------------------------------------------
+    # Opening
+    # -----------------------------------------------------
+
+    def _open_map(self) -> None:
+        with open(self.path, "rb") as f:
+            size = os.fstat(f.fileno()).st_size
+            if size < _HEADER.size:
+                raise ValueError(f"{self.path} is not a record log.")
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self._view = memoryview(self._map)
+
+        magic, version, flags = _HEADER.unpack_from(self._map)
+        if magic != MAGIC:
+            raise ValueError(f"{self.path} is not a record log.")
+        if version != VERSION:
+            raise ValueError(f"Unsupported record log version: {version}")
+
+        start = _HEADER.size
+        if flags & FLAG_BLOCKED:
+            offset, length = csrc.frame_span(self._map, start, True)
+            self.codec = get_codec(bytes(self._view[offset : offset + length]).decode())
+            start = offset + length
+        elif self.codec is not None:
+            raise ValueError(f"{self.path} is not block-compressed.")
+
+        if not self._load_footer(size):
+            self._recover(start)
+
+    def _load_footer(self, size: int) -> bool:
+        if size < _HEADER.size + _TRAILER.size:
+            return False
+        entries, footer_offset, footer_crc, _, magic = _TRAILER.unpack_from(self._map, size - _TRAILER.size)
+        width = 16 if self.blocked else 8
+        footer_end = footer_offset + width * entries
+        if (
+            magic != _TRAILER_MAGIC
+            or footer_offset % 8
+            or footer_offset < _HEADER.size
+            or footer_end != size - _TRAILER.size
+        ):
+            return False
+
+        footer = self._view[footer_offset:footer_end]
+        if csrc.crc32c(footer) != footer_crc:
+            footer.release()
+            return False
+        footer = footer.cast("Q")
+
+        if self.blocked:
+            self._blocks, self._firsts = footer[:entries], footer[entries:]
+            self._end = self._blocks[-1]
+            return True
+
+        self._offsets = footer
+        # Frames end where the footer's alignment padding starts
+        if entries:
+            start, length = csrc.frame_span(self._map, self._offsets[-1], False)
+            self._end = start + length
+        return True
+
+    def _recover(self, start: int) -> None:
+        packed, self._end = csrc.scan_frames(self._map, start, self.verify)
+        self.recovered = True
+        if not self.blocked:
+            self._offsets = memoryview(packed).cast("Q")
+            return
+
+        # Count the records of every intact block
+        self._blocks = array.array("Q", memoryview(packed).cast("Q"))
+        self._firsts = array.array("Q", [0])
+        for b in range(len(self._blocks)):
+            _, offsets = self._load_block(b)
+            self._firsts.append(self._firsts[-1] + len(offsets))
+        self._blocks.append(self._end)
+        self._cached = None
+
+    def _close_map(self) -> None:
+        self._cached = None
+        for table in (self._offsets, self._blocks, self._firsts):
+            if isinstance(table, memoryview):
+                table.release()
+        if self._view is not None:
+            self._view.release()
+            self._view = None
+        if self._map is not None:
+            self._map.close()
+            self._map = None
+
+    # -----------------------------------------------------
+    # Writing
+    # -----------------------------------------------------
+
+    def append(self, value: typing.Any) -> int:
+        """
+        Append one record (encoded with `schema`, or bytes-like without one)
+        and return its position.
+        """
+        if self._file is None:
+            raise ValueError("Record log is not open for writing.")
+        payload = self.schema.encode(value) if self.schema is not None else value
+        header = _frame(payload)
+
+        if self.blocked:
+            self._pending += header
+            self._pending += payload
+            self._pending_count += 1
+            if len(self._pending) >= self.block_size:
+                self._write_block()
+            return self._firsts[-1] + self._pending_count - 1
+
+        self._file.write(header)
+        self._file.write(payload)
+        self._offsets.append(self._end)
+        self._end += _FRAME.size + len(payload)
+        return len(self._offsets) - 1
+
+    def extend(self, values: typing.Iterable[typing.Any]) -> None:
+        for value in values:
+            self.append(value)
+
+    def _write_block(self) -> None:
+        assert self._file is not None and self.codec is not None
+        if not self._pending_count:
+            return
+        block = self.codec.compress(bytes(self._pending))
+        self._file.write(_frame(block))
+        self._file.write(block)
+        self._end += _FRAME.size + len(block)
+        self._blocks.append(self._end)
+        self._firsts.append(self._firsts[-1] + self._pending_count)
+        self._pending = bytearray()
+        self._pending_count = 0
+
+    def flush(self, fsync: bool = False) -> None:
+        """
+        Flush appended records to the OS (and to disk with `fsync`). Flushed
+        records survive a crash even before `close` writes the footer. For
+        blocked logs this also ends the current block.
+        """
+        if self._file is not None:
+            if self.blocked:
+                self._write_block()
+            self._file.flush()
+            if fsync:
+                os.fsync(self._file.fileno())
+
+    def _write_footer(self) -> None:
+        assert self._file is not None
+        if self.blocked:
+            self._write_block()
+            footer = self._blocks.tobytes() + self._firsts.tobytes()
+            entries = len(self._blocks)
+        else:
+            footer = self._offsets.tobytes()
+            entries = len(self._offsets)
+
+        padding = -self._end % 8
+        self._file.write(b"\x00" * padding)
+        self._file.write(footer)
+        self._file.write(_TRAILER.pack(entries, self._end + padding, csrc.crc32c(footer), 0, _TRAILER_MAGIC))
+
+    # -----------------------------------------------------
+    # Reading
+    # -----------------------------------------------------
+
+    def __len__(self) -> int:
+        if self.blocked:
+            return self._firsts[-1] + self._pending_count
+        return len(self._offsets)
+
+    def _load_block(self, b: int) -> tuple[memoryview, typing.Any]:
+        """
+        Decompressed block `b` and the offsets of its record frames. The last
+        block read is cached, so sequential reads decompress each block once.
+        """
+        if self._cached is not None and self._cached[0] == b:
+            return self._cached[1], self._cached[2]
+
+        start, length = csrc.frame_span(self._map, self._blocks[b], self.verify)
+        assert self.codec is not None and self._view is not None
+        with self._view[start : start + length] as compressed:
+            block = self.codec.decompress(compressed)
+        self._cached = (b, memoryview(block), self._block_offsets(b, block))
+        return self._cached[1], self._cached[2]
+
+    def _block_offsets(self, b: int, block: typing.Any) -> typing.Any:
+        packed, end = csrc.scan_frames(block, 0, self.verify)
+        if end != len(block):
+            raise ValueError(f"Block {b} is truncated or corrupt.")
+        return memoryview(packed).cast("Q")
+
+    def blocks(self, readahead: int = 4) -> typing.Iterator[tuple[int, memoryview, typing.Any]]:
+        """
+        Yield (first record number, decompressed block, record frame offsets)
+        for every block in order. A native thread reads and checks up to
+        `readahead` blocks ahead of the caller, and inflates them too for
+        zlib logs; other codecs decompress on the calling thread.
+        """
+        if not self.blocked:
+            raise ValueError("Record log is not block-compressed.")
+        if self._view is None:
+            raise ValueError("Record log is not open for reading.")
+
+        inflate = isinstance(self.codec, ZlibCodec)
+        with open(self.path, "rb") as f:
+            reader = csrc.Readahead(f.fileno(), self._blocks.tobytes(), readahead, self.verify, inflate)
+        try:
+            for b, block, packed in reader:
+                if packed is None:
+                    assert self.codec is not None
+                    with memoryview(block) as compressed:
+                        block = self.codec.decompress(compressed)
+                    offsets = self._block_offsets(b, block)
+                else:
+                    offsets = memoryview(packed).cast("Q")
+                yield self._firsts[b], memoryview(block), offsets
+        finally:
+            reader.close()
+
+    def view(self, i: int) -> memoryview:
+        """
+        Zero-copy view of the payload of record `i` (inside its decompressed
+        block, for blocked logs).
+        """
+        if self._view is None:
+            raise ValueError("Record log is not open for reading.")
+        count = len(self)
+        if i < 0:
+            i += count
+        if not 0 <= i < count:
+            raise IndexError("Record log index out of range.")
+
+        if self.blocked:
+            b = bisect.bisect_right(self._firsts, i) - 1
+            block, offsets = self._load_block(b)
+            start, length = csrc.frame_span(block, offsets[i - self._firsts[b]], False)
+            return block[start : start + length]
+
+        start, length = csrc.frame_span(self._map, self._offsets[i], self.verify)
+        return self._view[start : start + length]
+
+    def __getitem__(self, i: int) -> typing.Any:
+        payload = self.view(i)
+        if self.schema is None:
+            return payload
+        try:
+            return self.schema.decode(payload)
+        finally:
+            payload.release()
+
+    def __iter__(self) -> typing.Iterator[typing.Any]:
+        if not self.blocked or self._view is None:
+            for i in range(len(self)):
+                yield self[i]
+            return
+
+        # Blocks stream in through the read-ahead thread while this one decodes
+        for _, block, offsets in self.blocks():
+            for offset in offsets:
+                start, length = csrc.frame_span(block, offset, False)
+                payload = block[start : start + length]
+                if self.schema is None:
+                    yield payload
+                    continue
+                try:
+                    yield self.schema.decode(payload)
+                finally:
+                    payload.release()
+
+    def check(self) -> None:
+        """
+        Verify the checksum of every record (and block) natively. Raises
+        ValueError at the first corrupt one.
+        """
+        if self._map is None:
+            raise ValueError("Record log is not open for reading.")
+        if self.blocked:
+            expected = self._blocks.tobytes()[:-8]
+            packed, _ = csrc.scan_frames(self._map, self._blocks[0], True)
+            if packed[: len(expected)] != expected:
+                raise ValueError(f"Block {len(packed) // 8} is truncated or corrupt.")
+            for b in range(len(self._blocks) - 1):
+                self._load_block(b)
+            return
+
+        expected = self._offsets.tobytes()
+        packed, _ = csrc.scan_frames(self._map, _HEADER.size, True)
+        if packed[: len(expected)] != expected:
+            found = len(packed) // 8
+            raise ValueError(f"Record {found} is truncated or corrupt.")
+
+    # -----------------------------------------------------
+    # Lifetime
+    # -----------------------------------------------------
+
+    def close(self) -> None:
+        if self._file is not None:
+            self._write_footer()
+            self._file.close()
+            self._file = None
+        self._close_map()
+
+    def __enter__(self) -> "RecordLog":
+        return self
+
+    def __exit__(self, *exc: typing.Any) -> None:
+        self.close()
+
+    def __del__(self) -> None:
+        # Without a footer the log is still recoverable, so never write one
+        # from a finalizer
+        file = getattr(self, "_file", None)
+        if file is not None:
+            file.close()
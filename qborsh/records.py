@@ -0,0 +1,31 @@
+import contextlib
+import mmap
+import os
+import typing
+
+RecordSource = typing.Union[bytes, bytearray, memoryview, mmap.mmap, typing.Sequence[bytes], str, os.PathLike]
+"""
+Encoded records accepted by the native engines. Either:
+
+    1. One bytes-like object holding records back to back.
+    2. A sequence of bytes-like objects, one record each.
+    3. A path to a file holding records back to back (memory-mapped).
+"""
+
+
+@contextlib.contextmanager
+def open_records(source: RecordSource) -> typing.Iterator[typing.Any]:
+    """
+    Yield `source` in a form the native engines accept. Paths are
+    memory-mapped read-only for the duration of the block; nothing is copied.
+    """
+    if not isinstance(source, (str, os.PathLike)):
+        yield source
+        return
+
+    with open(source, "rb") as f:
+        if os.fstat(f.fileno()).st_size == 0:
+            yield b""
+            return
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+            yield mapped
@@ -0,0 +1,155 @@
+import hashlib
+import typing
+
+from qborsh import csrc
+from qborsh.csrc import Buffer, Layout
+from qborsh.types import BorshType
+
+WIDTHS = (1, 4, 8)
+"""
+Supported discriminator widths: u8 enum tags, u32 tags and Anchor's 8-byte hashes.
+"""
+
+
+def _instance(schema: typing.Any) -> typing.Union[BorshType, Layout]:
+    return schema if isinstance(schema, (BorshType, Layout)) else schema()
+
+
+class Registry:
+    """
+    Maps discriminator prefixes to schemas, for streams that mix record types
+    (Anchor accounts, instructions and events all start with an 8-byte
+    discriminator).
+
+    Schemas with a native layout are dispatched in C: the discriminator is
+    looked up in an open-addressing hash table (one hash and usually a
+    single key compare) and the payload after it is decoded in place by the
+    matching layout. Schemas without one fall back to a dict lookup and
+    `deserialize`. Registering after decoding adds to the table in place.
+
+    Example:
+        >>> registry = qborsh.Registry()
+        >>> registry.register(qborsh.Registry.anchor_discriminator("account", "Pool"), Pool)
+        >>> registry.register(qborsh.Registry.anchor_discriminator("account", "Position"), Position)
+        >>> registry.decode_many(account_datas, tagged=True)
+        [('Pool', {...}), ('Position', {...}), ...]
+    """
+
+    def __init__(self, width: int = 8):
+        if width not in WIDTHS:
+            raise ValueError(f"Discriminator width must be one of {WIDTHS}. Received: {width}")
+        self.width = width
+        self._schemas: dict[bytes, tuple[str, typing.Union[BorshType, Layout]]] = {}
+        self._native: typing.Optional[csrc.Dispatch] = None
+        self._fallback: dict[bytes, tuple[str, BorshType]] = {}
+
+    @staticmethod
+    def anchor_discriminator(namespace: str, name: str) -> bytes:
+        """
+        Anchor's discriminator: the first 8 bytes of sha256("namespace:name"),
+        e.g. ("account", "Pool"), ("global", "swap") or ("event", "Swapped").
+        """
+        return hashlib.sha256(f"{namespace}:{name}".encode()).digest()[:8]
+
+    def register(
+        self,
+        discriminator: typing.Union[bytes, int],
+        schema: typing.Any,
+        name: typing.Optional[str] = None,
+    ) -> None:
+        """
+        Decode payloads starting with `discriminator` (bytes of the registry's
+        width, or an int stored little-endian) with `schema`, a type or a
+        compiled `Layout`. `name` tags the values of tagged decodes and
+        defaults to the schema's class name.
+        """
+        if isinstance(discriminator, int):
+            discriminator = discriminator.to_bytes(self.width, "little")
+        discriminator = bytes(discriminator)
+        if len(discriminator) != self.width:
+            raise ValueError(f"Discriminator of {len(discriminator)} bytes, expected {self.width}.")
+        if discriminator in self._schemas:
+            raise ValueError(f"Discriminator {discriminator.hex()} is already registered.")
+
+        instance = _instance(schema)
+        if name is None:
+            name = type(instance).__name__
+        if self._native is not None:
+            self._add(self._native, self._fallback, discriminator, name, instance)
+        self._schemas[discriminator] = (name, instance)
+
+    def __len__(self) -> int:
+        return len(self._schemas)
+
+    def __contains__(self, discriminator: bytes) -> bool:
+        return bytes(discriminator) in self._schemas
+
+    def schema(self, data: typing.Union[bytes, bytearray, memoryview]) -> typing.Union[BorshType, Layout, None]:
+        """
+        The schema registered for the discriminator `data` starts with, or None.
+        """
+        entry = self._schemas.get(bytes(data[: self.width]))
+        return entry[1] if entry is not None else None
+
+    @staticmethod
+    def _add(
+        dispatch: csrc.Dispatch,
+        fallback: dict,
+        discriminator: bytes,
+        name: str,
+        instance: typing.Union[BorshType, Layout],
+    ) -> None:
+        if isinstance(instance, Layout):
+            dispatch.add(discriminator, instance, name)
+        elif instance.layout() is not None:
+            dispatch.add(discriminator, instance.compile(), name)
+        else:
+            fallback[discriminator] = (name, instance)
+
+    def _dispatch(self) -> csrc.Dispatch:
+        dispatch = self._native
+        if dispatch is None:
+            dispatch, fallback = csrc.Dispatch(self.width, ()), {}
+            for discriminator, (name, instance) in self._schemas.items():
+                self._add(dispatch, fallback, discriminator, name, instance)
+            self._native, self._fallback = dispatch, fallback
+        return dispatch
+
+    def _decode_fallback(self, data: typing.Any, tagged: bool) -> typing.Any:
+        with memoryview(data) as view:
+            entry = self._fallback.get(bytes(view[: self.width]))
+            if entry is None:
+                raise KeyError(bytes(view[: self.width]))
+            name, instance = entry
+            buf = Buffer(1)
+            buf.attach(view[self.width :])
+            try:
+                value = instance.deserialize(buf)
+            finally:
+                buf.detach()
+                buf.free()
+        return (name, value) if tagged else value
+
+    def decode(self, data: typing.Union[bytes, bytearray, memoryview], tagged: bool = False) -> typing.Any:
+        """
+        Decode the payload after the discriminator with the schema registered
+        for it, returning (name, value) when `tagged`. Raises KeyError for an
+        unknown discriminator.
+        """
+        dispatch = self._dispatch()
+        if not self._fallback:
+            return dispatch.decode(data, tagged)
+        try:
+            return dispatch.decode(data, tagged)
+        except KeyError:
+            return self._decode_fallback(data, tagged)
+
+    def decode_many(self, records: typing.Iterable[typing.Any], tagged: bool = False) -> list:
+        """
+        Decode a batch of payloads of any registered type, see `decode`. With
+        only native schemas the whole batch is dispatched in one native call.
+        """
+        dispatch = self._dispatch()
+        if not self._fallback:
+            return dispatch.decode_many(records if isinstance(records, (list, tuple)) else list(records), tagged)
+        return [self.decode(record, tagged) for record in records]
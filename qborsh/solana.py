@@ -0,0 +1,107 @@
+import typing
+
+from qborsh.csrc import Buffer
+from qborsh.types import U8, BorshType, FixedBytes, ShortBytes, ShortVec, View, schema
+
+Key = FixedBytes[32]
+"""
+Account keys and blockhashes, as raw 32 bytes.
+"""
+
+Signature = FixedBytes[64]
+
+
+class Versioned(BorshType):
+    """
+    A Solana message that is either legacy (starting right with its header)
+    or versioned (starting with a `0x80 | version` byte). Decodes to the
+    message's dict with a "version" key, "legacy" or the version number;
+    encoding picks the layout from that key.
+
+    `Versioned[Legacy, V0, ...]` takes the legacy schema, then one per
+    version. Every part must have a native layout, the prefix being
+    dispatched in C with the rest of the message.
+    """
+
+    def __init__(self, legacy: BorshType, *versions: BorshType):
+        self.legacy = legacy
+        self.versions = versions
+        self._program = self.compile()
+
+    def serialize(self, buf: Buffer, value: typing.Any) -> None:
+        self._program.write(buf, value)
+
+    def deserialize(self, buf: Buffer) -> typing.Any:
+        return self._program.read(buf)
+
+    def sizeof(self) -> None:
+        return None
+
+    def layout(self) -> typing.Optional[tuple]:
+        legacy = self.legacy.layout()
+        versions = tuple(version.layout() for version in self.versions)
+        if legacy is None or None in versions:
+            return None
+        return ("versioned", legacy, versions)
+
+
+@schema
+class MessageHeader:
+    num_required_signatures: U8
+    num_readonly_signed_accounts: U8
+    num_readonly_unsigned_accounts: U8
+
+
+@schema
+class CompiledInstruction:
+    program_id_index: U8
+    accounts: ShortBytes
+    data: View[ShortBytes]
+
+
+@schema
+class AddressTableLookup:
+    account_key: Key
+    writable_indexes: ShortBytes
+    readonly_indexes: ShortBytes
+
+
+@schema
+class LegacyMessage:
+    header: MessageHeader
+    account_keys: ShortVec[Key]
+    recent_blockhash: Key
+    instructions: ShortVec[CompiledInstruction]
+
+
+@schema
+class MessageV0:
+    header: MessageHeader
+    account_keys: ShortVec[Key]
+    recent_blockhash: Key
+    instructions: ShortVec[CompiledInstruction]
+    address_table_lookups: ShortVec[AddressTableLookup]
+
+
+Message = Versioned[LegacyMessage, MessageV0]
+
+
+@schema
+class Transaction:
+    """
+    A serialized Solana transaction (legacy or v0), decoded in one native
+    call. Keys and the blockhash are raw 32 bytes, instruction accounts are
+    bytes of account indexes and instruction data is a memoryview of the
+    transaction itself when it is bytes (a copy otherwise, see `View`), so
+    nothing is base58 encoded.
+
+    Example:
+        >>> tx = qborsh.solana.Transaction.decode(raw)
+        >>> tx["message"]["version"]
+        0
+        >>> ix = tx["message"]["instructions"][0]
+        >>> program = tx["message"]["account_keys"][ix["program_id_index"]]
+    """
+
+    signatures: ShortVec[Signature]
+    message: Message
@@ -0,0 +1,92 @@
+import array
+import contextlib
+import mmap
+import os
+import tempfile
+import typing
+
+from qborsh import csrc
+from qborsh.query import _workers
+from qborsh.records import RecordSource, open_records
+from qborsh.types import Schema
+
+DEFAULT_RUN_BYTES = 256 * 1024 * 1024
+
+
+def sort(
+    schema: Schema,
+    source: RecordSource,
+    key: str,
+    reverse: bool = False,
+    permutation: bool = False,
+    workers: typing.Optional[int] = None,
+) -> typing.Union[bytes, array.array]:
+    """
+    Order the records in `source` by the field `key` without decoding them.
+    Integer and float keys are radix sorted by value; strings and bytes by
+    content and other keys (e.g. `PubKey`) by their encoded bytes. The sort is
+    stable.
+
+    Returns the records back to back in key order, or with `permutation`,
+    an `array("Q")` of record numbers in key order.
+
+    Example:
+        >>> ordered = Transfer.sort(blob, key="slot")
+    """
+    path = schema.field_path(key)[0]
+    with open_records(source) as records:
+        result = csrc.sort(
+            schema.compile(),
+            records,
+            path,
+            reverse=reverse,
+            permutation=permutation,
+            workers=_workers(workers),
+        )
+    if not permutation:
+        return result
+    indices = array.array("Q")
+    indices.frombytes(result)
+    return indices
+
+
+def sort_file(
+    schema: Schema,
+    source: typing.Union[str, os.PathLike],
+    destination: typing.Union[str, os.PathLike],
+    key: str,
+    reverse: bool = False,
+    run_bytes: int = DEFAULT_RUN_BYTES,
+    tmp_dir: typing.Optional[str] = None,
+    workers: typing.Optional[int] = None,
+) -> None:
+    """
+    External merge sort of a record file that may not fit in memory. The
+    input is memory-mapped and cut into runs of about `run_bytes`, each run is
+    sorted like `sort` and spilled to `tmp_dir`, then all runs are merged
+    natively into `destination`. Records stay encoded throughout.
+    """
+    layout = schema.compile()
+    path = schema.field_path(key)[0]
+
+    with open_records(source) as records, open(destination, "wb") as out:
+        bounds = csrc.split_records(layout, records, run_bytes)
+        if len(bounds) <= 1:
+            out.write(sort(schema, records, key, reverse=reverse, workers=workers))
+            return
+
+        with tempfile.TemporaryDirectory(dir=tmp_dir) as spill, contextlib.ExitStack() as stack:
+            runs = []
+            with memoryview(records) as view:
+                start = 0
+                for index, end in enumerate(bounds):
+                    run_path = os.path.join(spill, f"run-{index}")
+                    with open(run_path, "wb") as run:
+                        run.write(csrc.sort(layout, view[start:end], path, reverse=reverse, workers=_workers(workers)))
+                    start = end
+
+                    with open(run_path, "rb") as run:
+                        runs.append(stack.enter_context(mmap.mmap(run.fileno(), 0, access=mmap.ACCESS_READ)))
+
+            out.flush()
+            csrc.merge_sorted(layout, runs, path, out.fileno(), reverse=reverse)
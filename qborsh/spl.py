@@ -0,0 +1,464 @@
+import struct
+import typing
+
+from qborsh.csrc import Buffer, Layout
+from qborsh.types import (
+    F64,
+    I16,
+    I64,
+    U8,
+    U16,
+    U64,
+    Array,
+    Bool,
+    COption,
+    FixedBytes,
+    PubKey,
+    String,
+    Tuple,
+    Vector,
+    schema,
+)
+
+TOKEN_PROGRAM_ID = "TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA"
+TOKEN_2022_PROGRAM_ID = "TokenzQdBNbLqP5VEhdkAS6EPFLC1PHnBqCXEpPxuEb"
+SYSTEM_PROGRAM_ID = "11111111111111111111111111111111"
+STAKE_PROGRAM_ID = "Stake11111111111111111111111111111111111111"
+
+MINT_SIZE = 82
+ACCOUNT_SIZE = 165
+MULTISIG_SIZE = 355
+NONCE_SIZE = 80
+STAKE_SIZE = 200
+
+ACCOUNT_TYPE_MINT = 1
+ACCOUNT_TYPE_ACCOUNT = 2
+"""
+Token-2022 accounts with extensions store their type in the byte after the
+165-byte base (mints are zero-padded up to it), then the extension TLVs.
+"""
+
+UNINITIALIZED, INITIALIZED, FROZEN = 0, 1, 2
+"""
+Token account states.
+"""
+
+_TLV = struct.Struct("<HH")  # extension type, value length
+_TAG = struct.Struct("<I")  # bincode enum variant
+
+
+@schema
+class Mint:
+    """
+    SPL Token mint (82 bytes).
+    """
+
+    mint_authority: COption[PubKey]
+    supply: U64
+    decimals: U8
+    is_initialized: Bool
+    freeze_authority: COption[PubKey]
+
+
+@schema
+class TokenAccount:
+    """
+    SPL Token account (165 bytes). `state` is UNINITIALIZED, INITIALIZED or
+    FROZEN; `is_native` is the rent-exempt reserve of wrapped SOL accounts.
+    """
+
+    mint: PubKey
+    owner: PubKey
+    amount: U64
+    delegate: COption[PubKey]
+    state: U8
+    is_native: COption[U64]
+    delegated_amount: U64
+    close_authority: COption[PubKey]
+
+
+@schema
+class Multisig:
+    """
+    SPL Token multisig (355 bytes), with unused signer slots zeroed.
+    """
+
+    m: U8
+    n: U8
+    is_initialized: Bool
+    signers: Array[PubKey, 11]
+
+
+# -----------------------------------------------------
+# Token-2022 Extensions
+# -----------------------------------------------------
+# Optional authorities ("OptionalNonZeroPubkey") are plain keys, the
+# all-zero key (11111111111111111111111111111111) meaning none.
+
+
+@schema
+class TransferFee:
+    epoch: U64
+    maximum_fee: U64
+    transfer_fee_basis_points: U16
+
+
+@schema
+class TransferFeeConfig:
+    transfer_fee_config_authority: PubKey
+    withdraw_withheld_authority: PubKey
+    withheld_amount: U64
+    older_transfer_fee: TransferFee
+    newer_transfer_fee: TransferFee
+
+
+@schema
+class TransferFeeAmount:
+    withheld_amount: U64
+
+
+@schema
+class MintCloseAuthority:
+    close_authority: PubKey
+
+
+@schema
+class DefaultAccountState:
+    state: U8
+
+
+@schema
+class MemoTransfer:
+    require_incoming_transfer_memos: Bool
+
+
+@schema
+class InterestBearingConfig:
+    rate_authority: PubKey
+    initialization_timestamp: I64
+    pre_update_average_rate: I16
+    last_update_timestamp: I64
+    current_rate: I16
+
+
+@schema
+class CpiGuard:
+    lock_cpi: Bool
+
+
+@schema
+class PermanentDelegate:
+    delegate: PubKey
+
+
+@schema
+class TransferHook:
+    authority: PubKey
+    program_id: PubKey
+
+
+@schema
+class TransferHookAccount:
+    transferring: Bool
+
+
+@schema
+class MetadataPointer:
+    authority: PubKey
+    metadata_address: PubKey
+
+
+@schema
+class TokenMetadata:
+    update_authority: PubKey
+    mint: PubKey
+    name: String
+    symbol: String
+    uri: String
+    additional_metadata: Vector[Tuple[String, String]]
+
+
+@schema
+class GroupPointer:
+    authority: PubKey
+    group_address: PubKey
+
+
+@schema
+class TokenGroup:
+    update_authority: PubKey
+    mint: PubKey
+    size: U64
+    max_size: U64
+
+
+@schema
+class GroupMemberPointer:
+    authority: PubKey
+    member_address: PubKey
+
+
+@schema
+class TokenGroupMember:
+    mint: PubKey
+    group: PubKey
+    member_number: U64
+
+
+@schema
+class ScaledUiAmountConfig:
+    authority: PubKey
+    multiplier: F64
+    new_multiplier_effective_timestamp: I64
+    new_multiplier: F64
+
+
+@schema
+class PausableConfig:
+    authority: PubKey
+    paused: Bool
+
+
+# -----------------------------------------------------
+# System and Stake Program Accounts
+# -----------------------------------------------------
+# Both are bincode: enum variants are u32 tags, read before the payload.
+
+
+@schema
+class FeeCalculator:
+    lamports_per_signature: U64
+
+
+@schema
+class NonceData:
+    """
+    Initialized durable nonce account state, after its version and state tags.
+    """
+
+    authority: PubKey
+    durable_nonce: FixedBytes[32]
+    fee_calculator: FeeCalculator
+
+
+@schema
+class Authorized:
+    staker: PubKey
+    withdrawer: PubKey
+
+
+@schema
+class Lockup:
+    unix_timestamp: I64
+    epoch: U64
+    custodian: PubKey
+
+
+@schema
+class StakeMeta:
+    rent_exempt_reserve: U64
+    authorized: Authorized
+    lockup: Lockup
+
+
+@schema
+class Delegation:
+    voter_pubkey: PubKey
+    stake: U64
+    activation_epoch: U64
+    deactivation_epoch: U64
+    warmup_cooldown_rate: F64
+
+
+@schema
+class Stake:
+    delegation: Delegation
+    credits_observed: U64
+
+
+@schema
+class DelegatedStake:
+    """
+    Payload of a delegated stake account (`StakeStateV2::Stake`).
+    """
+
+    meta: StakeMeta
+    stake: Stake
+    stake_flags: U8
+
+
+STAKE_STATES = ("uninitialized", "initialized", "stake", "rewards_pool")
+"""
+Stake account states by variant index.
+"""
+
+_MARKER = Layout(("struct", ()))
+"""
+Extensions whose presence is the whole value (e.g. immutable_owner) decode to {}.
+"""
+
+EXTENSIONS: dict[int, tuple[str, typing.Optional[Layout]]] = {
+    1: ("transfer_fee_config", TransferFeeConfig.compile()),
+    2: ("transfer_fee_amount", TransferFeeAmount.compile()),
+    3: ("mint_close_authority", MintCloseAuthority.compile()),
+    4: ("confidential_transfer_mint", None),
+    5: ("confidential_transfer_account", None),
+    6: ("default_account_state", DefaultAccountState.compile()),
+    7: ("immutable_owner", _MARKER),
+    8: ("memo_transfer", MemoTransfer.compile()),
+    9: ("non_transferable", _MARKER),
+    10: ("interest_bearing_config", InterestBearingConfig.compile()),
+    11: ("cpi_guard", CpiGuard.compile()),
+    12: ("permanent_delegate", PermanentDelegate.compile()),
+    13: ("non_transferable_account", _MARKER),
+    14: ("transfer_hook", TransferHook.compile()),
+    15: ("transfer_hook_account", TransferHookAccount.compile()),
+    16: ("confidential_transfer_fee_config", None),
+    17: ("confidential_transfer_fee_amount", None),
+    18: ("metadata_pointer", MetadataPointer.compile()),
+    19: ("token_metadata", TokenMetadata.compile()),
+    20: ("group_pointer", GroupPointer.compile()),
+    21: ("token_group", TokenGroup.compile()),
+    22: ("group_member_pointer", GroupMemberPointer.compile()),
+    23: ("token_group_member", TokenGroupMember.compile()),
+    24: ("confidential_mint_burn", None),
+    25: ("scaled_ui_amount", ScaledUiAmountConfig.compile()),
+    26: ("pausable", PausableConfig.compile()),
+    27: ("pausable_account", _MARKER),
+}
+"""
+Token-2022 extension type -> (name, layout). Extensions without a layout
+(confidential transfer state) and unknown ones decode to their raw bytes.
+"""
+
+_MINT = Mint.compile()
+_ACCOUNT = TokenAccount.compile()
+_MULTISIG = Multisig.compile()
+_NONCE = NonceData.compile()
+_STAKE_META = StakeMeta.compile()
+_DELEGATED_STAKE = DelegatedStake.compile()
+
+
+def _read(layout: Layout, data: typing.Any) -> typing.Any:
+    buf = Buffer(1)
+    buf.attach(data)
+    try:
+        return layout.read(buf)
+    finally:
+        buf.detach()
+        buf.free()
+
+
+def extensions(data: typing.Union[bytes, bytearray, memoryview]) -> dict[str, typing.Any]:
+    """
+    Decode the Token-2022 extensions of a mint or token account's data, by
+    extension name (see `EXTENSIONS`). Empty for accounts without any.
+    """
+    result: dict[str, typing.Any] = {}
+    with memoryview(data) as view:
+        offset, end = ACCOUNT_SIZE + 1, len(view)
+        while offset + _TLV.size <= end:
+            kind, length = _TLV.unpack_from(view, offset)
+            if kind == 0:  # uninitialized: the rest is unused space
+                break
+            offset += _TLV.size
+            if offset + length > end:
+                raise ValueError(f"Extension {kind} of {length} bytes overruns the account data.")
+            name, layout = EXTENSIONS.get(kind, (f"unknown_{kind}", None))
+            with view[offset : offset + length] as value:
+                result[name] = _read(layout, value) if layout is not None else bytes(value)
+            offset += length
+    return result
+
+
+def decode_account(data: typing.Union[bytes, bytearray, memoryview]) -> tuple[str, dict[str, typing.Any]]:
+    """
+    Decode any SPL Token or Token-2022 account to ("mint" | "account" |
+    "multisig", value). Token-2022 mints and accounts carrying extensions
+    get them under an "extensions" key.
+
+    Example:
+        >>> kind, account = qborsh.spl.decode_account(data)
+        >>> if kind == "account":
+        ...     account["owner"], account["amount"]
+    """
+    size = len(data)
+    if size == MINT_SIZE:
+        return "mint", _read(_MINT, data)
+    if size == ACCOUNT_SIZE:
+        return "account", _read(_ACCOUNT, data)
+    if size == MULTISIG_SIZE:
+        return "multisig", _read(_MULTISIG, data)
+    if size <= ACCOUNT_SIZE:
+        raise ValueError(f"{size} bytes is not the size of any SPL Token account.")
+
+    account_type = data[ACCOUNT_SIZE]
+    if account_type == ACCOUNT_TYPE_MINT:
+        kind, value = "mint", _read(_MINT, memoryview(data)[:MINT_SIZE])
+    elif account_type == ACCOUNT_TYPE_ACCOUNT:
+        kind, value = "account", _read(_ACCOUNT, memoryview(data)[:ACCOUNT_SIZE])
+    else:
+        raise ValueError(f"Unknown Token-2022 account type {account_type}.")
+    value["extensions"] = extensions(data)
+    return kind, value
+
+
+def decode_mints(data: typing.Union[bytes, bytearray, memoryview]) -> list[dict[str, typing.Any]]:
+    """
+    Decode 82-byte mints stored back to back (e.g. the concatenated data of
+    a `getMultipleAccounts` response) in one native call.
+    """
+    return _MINT.read_all(data)
+
+
+def decode_token_accounts(data: typing.Union[bytes, bytearray, memoryview]) -> list[dict[str, typing.Any]]:
+    """
+    Decode 165-byte token accounts stored back to back in one native call.
+    Token-2022 accounts with extensions have other sizes: decode those with
+    `decode_account`.
+    """
+    return _ACCOUNT.read_all(data)
+
+
+def decode_nonce(data: typing.Union[bytes, bytearray, memoryview]) -> typing.Optional[dict[str, typing.Any]]:
+    """
+    Decode a durable nonce account (80 bytes, owned by the system program),
+    or None while it is uninitialized.
+    """
+    if len(data) != NONCE_SIZE:
+        raise ValueError(f"{len(data)} bytes is not the size of a nonce account.")
+    with memoryview(data) as view:
+        (state,) = _TAG.unpack_from(view, _TAG.size)  # after the version
+        if state == 0:
+            return None
+        if state != 1:
+            raise ValueError(f"Unknown nonce state {state}.")
+        with view[2 * _TAG.size :] as value:
+            return _read(_NONCE, value)
+
+
+def decode_stake(
+    data: typing.Union[bytes, bytearray, memoryview],
+) -> tuple[str, typing.Optional[dict[str, typing.Any]]]:
+    """
+    Decode a stake account (200 bytes) to (state, value), the state being one of
+    `STAKE_STATES`. Initialized accounts decode to their `StakeMeta`,
+    delegated ones to a `DelegatedStake`; the other states carry no value.
+
+    Example:
+        >>> state, stake = qborsh.spl.decode_stake(data)
+        >>> if state == "stake":
+        ...     stake["stake"]["delegation"]["voter_pubkey"]
+    """
+    if len(data) != STAKE_SIZE:
+        raise ValueError(f"{len(data)} bytes is not the size of a stake account.")
+    with memoryview(data) as view:
+        (index,) = _TAG.unpack_from(view)
+        if index >= len(STAKE_STATES):
+            raise ValueError(f"Unknown stake state {index}.")
+        state = STAKE_STATES[index]
+        layout = {"initialized": _STAKE_META, "stake": _DELEGATED_STAKE}.get(state)
+        if layout is None:
+            return state, None
+        with view[_TAG.size :] as value:
+            return state, _read(layout, value)
@@ -1,19 +1,26 @@
 from .base import BorshType
-from .collections import Array, Map, Optional, Set, Vector
-from .helpers import Padding, PubKey
-from .numeric import F32, F64, I8, I16, I32, I64, I128, U8, U16, U32, U64, U128, Bool
+from .collections import Array, COption, Map, Optional, Set, ShortVec, Tuple, Vector
+from .enums import Enum, enum
+from .helpers import Interned, Padding, PubKey
+from .numeric import F32, F64, I8, I16, I32, I64, I128, U8, U16, U32, U64, U128, Bool, ShortU16, VarI64, VarU64
 from .schema import Schema, schema
-from .strings import Bytes, String
+from .strings import Bytes, FixedBytes, ShortBytes, String, View
 
 __all__ = [
     "BorshType",
     "Optional",
+    "COption",
     "Set",
     "Vector",
+    "ShortVec",
     "Array",
     "Map",
+    "Tuple",
+    "Enum",
+    "enum",
     "PubKey",
     "Padding",
+    "Interned",
     "U8",
     "U16",
     "U32",
@@ -27,8 +34,14 @@ __all__ = [
     "F32",
     "F64",
     "Bool",
+    "ShortU16",
+    "VarU64",
+    "VarI64",
     "Schema",
     "schema",
     "String",
     "Bytes",
+    "FixedBytes",
+    "ShortBytes",
+    "View",
 ]
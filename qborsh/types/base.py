@@ -1,10 +1,18 @@
 from __future__ import annotations
 
 import abc
+import mmap
+import os
 import typing
 
 from qborsh.constants import BUFFER_SIZE, GLOBAL_BUFFER
-from qborsh.csrc import Buffer
+from qborsh.csrc import Buffer, Layout
+
+MMAP_THRESHOLD = 1 << 20
+"""
+Payloads of at least this many bytes are memory-mapped by `decode_file`
+instead of read into a buffer.
+"""
 
 
 class BorshTypeMeta(abc.ABCMeta):
@@ -52,6 +60,11 @@ class BorshType(abc.ABC, metaclass=BorshTypeMeta):
     Special flag to indicate that this type is padding.
     """
 
+    _compiled: typing.Optional[Layout] = None
+    """
+    Cached native layout, see `compile`.
+    """
+
     @abc.abstractmethod
     def serialize(self, buf: Buffer, value: typing.Any) -> None:
         """
@@ -77,6 +90,33 @@ class BorshType(abc.ABC, metaclass=BorshTypeMeta):
             2. qborsh.Vector[U32].sizeof()     (instance method)
         """
 
+    def layout(self) -> typing.Optional[tuple]:
+        """
+        Return the spec of this type's native layout (see `compile`), or None
+        if the type can only be handled in Python.
+        """
+        return None
+
+    def compile(self) -> Layout:
+        """
+        Return the native layout of this type, compiled once and cached. The
+        native engines (e.g. `qborsh.scan`) walk encoded data with it.
+        """
+        compiled = self._compiled
+        if compiled is None:
+            spec = self.layout()
+            if spec is None:
+                raise TypeError(f"{type(self).__name__} has no native layout.")
+            compiled = self._compiled = Layout(spec)
+        return compiled
+
+    def native(self) -> typing.Optional[Layout]:
+        """
+        Return the compiled layout when this whole type can be encoded and
+        decoded natively (`Layout.read`/`Layout.write`), else None.
+        """
+        return self.compile() if self.layout() is not None else None
+
     @classmethod
     def encode(cls, value: typing.Any) -> bytes:
         if not cls._SINGLETON:
@@ -100,7 +140,34 @@ class BorshType(abc.ABC, metaclass=BorshTypeMeta):
         return data
 
     @classmethod
-    def decode(cls, data: bytes) -> typing.Any:
+    def encode_into(cls, value: typing.Any, target: typing.Any) -> int:
+        """
+        Encode `value` straight into the writable bytes-like `target` (e.g. a
+        slot of shared memory) and return the number of bytes written.
+        Raises ValueError if it does not fit.
+        """
+        if not cls._SINGLETON:
+            cls._SINGLETON = cls()
+
+        self = cls._SINGLETON
+        buf = GLOBAL_BUFFER if GLOBAL_BUFFER else Buffer(1)
+
+        buf.attach(target, True)
+        try:
+            self.serialize(buf, value)
+            return buf.size
+        except RuntimeError:
+            # Writes fail, flagging the buffer, once the attached memory is full
+            if buf.error:
+                raise ValueError(f"Encoded value does not fit in {len(target)} bytes.") from None
+            raise
+        finally:
+            buf.detach()
+            if not GLOBAL_BUFFER:
+                buf.free()
+
+    @classmethod
+    def decode(cls, data: typing.Union[bytes, bytearray, memoryview]) -> typing.Any:
         if not cls._SINGLETON:
             cls._SINGLETON = cls()
 
@@ -113,15 +180,111 @@ class BorshType(abc.ABC, metaclass=BorshTypeMeta):
             size = self.sizeof() or BUFFER_SIZE
             buf = Buffer(size)
 
-        buf.write_fixed_array(data)
-
-        value = self.deserialize(buf)
+        # Read from `data` in place (zero-copy for memoryviews of mmaps, etc.)
+        buf.attach(data)
+        try:
+            value = self.deserialize(buf)
+        finally:
+            buf.detach()
 
         if not GLOBAL_BUFFER:
             buf.free()
 
         return value
 
+    @classmethod
+    def decode_file(
+        cls,
+        file: typing.Union[int, str, os.PathLike, typing.IO],
+        offset: int = 0,
+        length: typing.Optional[int] = None,
+    ) -> typing.Any:
+        """
+        Decode the value stored at `offset` of `file` (a file descriptor, a
+        path or an open file). `length` defaults to the rest of the file.
+
+        The payload is pread straight into the reusable native buffer, or
+        memory-mapped and decoded in place when it is `MMAP_THRESHOLD`
+        bytes or more, so no intermediate bytes object is built.
+        """
+        if not cls._SINGLETON:
+            cls._SINGLETON = cls()
+
+        self = cls._SINGLETON
+
+        if isinstance(file, int):
+            fd, owned = file, False
+        elif hasattr(file, "fileno"):
+            fd, owned = file.fileno(), False
+        else:
+            fd, owned = os.open(file, os.O_RDONLY), True
+
+        try:
+            if length is None:
+                length = os.fstat(fd).st_size - offset
+            if offset < 0 or length < 0:
+                raise ValueError(f"Invalid offset/length: {offset}/{length}")
+
+            if length >= MMAP_THRESHOLD:
+                # mmap offsets must be aligned to the allocation granularity
+                start = offset - offset % mmap.ALLOCATIONGRANULARITY
+                with (
+                    mmap.mmap(fd, offset - start + length, offset=start, access=mmap.ACCESS_READ) as mapped,
+                    memoryview(mapped) as view,
+                    view[offset - start :] as payload,
+                ):
+                    return cls.decode(payload)
+
+            if GLOBAL_BUFFER:
+                buf = GLOBAL_BUFFER
+            else:
+                buf = Buffer(length or 1)
+
+            try:
+                if buf.read_from(fd, offset, length) != length:
+                    raise ValueError(f"File ends before {length} bytes at offset {offset}.")
+                return self.deserialize(buf)
+            finally:
+                if not GLOBAL_BUFFER:
+                    buf.free()
+        finally:
+            if owned:
+                os.close(fd)
+
+    @classmethod
+    def decode_b64(cls, text: typing.Union[str, bytes]) -> typing.Any:
+        """
+        Decode the value from base64 text, e.g. account data in an RPC
+        response. The text is decoded natively straight into the reusable
+        native buffer, so no intermediate bytes object is built.
+        """
+        return cls._decode_text(text, base58=False)
+
+    @classmethod
+    def decode_b58(cls, text: typing.Union[str, bytes]) -> typing.Any:
+        """
+        Decode the value from base58 text, see `decode_b64`.
+        """
+        return cls._decode_text(text, base58=True)
+
+    @classmethod
+    def _decode_text(cls, text: typing.Union[str, bytes], base58: bool) -> typing.Any:
+        if not cls._SINGLETON:
+            cls._SINGLETON = cls()
+
+        self = cls._SINGLETON
+        buf = GLOBAL_BUFFER if GLOBAL_BUFFER else Buffer(len(text) or 1)
+
+        try:
+            if base58:
+                buf.read_base58(text)
+            else:
+                buf.read_base64(text)
+            return self.deserialize(buf)
+        finally:
+            if not GLOBAL_BUFFER:
+                buf.free()
+
     def __call__(self, *args, **kwargs) -> dict[str, typing.Any] | bytes:
         if args and kwargs:
             raise TypeError("Cannot provide both args and kwargs.")
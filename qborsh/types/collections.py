@@ -9,17 +9,30 @@ K = typing.TypeVar("K", bound=BorshType)
 
 
 class Optional(BorshType, typing.Generic[T]):
+    """
+    Borsh option: a u8 tag, then the value inline when the tag is set.
+
+    Optionals of natively laid out types are handled in one native call
+    (`native`), the tag being a single branch in C.
+    """
+
     def __init__(self, element: BorshType):
         self.element = element
+        self._program = self.native()
 
     def serialize(self, buf: Buffer, value: typing.Any):
-        if value is None:
+        if self._program is not None:
+            self._program.write(buf, value)
+        elif value is None:
             buf.write_bool(False)
         else:
             buf.write_bool(True)
             self.element.serialize(buf, value)
 
     def deserialize(self, buf: Buffer) -> typing.Any:
+        if self._program is not None:
+            return self._program.read(buf)
+
         value = buf.read_bool()
         if value:
             return self.element.deserialize(buf)
@@ -28,14 +41,66 @@ class Optional(BorshType, typing.Generic[T]):
     def sizeof(self):
         return None
 
+    def layout(self) -> typing.Optional[tuple]:
+        element = self.element.layout()
+        return None if element is None else ("option", element)
+
+
+class COption(BorshType, typing.Generic[T]):
+    """
+    Solana program option (`COption`, as in SPL Token accounts): a u32 tag,
+    then the value's bytes whether or not it is set (zeroed when it is not),
+    so the element must be fixed-size.
+    """
+
+    def __init__(self, element: BorshType):
+        self.element = element
+        self.size = element.sizeof()
+        if self.size is None:
+            raise TypeError("COption needs a fixed-size element.")
+        self._program = self.native()
+
+    def serialize(self, buf: Buffer, value: typing.Any):
+        if self._program is not None:
+            self._program.write(buf, value)
+        elif value is None:
+            buf.write_u32(0)
+            buf.write_fixed_array(bytes(self.size))
+        else:
+            buf.write_u32(1)
+            self.element.serialize(buf, value)
+
+    def deserialize(self, buf: Buffer) -> typing.Any:
+        if self._program is not None:
+            return self._program.read(buf)
+
+        tag = buf.read_u32()
+        if tag == 1:
+            return self.element.deserialize(buf)
+        if tag != 0:
+            raise ValueError(f"Invalid COption tag {tag}.")
+        buf.read_fixed_array(self.size)
+        return None
+
+    def sizeof(self):
+        return 4 + self.size
+
+    def layout(self) -> typing.Optional[tuple]:
+        element = self.element.layout()
+        return None if element is None else ("coption", element)
+
 
 class Set(BorshType, typing.Generic[T]):
     def __init__(self, element_type: BorshType):
         self.element_type = element_type
+        self._program = self.native()
 
     def serialize(self, buf: Buffer, value: typing.Set[typing.Any]) -> None:
         if not isinstance(value, set):
             raise TypeError(f"Expected set. Received: {type(value)}")
+        if self._program is not None:
+            self._program.write(buf, value)
+            return
 
         temp_set = set()
         for element in value:
@@ -56,6 +121,9 @@ class Set(BorshType, typing.Generic[T]):
         buf.write_hashset(temp_set)
 
     def deserialize(self, buf: Buffer) -> typing.Set[typing.Any]:
+        if self._program is not None:
+            return self._program.read(buf)
+
         raw_set = buf.read_hashset()
         typed_set = set()
 
@@ -80,20 +148,31 @@ class Set(BorshType, typing.Generic[T]):
     def sizeof(self) -> typing.Optional[int]:
         return None
 
+    def layout(self) -> typing.Optional[tuple]:
+        element = self.element_type.layout()
+        return None if element is None else ("set", element)
+
 
 class Vector(BorshType, typing.Generic[T]):
     def __init__(self, element: BorshType):
         self.element = element
+        self._program = self.native()
 
     def serialize(self, buf: Buffer, value: list):
         if not isinstance(value, list):
             raise TypeError(f"Expected list. Received: {value}")
+        if self._program is not None:
+            self._program.write(buf, value)
+            return
 
         buf.write_u32(len(value))
         for elem in value:
             self.element.serialize(buf, elem)
 
     def deserialize(self, buf: Buffer) -> typing.List[typing.Any]:
+        if self._program is not None:
+            return self._program.read(buf)
+
         length = buf.read_u32()
 
         elements = []
@@ -104,11 +183,52 @@ class Vector(BorshType, typing.Generic[T]):
     def sizeof(self):
         return None
 
+    def layout(self) -> typing.Optional[tuple]:
+        element = self.element.layout()
+        return None if element is None else ("vec", element)
+
+
+class ShortVec(BorshType, typing.Generic[T]):
+    """
+    Solana "shortvec": a compact-u16 count (see `ShortU16`), then the
+    elements. Holds at most 65535 elements.
+    """
+
+    def __init__(self, element: BorshType):
+        self.element = element
+        self._program = self.native()
+
+    def serialize(self, buf: Buffer, value: list):
+        if not isinstance(value, list):
+            raise TypeError(f"Expected list. Received: {value}")
+        if self._program is not None:
+            self._program.write(buf, value)
+            return
+
+        if len(value) > 0xFFFF:
+            raise ValueError("Too many items for a shortvec length")
+        buf.write_short_u16(len(value))
+        for elem in value:
+            self.element.serialize(buf, elem)
+
+    def deserialize(self, buf: Buffer) -> typing.List[typing.Any]:
+        if self._program is not None:
+            return self._program.read(buf)
+        return [self.element.deserialize(buf) for _ in range(buf.read_short_u16())]
+
+    def sizeof(self):
+        return None
+
+    def layout(self) -> typing.Optional[tuple]:
+        element = self.element.layout()
+        return None if element is None else ("shortvec", element)
+
 
 class Array(BorshType, typing.Generic[T, K]):
     def __init__(self, element: BorshType, size: int):
         self.element = element
         self.size = size
+        self._program = self.native()
 
     def serialize(self, buf: Buffer, value: list):
         if not isinstance(value, list):
@@ -117,10 +237,16 @@ class Array(BorshType, typing.Generic[T, K]):
         if len(value) != self.size:
             raise ValueError(f"Expected list of size {self.size}. Received: {value} of size {len(value)}")
 
+        if self._program is not None:
+            self._program.write(buf, value)
+            return
         for elem in value:
             self.element.serialize(buf, elem)
 
     def deserialize(self, buf: Buffer) -> typing.List[typing.Any]:
+        if self._program is not None:
+            return self._program.read(buf)
+
         elements = []
         for _ in range(self.size):
             elements.append(self.element.deserialize(buf))
@@ -132,15 +258,73 @@ class Array(BorshType, typing.Generic[T, K]):
             return None
         return element_size * self.size
 
+    def layout(self) -> typing.Optional[tuple]:
+        element = self.element.layout()
+        return None if element is None else ("array", element, self.size)
+
+
+class Tuple(BorshType):
+    """
+    Rust tuple (or tuple struct): the elements back to back, with no names
+    or prefix. Decodes to a Python tuple and encodes from any sequence of
+    the right length.
+
+    Example:
+        >>> Quote = qborsh.Tuple[qborsh.U64, qborsh.PubKey, qborsh.String]
+        >>> Quote.decode(Quote.encode((100, owner, "SOL")))
+        (100, owner, 'SOL')
+    """
+
+    def __init__(self, *elements: BorshType):
+        self.elements = elements
+        self._program = self.native()
+
+    def serialize(self, buf: Buffer, value: typing.Sequence[typing.Any]) -> None:
+        if self._program is not None:
+            self._program.write(buf, value)
+            return
+
+        if len(value) != len(self.elements):
+            raise ValueError(f"Expected {len(self.elements)} items. Received: {len(value)}")
+        for element, item in zip(self.elements, value):
+            element.serialize(buf, item)
+
+    def deserialize(self, buf: Buffer) -> tuple:
+        if self._program is not None:
+            return self._program.read(buf)
+        return tuple(element.deserialize(buf) for element in self.elements)
+
+    def sizeof(self) -> typing.Optional[int]:
+        size = 0
+        for element in self.elements:
+            element_size = element.sizeof()
+            if element_size is None:
+                return None
+            size += element_size
+        return size
+
+    def layout(self) -> typing.Optional[tuple]:
+        specs = []
+        for element in self.elements:
+            spec = element.layout()
+            if spec is None:
+                return None
+            specs.append(spec)
+        return ("tuple", tuple(specs))
+
 
 class Map(BorshType, typing.Generic[T, K]):
     def __init__(self, key_type: BorshType, value_type: BorshType):
         self.key_type = key_type
         self.value_type = value_type
+        self._program = self.native()
 
     def serialize(self, buf: Buffer, value: dict[typing.Any, typing.Any]) -> None:
         if not isinstance(value, dict):
             raise TypeError(f"Expected dict. Received: {type(value)}")
+        if self._program is not None:
+            self._program.write(buf, value)
+            return
 
         temp_dict: dict[bytes, bytes] = {}
         for key_obj, val_obj in value.items():
@@ -169,6 +353,9 @@ class Map(BorshType, typing.Generic[T, K]):
         buf.write_hashmap(temp_dict)
 
     def deserialize(self, buf: Buffer) -> dict[typing.Any, typing.Any]:
+        if self._program is not None:
+            return self._program.read(buf)
+
         raw_dict = buf.read_hashmap()
         typed_dict = {}
 
@@ -201,3 +388,8 @@ class Map(BorshType, typing.Generic[T, K]):
 
     def sizeof(self) -> typing.Optional[int]:
         return None
+
+    def layout(self) -> typing.Optional[tuple]:
+        key = self.key_type.layout()
+        value = self.value_type.layout()
+        return None if key is None or value is None else ("map", key, value)
@@ -0,0 +1,109 @@
+import typing
+
+from qborsh.csrc import Buffer
+from qborsh.types.base import BorshType
+
+
+class Enum(BorshType):
+    """
+    Tagged union, i.e. a Rust enum: a u8 variant index followed by that
+    variant's payload.
+
+    Variants are the class annotations in declaration order, `None` marking a
+    unit variant. Values are `(variant_name, payload)` tuples, the payload of
+    a unit variant being None; a unit variant may also be encoded from its
+    bare name. When every payload has a native layout, values are encoded and
+    decoded natively in one call, the variant index selecting the payload's
+    compiled layout from a table.
+
+    Example:
+        >>> @qborsh.enum
+        ... class Instruction:
+        ...     Initialize: None
+        ...     Transfer: TransferArgs
+        ...     SetOwner: qborsh.PubKey
+        >>> encoded = Instruction.encode(("Transfer", {"amount": 10}))
+        >>> Instruction.decode(encoded)
+        ('Transfer', {'amount': 10})
+    """
+
+    def __init__(self):
+        variants: list[tuple[str, typing.Optional[BorshType]]] = []
+        hints = typing.get_type_hints(self, globalns=globals(), localns=locals())
+        for k, v in hints.items():
+            if k.startswith("_"):
+                continue
+            elif v is type(None):
+                variants.append((k, None))
+            elif isinstance(v, BorshType):
+                variants.append((k, v))
+            elif isinstance(v, type) and issubclass(v, BorshType):
+                variants.append((k, v()))
+            else:
+                raise TypeError(f"Variant '{k}' is of type {v}. Must be None or a subclass of BorshType.")
+
+        if not 1 <= len(variants) <= 256:
+            raise ValueError(f"Enum must have 1 to 256 variants. Received: {len(variants)}")
+
+        self.__borsh_variants__ = tuple(variants)
+        self._indices = {name: index for index, (name, _) in enumerate(variants)}
+
+        # Payloads handled only in Python keep the whole enum in Python
+        self._program = self.native()
+
+    def serialize(self, buf: Buffer, value: typing.Any) -> None:
+        if self._program is not None:
+            self._program.write(buf, value)
+            return
+
+        name, payload = (value, None) if isinstance(value, str) else value
+        index = self._indices.get(name)
+        if index is None:
+            raise ValueError(f"Unknown enum variant {name!r}.")
+        element = self.__borsh_variants__[index][1]
+        if element is not None and isinstance(value, str):
+            raise ValueError(f"Enum variant {name!r} needs a payload.")
+
+        buf.write_u8(index)
+        if element is not None:
+            element.serialize(buf, payload)
+
+    def deserialize(self, buf: Buffer) -> tuple[str, typing.Any]:
+        if self._program is not None:
+            return self._program.read(buf)
+
+        index = buf.read_u8()
+        if index >= len(self.__borsh_variants__):
+            raise ValueError(f"Invalid enum variant index {index}.")
+        name, element = self.__borsh_variants__[index]
+        return name, None if element is None else element.deserialize(buf)
+
+    def sizeof(self) -> typing.Optional[int]:
+        sizes = set(0 if element is None else element.sizeof() for _, element in self.__borsh_variants__)
+        if len(sizes) != 1 or None in sizes:
+            return None
+        return 1 + sizes.pop()
+
+    def layout(self) -> typing.Optional[tuple]:
+        variants = []
+        for name, element in self.__borsh_variants__:
+            spec = None if element is None else element.layout()
+            if element is not None and spec is None:
+                return None
+            variants.append((name, spec))
+        return ("enum", tuple(variants))
+
+    @property
+    def variants(self) -> tuple[str, ...]:
+        """
+        Variant names, in index order.
+        """
+        return tuple(name for name, _ in self.__borsh_variants__)
+
+
+def enum(cls: type) -> Enum:
+    """
+    Decorator declaring an `Enum` from a class of annotations, like `schema`.
+    """
+    cls = type(cls.__name__, (Enum,), dict(cls.__dict__))
+    return cls()
@@ -1,30 +1,31 @@
 import typing
 
-import qbase58 as base58
-
-from qborsh.csrc import Buffer
+from qborsh.csrc import Buffer, PublicKey
 from qborsh.types.base import BorshType
 
 T = typing.TypeVar("T", bound=BorshType)
 
 
 class PubKey(BorshType):
-    def serialize(self, buf: Buffer, value: bytes | str) -> None:
-        if isinstance(value, bytes):
-            raw_bytes = value
-        else:
-            raw_bytes = base58.decode(value)
-        if len(raw_bytes) != 32:
-            raise ValueError("PubKey must be exactly 32 bytes.")
-        buf.write_fixed_array(raw_bytes)
-
-    def deserialize(self, buf: Buffer) -> str:
-        raw_bytes = buf.read_fixed_array(32)
-        return base58.encode(raw_bytes)
+    """
+    A 32-byte public key, given as raw bytes, base58 text or a `PublicKey`.
+    Decodes to base58 text, or to `PublicKey` objects once
+    `qborsh.set_lazy_pubkeys(True)` is set. Base58 is encoded and decoded
+    natively.
+    """
+
+    def serialize(self, buf: Buffer, value: bytes | str | PublicKey) -> None:
+        buf.write_pubkey(value)
+
+    def deserialize(self, buf: Buffer) -> str | PublicKey:
+        return buf.read_pubkey()
 
     def sizeof(self) -> int:
         return 32
 
+    def layout(self) -> tuple:
+        return ("pubkey",)
+
 
 class Padding(BorshType, typing.Generic[T]):
     _PADDING = True
@@ -46,3 +47,33 @@ class Padding(BorshType, typing.Generic[T]):
 
     def sizeof(self) -> int:
         return self.element_size
+
+    def layout(self) -> tuple:
+        return ("padding", self.element_size)
+
+
+class Interned(BorshType, typing.Generic[T]):
+    """
+    A `String` or `PubKey` field marked low-cardinality (token mints,
+    program ids, enum-like names). Decoding goes through a bounded native
+    intern table, so repeated values come back as the same shared object
+    instead of a new one each time. See `qborsh.clear_interned`.
+    """
+
+    def __init__(self, element: BorshType):
+        if element.layout() not in (("string",), ("pubkey",)):
+            raise TypeError(f"Only String and PubKey can be interned. Received: {element}")
+        self.element = element
+        self._program = self.compile()
+
+    def serialize(self, buf: Buffer, value: typing.Any) -> None:
+        self.element.serialize(buf, value)
+
+    def deserialize(self, buf: Buffer) -> typing.Any:
+        return self._program.read(buf)
+
+    def sizeof(self) -> typing.Optional[int]:
+        return self.element.sizeof()
+
+    def layout(self) -> tuple:
+        return ("interned", self.element.layout())
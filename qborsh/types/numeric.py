@@ -22,6 +22,10 @@ class _Numeric(BorshType):
     def sizeof(cls) -> int:
         return cls.bits // 8
 
+    @classmethod
+    def layout(cls) -> tuple:
+        return (f"{cls.type}{cls.bits}",)
+
 
 class U8(_Numeric):
     type = "u"
@@ -95,3 +99,70 @@ class Bool(BorshType):
     @classmethod
     def sizeof(cls) -> int:
         return 1
+
+    @classmethod
+    def layout(cls) -> tuple:
+        return ("bool",)
+
+
+class ShortU16(BorshType):
+    """
+    Solana's compact-u16: 1 to 3 bytes of 7 bits each, as used for the
+    lengths in transaction messages (see `ShortVec`).
+    """
+
+    def serialize(self, buf: Buffer, value: int) -> None:
+        buf.write_short_u16(value)
+
+    def deserialize(self, buf: Buffer) -> int:
+        return buf.read_short_u16()
+
+    @classmethod
+    def sizeof(cls) -> None:
+        return None
+
+    @classmethod
+    def layout(cls) -> tuple:
+        return ("short_u16",)
+
+
+class VarU64(BorshType):
+    """
+    Unsigned LEB128 varint (1 to 10 bytes): small values take fewer bytes
+    than a fixed-width U64. Not part of Borsh, for formats layered on it.
+    """
+
+    def serialize(self, buf: Buffer, value: int) -> None:
+        buf.write_var_u64(value)
+
+    def deserialize(self, buf: Buffer) -> int:
+        return buf.read_var_u64()
+
+    @classmethod
+    def sizeof(cls) -> None:
+        return None
+
+    @classmethod
+    def layout(cls) -> tuple:
+        return ("var_u64",)
+
+
+class VarI64(BorshType):
+    """
+    Signed varint: zigzag mapped (0, -1, 1, -2 ... become 0, 1, 2, 3 ...)
+    then LEB128, so small negative values stay short too.
+    """
+
+    def serialize(self, buf: Buffer, value: int) -> None:
+        buf.write_var_i64(value)
+
+    def deserialize(self, buf: Buffer) -> int:
+        return buf.read_var_i64()
+
+    @classmethod
+    def sizeof(cls) -> None:
+        return None
+
+    @classmethod
+    def layout(cls) -> tuple:
+        return ("var_i64",)
@@ -2,6 +2,7 @@ import typing
 
 from qborsh.csrc import Buffer
 from qborsh.types.base import BorshType
+from qborsh.types.collections import Tuple
 from qborsh.utils import dotdict
 
 
@@ -31,8 +32,13 @@ class Schema(BorshType):
                 fields[k] = v()
 
         self.__borsh_fields__ = fields.items()
+        self._program = self.native()
 
     def serialize(self, buf: Buffer, data: dict[str, typing.Any]) -> None:
+        if self._program is not None and not self.validate:
+            self._program.write(buf, data)
+            return
+
         if self.validate:
             schema_keys = set(i[0] for i in self.__borsh_fields__)
             data_keys = set(data.keys())
@@ -51,6 +57,9 @@ class Schema(BorshType):
             field_type.serialize(buf, data[field_name])
 
     def deserialize(self, buf: Buffer) -> dict[str, typing.Any]:
+        if self._program is not None:
+            return self._program.read(buf)
+
         data = {}
         for field_name, field_type in self.__borsh_fields__:
             data[field_name] = field_type.deserialize(buf)
@@ -72,6 +81,100 @@ class Schema(BorshType):
             size += field_size
         return size
 
+    def layout(self) -> typing.Optional[tuple]:
+        fields = []
+        for field_name, field_type in self.__borsh_fields__:
+            spec = field_type.layout()
+            if spec is None:
+                return None
+            fields.append((field_name, spec))
+        # Natively decoded structs go through dotdict as well
+        if self.dotdict:
+            return ("struct", tuple(fields), dotdict)
+        return ("struct", tuple(fields))
+
+    def field_path(self, name: str) -> tuple[tuple[int, ...], BorshType]:
+        """
+        Resolve a field name to its index path and type. Dotted names reach
+        into nested schemas, e.g. "inner.x", and tuples by position, e.g.
+        "pair.0".
+        """
+        path: list[int] = []
+        schema: BorshType = self
+        for part in name.split("."):
+            if isinstance(schema, Tuple) and part.isdigit() and int(part) < len(schema.elements):
+                path.append(int(part))
+                schema = schema.elements[int(part)]
+                continue
+            if not isinstance(schema, Schema):
+                raise KeyError(f"Field '{name}' does not exist.")
+            for index, (field_name, field_type) in enumerate(schema.__borsh_fields__):
+                if field_name == part:
+                    path.append(index)
+                    schema = field_type
+                    break
+            else:
+                raise KeyError(f"Field '{name}' does not exist.")
+        return tuple(path), schema
+
+    def aggregate(
+        self,
+        records: typing.Any,
+        field: typing.Optional[str],
+        op: str,
+        group_by: typing.Optional[str] = None,
+        bins: typing.Optional[typing.Sequence[typing.Union[int, float]]] = None,
+        where: typing.Sequence[tuple] = (),
+        workers: typing.Optional[int] = None,
+    ) -> typing.Any:
+        """
+        Aggregate `field` over encoded `records` natively, see
+        `qborsh.query.aggregate`.
+        """
+        from qborsh.query import aggregate
+
+        return aggregate(self, records, field, op, group_by, bins, where, workers)
+
+    def sort(
+        self,
+        records: typing.Any,
+        key: str,
+        reverse: bool = False,
+        permutation: bool = False,
+        workers: typing.Optional[int] = None,
+    ) -> typing.Any:
+        """
+        Sort encoded `records` by the field `key`, see `qborsh.sort.sort`.
+        """
+        from qborsh.sort import sort
+
+        return sort(self, records, key, reverse, permutation, workers)
+
+    def sort_file(self, source: typing.Any, destination: typing.Any, key: str, **kwargs: typing.Any) -> None:
+        """
+        External merge sort of a record file, see `qborsh.sort.sort_file`.
+        """
+        from qborsh.sort import sort_file
+
+        sort_file(self, source, destination, key, **kwargs)
+
+    def build_index(self, records: typing.Any, field: str, workers: typing.Optional[int] = None) -> typing.Any:
+        """
+        Build a hash index of `field` over encoded `records`, see
+        `qborsh.index.build_index`.
+        """
+        from qborsh.index import build_index
+
+        return build_index(self, records, field, workers)
+
+    def load_index(self, path: typing.Any, records: typing.Any) -> typing.Any:
+        """
+        Open a saved index over its records, see `qborsh.index.load_index`.
+        """
+        from qborsh.index import load_index
+
+        return load_index(self, path, records)
+
 
 @typing.overload
 def schema(
@@ -1,3 +1,5 @@
+import typing
+
 from qborsh import Buffer
 from qborsh.types import BorshType
 
@@ -16,6 +18,10 @@ class String(BorshType):
     def sizeof(cls):
         return None
 
+    @classmethod
+    def layout(cls) -> tuple:
+        return ("string",)
+
 
 class Bytes(BorshType):
     def serialize(self, buf: Buffer, value: bytes):
@@ -29,3 +35,81 @@ class Bytes(BorshType):
     @classmethod
     def sizeof(cls):
         return None
+
+    @classmethod
+    def layout(cls) -> tuple:
+        return ("bytes",)
+
+
+class FixedBytes(BorshType):
+    """
+    Exactly `length` raw bytes with no prefix, e.g. `FixedBytes[32]` for a
+    key kept as bytes rather than base58.
+    """
+
+    def __init__(self, length: int):
+        self.length = length
+
+    def serialize(self, buf: Buffer, value: bytes):
+        if len(value) != self.length:
+            raise ValueError(f"Expected {self.length} bytes. Received: {len(value)}")
+        buf.write_fixed_array(bytes(value))
+
+    def deserialize(self, buf: Buffer) -> bytes:
+        return buf.read_fixed_array(self.length)
+
+    def sizeof(self) -> int:
+        return self.length
+
+    def layout(self) -> tuple:
+        return ("fixed_bytes", self.length)
+
+
+class ShortBytes(BorshType):
+    """
+    Bytes behind a Solana compact-u16 length (see `ShortU16`).
+    """
+
+    def serialize(self, buf: Buffer, value: bytes):
+        if len(value) > 0xFFFF:
+            raise ValueError("Too many bytes for a shortvec length")
+        buf.write_short_u16(len(value))
+        buf.write_fixed_array(bytes(value))
+
+    def deserialize(self, buf: Buffer) -> bytes:
+        return buf.read_fixed_array(buf.read_short_u16())
+
+    @classmethod
+    def sizeof(cls):
+        return None
+
+    @classmethod
+    def layout(cls) -> tuple:
+        return ("short_bytes",)
+
+
+class View(BorshType):
+    """
+    `Bytes`, `ShortBytes` or `FixedBytes` decoded as a memoryview of the
+    data being decoded instead of a copy, when that data is `bytes` (which
+    the views keep alive). Mutable or reused memory (bytearrays, mmaps,
+    shared memory, the native buffer) may change or close under a view, so
+    decoding from it yields copies as bytes.
+    """
+
+    def __init__(self, element: BorshType):
+        if element.layout() is None or element.layout()[0] not in ("bytes", "short_bytes", "fixed_bytes"):
+            raise TypeError(f"Only Bytes, ShortBytes and FixedBytes can be views. Received: {element}")
+        self.element = element
+
+    def serialize(self, buf: Buffer, value: typing.Any):
+        self.element.serialize(buf, bytes(value))
+
+    def deserialize(self, buf: Buffer) -> typing.Union[memoryview, bytes]:
+        return self.compile().read(buf)
+
+    def sizeof(self) -> typing.Optional[int]:
+        return self.element.sizeof()
+
+    def layout(self) -> tuple:
+        return ("view", self.element.layout())
@@ -27,17 +27,29 @@ setup(
         "Operating System :: OS Independent",
         "Topic :: Utilities",
     ],
-    install_requires=[
-        "qbase58==1.0.4",
-    ],
     ext_modules=[
         Extension(
             name="qborsh.csrc.py_borsh",
             sources=[
                 "qborsh/csrc/py_borsh.c",
                 "qborsh/csrc/borsh.c",
+                "qborsh/csrc/layout.c",
+                "qborsh/csrc/pool.c",
+                "qborsh/csrc/records.c",
+                "qborsh/csrc/scan.c",
+                "qborsh/csrc/group.c",
+                "qborsh/csrc/sort.c",
+                "qborsh/csrc/index.c",
+                "qborsh/csrc/crc32c.c",
+                "qborsh/csrc/frames.c",
+                "qborsh/csrc/readahead.c",
+                "qborsh/csrc/ring.c",
+                "qborsh/csrc/base58.c",
+                "qborsh/csrc/base64.c",
+                "qborsh/csrc/dispatch.c",
             ],
             include_dirs=["qborsh/csrc"],
+            libraries=["z"],
             extra_compile_args=[
                 "-std=gnu17",
                 "-Ofast",
@@ -46,8 +58,10 @@ setup(
                 "-funroll-loops",
                 "-ffast-math",
                 "-fstrict-aliasing",
+                "-pthread",
             ],
+            extra_link_args=["-pthread"],
         )
     ],
-    extras_require={"dev": ["pytest"]},
+    extras_require={"dev": ["pytest", "qbase58==1.0.4"]},
 )
@@ -0,0 +1,97 @@
+import collections
+
+import pytest
+
+import qborsh
+
+
+@qborsh.schema
+class Trade:
+    mint: qborsh.PubKey
+    venue: qborsh.String
+    amount: qborsh.U128
+    price: qborsh.F64
+    side: qborsh.U8
+
+
+MINTS = [qborsh.PubKey.decode(bytes([i]) * 32) for i in range(4)]
+
+
+def make_records(n):
+    return [
+        {
+            "mint": MINTS[i % 4],
+            "venue": "v" * (i % 3 + 1),
+            "amount": 2**127 + i,
+            "price": i / 8,
+            "side": i % 7,
+        }
+        for i in range(n)
+    ]
+
+
+RECORDS = make_records(20_000)
+ENCODED = [Trade.encode(r) for r in RECORDS]
+BLOB = b"".join(ENCODED)
+
+
+def grouped(op, key, field):
+    groups = collections.defaultdict(list)
+    for r in RECORDS:
+        groups[r[key]].append(r[field])
+    return {k: op(v) for k, v in groups.items()}
+
+
+@pytest.mark.parametrize("source", [BLOB, ENCODED], ids=["concatenated", "sequence"])
+def test_aggregate_ungrouped(source):
+    assert Trade.aggregate(source, None, "count", workers=4) == len(RECORDS)
+    assert Trade.aggregate(source, "amount", "sum", workers=4) == sum(r["amount"] for r in RECORDS)  # exceeds u128
+    assert Trade.aggregate(source, "price", "max", workers=4) == max(r["price"] for r in RECORDS)
+    assert Trade.aggregate(source, "side", "min", workers=4) == 0
+
+
+@pytest.mark.parametrize("op,fn", [("sum", sum), ("min", min), ("max", max), ("count", len)])
+def test_aggregate_group_by(op, fn):
+    assert Trade.aggregate(BLOB, "amount", op, group_by="mint", workers=3) == grouped(fn, "mint", "amount")
+    assert Trade.aggregate(BLOB, "side", op, group_by="venue", workers=3) == grouped(fn, "venue", "side")
+
+
+def test_aggregate_histogram():
+    bins = [0, 2, 4, 6]
+    expected = [0, 0, 0]
+    for r in RECORDS:
+        if r["side"] <= 6:
+            expected[min(r["side"] // 2, 2)] += 1
+    assert Trade.aggregate(BLOB, "side", "histogram", bins=bins, workers=4) == expected
+
+    by_mint = Trade.aggregate(BLOB, "price", "histogram", group_by="mint", bins=[0.0, 100.0, 5000.0])
+    assert sorted(by_mint) == sorted(MINTS)
+    assert sum(sum(counts) for counts in by_mint.values()) == len(RECORDS)
+
+
+def test_aggregate_where():
+    result = Trade.aggregate(BLOB, "amount", "count", group_by="side", where=[("venue", "==", "vv"), ("side", "<", 3)])
+    expected = collections.Counter(r["side"] for r in RECORDS if r["venue"] == "vv" and r["side"] < 3)
+    assert result == dict(expected)
+
+
+def test_aggregate_empty():
+    assert Trade.aggregate(b"", None, "count") == 0
+    assert Trade.aggregate(b"", "amount", "sum") == 0
+    assert Trade.aggregate(b"", "price", "sum") == 0.0
+    assert Trade.aggregate(b"", "amount", "min") is None
+    assert Trade.aggregate(b"", "side", "histogram", bins=[0, 1, 2]) == [0, 0]
+    assert Trade.aggregate(b"", "amount", "sum", group_by="mint") == {}
+
+
+def test_aggregate_errors():
+    with pytest.raises(ValueError, match="Unknown aggregate"):
+        Trade.aggregate(BLOB, "amount", "mean")
+    with pytest.raises(TypeError, match="non-numeric"):
+        Trade.aggregate(BLOB, "venue", "sum")
+    with pytest.raises(ValueError, match="needs bins"):
+        Trade.aggregate(BLOB, "side", "histogram")
+    with pytest.raises(ValueError, match="strictly increasing"):
+        Trade.aggregate(BLOB, "side", "histogram", bins=[2, 1])
+    with pytest.raises(ValueError, match="malformed or truncated"):
+        Trade.aggregate(ENCODED[:3] + [ENCODED[3][:-1]], "side", "sum", group_by="venue")
@@ -0,0 +1,123 @@
+import asyncio
+
+import pytest
+
+import qborsh
+from qborsh import aio
+
+
+@qborsh.schema
+class Quote:
+    seq: qborsh.U32
+    symbol: qborsh.String
+    price: qborsh.F64
+
+
+QUOTES = [{"seq": i, "symbol": "SOL" * (i % 4), "price": i / 4} for i in range(500)]
+
+
+def frame(payload):
+    return aio.FRAME_PREFIX.pack(len(payload)) + payload
+
+
+class FakeTransport(asyncio.Transport):
+    def __init__(self):
+        super().__init__()
+        self.writes = []
+        self.closed = False
+
+    def write(self, data):
+        self.writes.append(bytes(data))
+
+    def is_closing(self):
+        return self.closed
+
+    def close(self):
+        self.closed = True
+
+    def pause_reading(self):
+        pass
+
+    def resume_reading(self):
+        pass
+
+
+def feed(protocol, data, chunk):
+    # Like the event loop: receive at most what get_buffer offers
+    i = 0
+    while i < len(data):
+        buf = protocol.get_buffer(chunk)
+        n = min(len(buf), chunk, len(data) - i)
+        buf[:n] = data[i : i + n]
+        protocol.buffer_updated(n)
+        i += n
+
+
+@pytest.mark.parametrize("chunk", [1, 7, 4096])
+def test_reader_reassembles_frames(chunk):
+    async def main():
+        protocol = aio.FrameReader(Quote, buffer_size=32)
+        protocol.connection_made(FakeTransport())
+        feed(protocol, b"".join(frame(Quote.encode(q)) for q in QUOTES), chunk)
+        protocol.connection_lost(None)
+        return [quote async for quote in protocol]
+
+    assert asyncio.run(main()) == QUOTES
+
+
+def test_reader_rejects_torn_and_oversized_frames():
+    async def main():
+        torn = aio.FrameReader()
+        torn.connection_made(FakeTransport())
+        feed(torn, frame(b"abcdef")[:-2], 64)
+        torn.connection_lost(None)
+        with pytest.raises(ConnectionError):
+            await torn.read()
+
+        big = aio.FrameReader(max_frame=8)
+        transport = FakeTransport()
+        big.connection_made(transport)
+        feed(big, frame(b"x" * 9), 64)
+        assert transport.closed
+        with pytest.raises(ValueError, match="exceeds max_frame"):
+            await big.read()
+
+    asyncio.run(main())
+
+
+def test_writer_batches_one_write_per_tick():
+    async def main():
+        transport = FakeTransport()
+        writer = aio.FrameWriter(transport, schema=Quote)
+        writer.write_many(QUOTES[:100])
+        assert transport.writes == []
+        await asyncio.sleep(0)
+        writer.write(QUOTES[100])
+        await writer.drain()
+        return transport.writes
+
+    writes = asyncio.run(main())
+    assert len(writes) == 2
+    assert writes[0] == b"".join(frame(Quote.encode(q)) for q in QUOTES[:100])
+
+
+def test_server_roundtrip():
+    async def main():
+        async def echo(reader, writer):
+            async for quote in reader:
+                writer.write({**quote, "price": quote["price"] * 2})
+            writer.close()
+
+        server = await aio.start_server(echo, "127.0.0.1", 0, schema=Quote)
+        port = server.sockets[0].getsockname()[1]
+        async with server:
+            reader, writer = await aio.open_connection("127.0.0.1", port, schema=Quote)
+            writer.write_many(QUOTES)
+            await writer.drain()
+            replies = [await reader.read() for _ in QUOTES]
+            writer.close()
+        return replies
+
+    replies = asyncio.run(main())
+    assert [r["seq"] for r in replies] == [q["seq"] for q in QUOTES]
+    assert replies[9]["price"] == QUOTES[9]["price"] * 2
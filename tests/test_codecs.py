@@ -0,0 +1,96 @@
+import zlib
+
+import pytest
+
+import qborsh
+from qborsh.codecs import get_codec, register_codec
+
+
+@qborsh.schema
+class Entry:
+    slot: qborsh.U64
+    memo: qborsh.String
+
+
+RECORDS = [{"slot": i, "memo": "x" * (i % 9)} for i in range(5_000)]
+
+
+def write_log(path, records=RECORDS, **kwargs):
+    with qborsh.RecordLog(path, "w", schema=Entry, codec="zlib", block_size=4096, **kwargs) as log:
+        log.extend(records)
+
+
+def test_compressed_log_roundtrip(tmp_path):
+    path = tmp_path / "entries.log"
+    write_log(path)
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert log.blocked and log.codec.name == "zlib"
+        assert not log.recovered
+        assert len(log) == len(RECORDS)
+        assert log[3333] == RECORDS[3333]
+        assert log[0] == RECORDS[0]
+        assert log[-1] == RECORDS[-1]
+        assert list(log) == RECORDS
+        log.check()
+
+
+def test_compressed_log_is_smaller(tmp_path):
+    raw, packed = tmp_path / "raw.log", tmp_path / "packed.log"
+    with qborsh.RecordLog(raw, "w", schema=Entry) as log:
+        log.extend(RECORDS)
+    write_log(packed)
+    assert packed.stat().st_size * 3 < raw.stat().st_size
+
+
+def test_compressed_log_append(tmp_path):
+    path = tmp_path / "entries.log"
+    write_log(path, RECORDS[:1000])
+    with qborsh.RecordLog(path, "a", schema=Entry) as log:
+        assert len(log) == 1000
+        assert log.append(RECORDS[1000]) == 1000
+        log.extend(RECORDS[1001:])
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert list(log) == RECORDS
+
+
+def test_compressed_log_recovers_without_footer(tmp_path):
+    path = tmp_path / "entries.log"
+    log = qborsh.RecordLog(path, "w", schema=Entry, codec="zlib", block_size=4096)
+    log.extend(RECORDS[:2000])
+    log.flush()
+    del log
+
+    with open(path, "ab") as f:
+        f.write(b"\x10\x00\x00\x00\x00")
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert log.recovered
+        assert list(log) == RECORDS[:2000]
+
+
+def test_custom_codec(tmp_path):
+    class Fast:
+        name = "zlib-1"
+
+        def compress(self, data):
+            return zlib.compress(data, 1)
+
+        def decompress(self, data):
+            return zlib.decompress(data)
+
+    register_codec(Fast())
+    assert get_codec("zlib-1").name == "zlib-1"
+
+    path = tmp_path / "entries.log"
+    with qborsh.RecordLog(path, "w", schema=Entry, codec="zlib-1") as log:
+        log.extend(RECORDS[:100])
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert log.codec.name == "zlib-1"
+        assert list(log) == RECORDS[:100]
+
+
+def test_unknown_codec(tmp_path):
+    with pytest.raises(ValueError, match="Unknown codec"):
+        qborsh.RecordLog(tmp_path / "x.log", "w", codec="nope")
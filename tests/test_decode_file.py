@@ -0,0 +1,70 @@
+import os
+
+import pytest
+
+import qborsh
+from qborsh.types import base
+
+
+@qborsh.schema
+class Entry:
+    slot: qborsh.U64
+    memo: qborsh.String
+    values: qborsh.Vector[qborsh.U32]
+
+
+VALUE = {"slot": 7, "memo": "hello", "values": [1, 2, 3]}
+
+
+def test_decode_file_path_and_fd(tmp_path):
+    path = tmp_path / "entry.bin"
+    path.write_bytes(Entry.encode(VALUE))
+
+    assert Entry.decode_file(path) == VALUE
+    assert Entry.decode_file(str(path)) == VALUE
+
+    fd = os.open(path, os.O_RDONLY)
+    try:
+        assert Entry.decode_file(fd) == VALUE
+    finally:
+        os.close(fd)
+
+    with open(path, "rb") as f:
+        assert Entry.decode_file(f) == VALUE
+
+
+def test_decode_file_offset_and_length(tmp_path):
+    path = tmp_path / "entries.bin"
+    first = Entry.encode(VALUE)
+    second = Entry.encode({**VALUE, "slot": 8})
+    path.write_bytes(b"\xff" * 3 + first + second + b"trailer")
+
+    assert Entry.decode_file(path, offset=3, length=len(first)) == VALUE
+    assert Entry.decode_file(path, 3 + len(first), len(second))["slot"] == 8
+    assert qborsh.U64.decode_file(path, offset=3) == 7
+
+
+def test_decode_file_truncated(tmp_path):
+    path = tmp_path / "entry.bin"
+    path.write_bytes(Entry.encode(VALUE))
+    with pytest.raises(ValueError, match="File ends"):
+        Entry.decode_file(path, offset=4, length=100)
+
+
+def test_decode_file_mmap(tmp_path, monkeypatch):
+    monkeypatch.setattr(base, "MMAP_THRESHOLD", 16)
+    path = tmp_path / "entries.bin"
+    payload = Entry.encode({**VALUE, "values": list(range(10_000))})
+    path.write_bytes(b"\x00" * 5000 + payload)
+
+    assert Entry.decode_file(path, offset=5000)["values"][-1] == 9_999
+
+
+def test_buffer_read_from(tmp_path):
+    path = tmp_path / "raw.bin"
+    path.write_bytes(b"\x01\x02\x03\x04\x05")
+    buf = qborsh.csrc.Buffer(1)
+    with open(path, "rb") as f:
+        assert buf.read_from(f.fileno(), 1, 10) == 4
+    assert bytes(buf.data[: buf.size]) == b"\x02\x03\x04\x05"
+    assert buf.read_u8() == 2
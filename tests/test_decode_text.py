@@ -0,0 +1,48 @@
+import base64
+import os
+
+import pytest
+import qbase58
+
+import qborsh
+
+
+@qborsh.schema
+class Account:
+    owner: qborsh.PubKey
+    lamports: qborsh.U64
+    data: qborsh.Bytes
+
+
+RAW = Account.encode({"owner": bytes(range(32)), "lamports": 5, "data": b"\x00\x01" * 100})
+
+
+def test_decode_b64():
+    text = base64.b64encode(RAW).decode()
+    assert Account.decode_b64(text) == Account.decode(RAW)
+    assert Account.decode_b64(text.encode()) == Account.decode(RAW)
+
+
+def test_decode_b58():
+    assert Account.decode_b58(qbase58.encode(RAW)) == Account.decode(RAW)
+
+
+@pytest.mark.parametrize("size", [0, 1, 2, 3, 31, 32, 33, 100])
+def test_buffer_read_text(size):
+    data = b"\x00\x00" + os.urandom(size)
+    buf = qborsh.Buffer(1)
+    assert buf.read_base64(base64.b64encode(data).decode()) == len(data)
+    assert bytes(buf.data[: buf.size]) == data
+    assert buf.read_base58(qbase58.encode(data)) == len(data)
+    assert bytes(buf.data[: buf.size]) == data
+
+
+@pytest.mark.parametrize("text", ["abc", "ab=c", "a===", "ab\ncd", "é" * 4])
+def test_invalid_base64(text):
+    with pytest.raises(ValueError, match="Invalid base64"):
+        Account.decode_b64(text)
+
+
+def test_invalid_base58():
+    with pytest.raises(ValueError, match="Invalid base58"):
+        Account.decode_b58("0OIl")
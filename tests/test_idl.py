@@ -0,0 +1,172 @@
+import json
+
+import pytest
+
+import qborsh
+from qborsh import Registry
+
+OWNER = bytes(range(32))
+
+IDL = {
+    "address": "Amm1111111111111111111111111111111111111111",
+    "metadata": {"name": "amm", "version": "0.1.0", "spec": "0.1.0"},
+    "instructions": [
+        {
+            "name": "swap",
+            "discriminator": [248, 198, 158, 145, 225, 117, 135, 200],
+            "accounts": [],
+            "args": [{"name": "amount_in", "type": "u64"}, {"name": "side", "type": {"defined": {"name": "Side"}}}],
+        },
+        {"name": "sync", "discriminator": [1, 2, 3, 4, 5, 6, 7, 8], "accounts": [], "args": []},
+    ],
+    "accounts": [{"name": "Pool", "discriminator": [241, 154, 109, 4, 17, 177, 109, 188]}],
+    "events": [{"name": "Swapped", "discriminator": [9, 9, 9, 9, 9, 9, 9, 9]}],
+    "types": [
+        {
+            "name": "Pool",
+            "type": {
+                "kind": "struct",
+                "fields": [
+                    {"name": "owner", "type": "pubkey"},
+                    {"name": "liquidity", "type": "u64"},
+                    {"name": "fees", "type": {"array": ["u16", 2]}},
+                    {"name": "seed", "type": {"array": ["u8", 4]}},
+                    {"name": "label", "type": {"option": "string"}},
+                    {"name": "ticks", "type": {"vec": {"defined": {"name": "Tick"}}}},
+                ],
+            },
+        },
+        {"name": "Tick", "type": {"kind": "struct", "fields": ["i32", "u128"]}},
+        {
+            "name": "Side",
+            "type": {
+                "kind": "enum",
+                "variants": [
+                    {"name": "Bid"},
+                    {"name": "Ask", "fields": [{"name": "limit", "type": "u64"}]},
+                    {"name": "Both", "fields": ["u8", "u8"]},
+                ],
+            },
+        },
+        {"name": "Swapped", "type": {"kind": "struct", "fields": [{"name": "amount", "type": "u64"}]}},
+        {"name": "Price", "type": {"kind": "type", "alias": "u64"}},
+    ],
+}
+
+LEGACY_IDL = {
+    "version": "0.1.0",
+    "name": "vault",
+    "instructions": [{"name": "depositFunds", "accounts": [], "args": [{"name": "amount", "type": "u64"}]}],
+    "accounts": [
+        {
+            "name": "Vault",
+            "type": {
+                "kind": "struct",
+                "fields": [{"name": "authority", "type": "publicKey"}, {"name": "balance", "type": "u64"}],
+            },
+        }
+    ],
+    "events": [{"name": "Deposited", "fields": [{"name": "amount", "type": "u64", "index": False}]}],
+}
+
+
+def pool_data() -> bytes:
+    return (
+        bytes([241, 154, 109, 4, 17, 177, 109, 188])
+        + OWNER
+        + (1000).to_bytes(8, "little")
+        + b"\x05\x00\x1e\x00"
+        + b"seed"
+        + b"\x01\x03\x00\x00\x00sol"
+        + b"\x01\x00\x00\x00"
+        + (-3).to_bytes(4, "little", signed=True)
+        + (7).to_bytes(16, "little")
+    )
+
+
+def test_load_sources(tmp_path):
+    path = tmp_path / "amm.json"
+    path.write_text(json.dumps(IDL))
+    for source in (IDL, json.dumps(IDL), str(path), path):
+        idl = qborsh.idl.load(source)
+        assert idl.name == "amm" and idl.address == IDL["address"]
+        assert set(idl.types) == {"Pool", "Tick", "Side", "Swapped", "Price"}
+
+
+def test_accounts():
+    idl = qborsh.idl.load(IDL)
+    name, pool = idl.decode_account(pool_data())
+    assert name == "Pool"
+    assert pool == {
+        "owner": qborsh.PubKey.decode(OWNER),
+        "liquidity": 1000,
+        "fees": [5, 30],
+        "seed": b"seed",
+        "label": "sol",
+        "ticks": [(-3, 7)],
+    }
+    assert idl.accounts.decode_many([pool_data()] * 3) == [pool] * 3
+    with pytest.raises(KeyError):
+        idl.decode_account(b"\x00" * 8)
+
+
+def test_types_and_instructions():
+    idl = qborsh.idl.load(IDL)
+    assert idl.decode_type("Side", b"\x00") == ("Bid", None)
+    assert idl.decode_type("Side", b"\x01" + (9).to_bytes(8, "little")) == ("Ask", {"limit": 9})
+    assert idl.decode_type("Side", b"\x02\x01\x02") == ("Both", (1, 2))
+    assert idl.decode_type("Price", (5).to_bytes(8, "little")) == 5
+    assert idl.layout("Tick") is idl.layout("Tick")
+
+    swap = bytes(IDL["instructions"][0]["discriminator"]) + (50).to_bytes(8, "little") + b"\x00"
+    assert idl.decode_instruction(swap) == ("swap", {"amount_in": 50, "side": ("Bid", None)})
+    assert idl.decode_instruction(bytes(range(1, 9))) == ("sync", {})
+    assert idl.decode_event(b"\x09" * 8 + (4).to_bytes(8, "little")) == ("Swapped", {"amount": 4})
+
+
+def test_legacy_format():
+    idl = qborsh.idl.load(LEGACY_IDL)
+    assert idl.name == "vault"
+    data = Registry.anchor_discriminator("account", "Vault") + OWNER + (3).to_bytes(8, "little")
+    assert idl.decode_account(data) == ("Vault", {"authority": qborsh.PubKey.decode(OWNER), "balance": 3})
+
+    deposit = Registry.anchor_discriminator("global", "deposit_funds") + (8).to_bytes(8, "little")
+    assert idl.decode_instruction(deposit) == ("depositFunds", {"amount": 8})
+    event = Registry.anchor_discriminator("event", "Deposited") + (2).to_bytes(8, "little")
+    assert idl.decode_event(event) == ("Deposited", {"amount": 2})
+
+
+def test_unsupported():
+    idl = qborsh.idl.load(
+        {
+            "types": [
+                {
+                    "name": "Node",
+                    "type": {"kind": "struct", "fields": [{"name": "next", "type": {"option": {"defined": "Node"}}}]},
+                },
+                {"name": "Wide", "type": {"kind": "struct", "fields": [{"name": "x", "type": "u256"}]}},
+                {
+                    "name": "Boxed",
+                    "generics": [{"kind": "type", "name": "T"}],
+                    "type": {"kind": "struct", "fields": [{"name": "x", "type": {"generic": "T"}}]},
+                },
+                {
+                    "name": "ZeroCopy",
+                    "serialization": "bytemuck",
+                    "repr": {"kind": "c"},
+                    "type": {"kind": "struct", "fields": [{"name": "a", "type": "u8"}, {"name": "b", "type": "u64"}]},
+                },
+                {
+                    "name": "Plain",
+                    "serialization": "borsh",
+                    "type": {"kind": "struct", "fields": [{"name": "a", "type": "u8"}]},
+                },
+            ]
+        }
+    )
+    assert idl.decode_type("Plain", b"\x07") == {"a": 7}
+    for name in ("Node", "Wide", "Boxed", "ZeroCopy"):
+        with pytest.raises(ValueError):
+            idl.layout(name)
+    with pytest.raises(KeyError):
+        idl.layout("Missing")
@@ -0,0 +1,59 @@
+import pytest
+
+import qborsh
+
+
+@qborsh.schema
+class Account:
+    owner: qborsh.PubKey
+    name: qborsh.String
+    lamports: qborsh.U64
+
+
+OWNERS = [qborsh.PubKey.decode(i.to_bytes(32, "little")) for i in range(1, 2001)]
+RECORDS = [{"owner": OWNERS[i % 2000], "name": f"acct-{i}", "lamports": i} for i in range(3000)]
+ENCODED = [Account.encode(r) for r in RECORDS]
+BLOB = b"".join(ENCODED)
+
+
+def test_index_get():
+    index = Account.build_index(BLOB, "owner", workers=4)
+    assert len(index) == len(RECORDS)
+    for i in (0, 1, 999, 1999):
+        assert index.get(OWNERS[i]) == RECORDS[i]
+    missing = qborsh.PubKey.decode(b"\xff" * 32)
+    assert index.get(missing) is None
+    assert missing not in index
+    assert OWNERS[5] in index
+
+
+def test_index_duplicates():
+    index = Account.build_index(ENCODED, "owner")
+    assert index.get_all(OWNERS[7]) == [RECORDS[7], RECORDS[2007]]
+    offset, length = index.offsets(OWNERS[7])[1]
+    assert BLOB[offset : offset + length] == ENCODED[2007]
+
+
+def test_index_variable_key():
+    index = Account.build_index(BLOB, "name")
+    assert index.get("acct-2500") == RECORDS[2500]
+    assert index.get("acct-3000") is None
+
+
+def test_index_save_load(tmp_path):
+    records = tmp_path / "accounts.bin"
+    records.write_bytes(BLOB)
+    Account.build_index(records, "owner").save(tmp_path / "owner.idx")
+
+    with Account.load_index(tmp_path / "owner.idx", records) as index:
+        assert index.get(OWNERS[42]) == RECORDS[42]
+        assert len(index) == len(RECORDS)
+
+
+def test_index_errors(tmp_path):
+    index = Account.build_index(BLOB, "owner")
+    with pytest.raises(ValueError, match="corrupt"):
+        qborsh.csrc.Index(Account.compile(), index._data[:-1], BLOB)
+    with pytest.raises(ValueError, match="malformed or truncated"):
+        Account.build_index(BLOB[:-1], "owner")
+    assert len(Account.build_index(b"", "owner")) == 0
@@ -0,0 +1,155 @@
+import multiprocessing
+import os
+import queue
+import subprocess
+import sys
+
+import pytest
+
+import qborsh
+from qborsh.ipc import Ring
+
+
+@qborsh.schema
+class Message:
+    seq: qborsh.U64
+    producer: qborsh.U8
+    body: qborsh.String
+
+
+FORK = multiprocessing.get_context("fork")
+
+
+@pytest.fixture
+def ring():
+    ring = Ring(slots=8, slot_size=64, schema=Message)
+    yield ring
+    ring.close()
+    ring.unlink()
+
+
+def test_ring_roundtrip(ring):
+    assert len(ring) == 0
+    ring.put({"seq": 1, "producer": 0, "body": "hi"})
+    ring.put({"seq": 2, "producer": 0, "body": ""})
+    assert len(ring) == 2
+    assert ring.get() == {"seq": 1, "producer": 0, "body": "hi"}
+    assert ring.get()["seq"] == 2
+    with pytest.raises(queue.Empty):
+        ring.get(block=False)
+
+
+def test_ring_full_and_wraparound(ring):
+    for _ in range(3):
+        for i in range(8):
+            ring.put({"seq": i, "producer": 0, "body": "x"}, block=False)
+        with pytest.raises(queue.Full):
+            ring.put({"seq": 8, "producer": 0, "body": "x"}, timeout=0.01)
+        assert [ring.get()["seq"] for _ in range(8)] == list(range(8))
+
+
+def test_ring_oversized_message_is_skipped(ring):
+    with pytest.raises(ValueError, match="does not fit"):
+        ring.put({"seq": 0, "producer": 0, "body": "x" * 100})
+    ring.put({"seq": 1, "producer": 0, "body": "ok"})
+    assert ring.get()["seq"] == 1
+
+
+class Failing(qborsh.BorshType):
+    def serialize(self, buf, value):
+        raise RuntimeError("encoder broke")
+
+    def deserialize(self, buf):
+        return None
+
+    def sizeof(self):
+        return None
+
+
+def test_encode_into_errors():
+    target = bytearray(4)
+    assert qborsh.U32.encode_into(7, target) == 4 and target == b"\x07\x00\x00\x00"
+    with pytest.raises(ValueError, match="does not fit"):
+        qborsh.U64.encode_into(7, target)
+    with pytest.raises(RuntimeError, match="encoder broke"):
+        Failing.encode_into(7, target)
+
+
+def test_ring_raw_bytes():
+    with Ring(slots=4, slot_size=16) as ring:
+        ring.put(b"abc")
+        assert ring.get() == b"abc"
+        with pytest.raises(ValueError, match="exceeds the slot size"):
+            ring.put(b"x" * 17)
+        ring.unlink()
+
+
+def produce(name, producer, count):
+    with Ring(name, create=False, schema=Message) as ring:
+        for seq in range(count):
+            ring.put({"seq": seq, "producer": producer, "body": "m" * (seq % 5)})
+
+
+def test_ring_across_processes():
+    count = 5_000
+    with Ring(slots=64, slot_size=64, schema=Message) as ring:
+        process = FORK.Process(target=produce, args=(ring.name, 0, count))
+        process.start()
+        received = [ring.get(timeout=10) for _ in range(count)]
+        process.join()
+        ring.unlink()
+    assert [m["seq"] for m in received] == list(range(count))
+    assert received[7]["body"] == "mm"
+
+
+ATTACH_SCRIPT = """
+import os, sys
+from multiprocessing import resource_tracker
+from qborsh.ipc import Ring
+
+ring = Ring(sys.argv[1], create=False)
+ring.put(b"hi")
+ring.close()
+# Wait for this process's resource tracker to exit, i.e. finish any cleanup
+tracker = resource_tracker._resource_tracker
+if tracker._pid is not None:
+    os.close(tracker._fd)
+    os.waitpid(tracker._pid, 0)
+"""
+
+
+def test_ring_attach_from_independent_process():
+    # A process outside multiprocessing has its own resource tracker, which
+    # must not unlink the ring when that process exits
+    with Ring(slots=8, slot_size=64) as ring:
+        env = dict(os.environ, PYTHONPATH=os.pathsep.join(sys.path))
+        subprocess.run([sys.executable, "-c", ATTACH_SCRIPT, ring.name], env=env, check=True, timeout=60)
+        with Ring(ring.name, create=False) as attached:
+            assert len(attached) == 1
+        assert ring.get(timeout=10) == b"hi"
+        ring.unlink()
+
+
+def test_ring_multi_producer():
+    count, producers = 3_000, 3
+    with Ring(slots=32, slot_size=64, schema=Message, multi_producer=True) as ring:
+        attached = Ring(ring.name, create=False)
+        assert attached.multi_producer and attached.slots == 32
+        attached.close()
+
+        processes = [FORK.Process(target=produce, args=(ring.name, p, count)) for p in range(producers)]
+        for process in processes:
+            process.start()
+        received = [ring.get(timeout=10) for _ in range(count * producers)]
+        for process in processes:
+            process.join()
+        ring.unlink()
+
+    for p in range(producers):
+        # Every producer's messages arrive complete and in order
+        assert [m["seq"] for m in received if m["producer"] == p] == list(range(count))
+
+
+def test_ring_rejects_bad_sizes():
+    with pytest.raises(ValueError):
+        Ring(slots=3, slot_size=16)
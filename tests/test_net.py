@@ -0,0 +1,66 @@
+import socket
+import threading
+
+import pytest
+
+import qborsh
+from qborsh import net
+
+
+@qborsh.schema
+class Order:
+    id: qborsh.U64
+    side: qborsh.U8
+    note: qborsh.String
+
+
+ORDERS = [{"id": i, "side": i % 2, "note": "n" * (i % 50)} for i in range(3_000)]
+
+
+def test_send_and_recv_messages():
+    a, b = socket.socketpair()
+    with a, b:
+        sender = threading.Thread(target=net.send_messages, args=(a, Order, ORDERS))
+        sender.start()
+        received = [net.recv_message(b, Order) for _ in ORDERS]
+        sender.join()
+    assert received == ORDERS
+
+
+def test_raw_frames_and_eof():
+    a, b = socket.socketpair()
+    with b:
+        with a:
+            net.send_messages(a, None, [b"abc", b"", bytearray(b"x" * 5000), b""])
+            net.send_message(a, qborsh.U32, 7)
+        assert net.recv_message(b) == b"abc"
+        assert net.recv_message(b) == b""
+        assert net.recv_message(b) == b"x" * 5000
+        assert net.recv_message(b) == b""
+        assert net.recv_message(b, qborsh.U32) == 7
+        with pytest.raises(EOFError):
+            net.recv_message(b)
+
+
+def test_recv_rejects_torn_and_oversized_frames():
+    a, b = socket.socketpair()
+    with b:
+        with a:
+            a.sendall(b"\x10\x00\x00\x00abc")
+        with pytest.raises(ConnectionError):
+            net.recv_message(b)
+
+    a, b = socket.socketpair()
+    with a, b:
+        a.sendall(b"\xff\xff\x00\x00")
+        with pytest.raises(ValueError, match="exceeds max_frame"):
+            net.recv_message(b, max_frame=1024)
+
+
+def test_recv_into_own_buffer():
+    buf = qborsh.Buffer(4)
+    a, b = socket.socketpair()
+    with a, b:
+        net.send_messages(a, Order, ORDERS[:2], buffer=buf)
+        assert net.recv_message(b, Order, buffer=buf) == ORDERS[0]
+        assert net.recv_message(b, Order, buffer=buf) == ORDERS[1]
@@ -0,0 +1,75 @@
+import os
+
+import pytest
+
+import qborsh
+from qborsh import parallel
+
+
+@qborsh.schema
+class Transfer:
+    slot: qborsh.U64
+    amount: qborsh.U64
+    memo: qborsh.String
+
+
+RECORDS = [{"slot": i, "amount": i * 3, "memo": "m" * (i % 7)} for i in range(10_000)]
+
+
+@pytest.fixture
+def path(tmp_path):
+    path = tmp_path / "transfers.bin"
+    path.write_bytes(b"".join(Transfer.encode(r) for r in RECORDS))
+    return path
+
+
+def test_parallel_decode_file(path):
+    assert parallel.decode_file(Transfer, path, workers=3) == RECORDS
+    assert parallel.decode_file(Transfer, path, workers=1) == RECORDS
+
+
+def test_parallel_decode_file_fn(path):
+    totals = parallel.decode_file(Transfer, path, workers=4, fn=lambda rs: sum(r["amount"] for r in rs))
+    assert len(totals) == 4
+    assert sum(totals) == sum(r["amount"] for r in RECORDS)
+
+
+def test_parallel_decode_empty(tmp_path):
+    path = tmp_path / "empty.bin"
+    path.write_bytes(b"")
+    assert parallel.decode_file(Transfer, path, workers=2) == []
+    assert parallel.decode_file(Transfer, path, workers=2, fn=len) == [0]
+
+
+def test_parallel_decode_truncated(path):
+    with open(path, "ab") as f:
+        f.write(b"\x01\x02")
+    with pytest.raises(ValueError, match="malformed or truncated"):
+        parallel.decode_file(Transfer, path, workers=2)
+
+
+def _fail_on_first(records):
+    if records and records[0]["slot"] == 0:
+        raise RuntimeError("shard failed")
+    return len(records)
+
+
+def _shm_blocks() -> set:
+    return {name for name in os.listdir("/dev/shm") if name.startswith("psm_")} if os.path.isdir("/dev/shm") else set()
+
+
+def test_parallel_failed_shard_leaks_nothing(path):
+    before = _shm_blocks()
+    with pytest.raises(RuntimeError, match="shard failed"):
+        parallel.decode_file(Transfer, path, workers=4, fn=_fail_on_first)
+    assert _shm_blocks() - before == set()
+
+
+@pytest.mark.parametrize("codec", [None, "zlib"])
+def test_parallel_decode_record_log(tmp_path, codec):
+    path = tmp_path / "transfers.log"
+    with qborsh.RecordLog(path, "w", schema=Transfer, codec=codec) as log:
+        log.extend(RECORDS)
+    assert parallel.decode_file(Transfer, path, workers=3) == RECORDS
+    assert parallel.decode_file(Transfer, path, workers=4, fn=len) == [2500] * 4
+    assert parallel.decode_file(Transfer, path, workers=1) == RECORDS
@@ -0,0 +1,72 @@
+import array
+
+import pytest
+
+import qborsh
+from qborsh import csrc
+
+
+@qborsh.schema
+class Entry:
+    slot: qborsh.U64
+    memo: qborsh.String
+
+
+RECORDS = [{"slot": i, "memo": "y" * (i % 13)} for i in range(20_000)]
+
+
+@pytest.fixture
+def log_path(tmp_path):
+    path = tmp_path / "entries.log"
+    with qborsh.RecordLog(path, "w", schema=Entry, codec="zlib", block_size=8192) as log:
+        log.extend(RECORDS)
+    return path
+
+
+def test_blocks_stream_in_order(log_path):
+    with qborsh.RecordLog(log_path, schema=Entry) as log:
+        seen = 0
+        for first, block, offsets in log.blocks(readahead=2):
+            assert first == seen
+            start, length = csrc.frame_span(block, offsets[0])
+            assert Entry.decode(block[start : start + length]) == RECORDS[first]
+            seen += len(offsets)
+        assert seen == len(RECORDS)
+        assert list(log) == RECORDS
+
+
+def test_readahead_stops_early(log_path):
+    with qborsh.RecordLog(log_path, schema=Entry) as log:
+        for i, record in enumerate(log):
+            if i == 10:
+                break
+        assert record == RECORDS[10]
+
+
+def test_readahead_reports_corrupt_block(log_path):
+    with qborsh.RecordLog(log_path, schema=Entry) as log:
+        middle = log._blocks[len(log._blocks) // 2]
+    data = bytearray(log_path.read_bytes())
+    data[middle + 20] ^= 0xFF
+    log_path.write_bytes(bytes(data))
+
+    with qborsh.RecordLog(log_path, schema=Entry) as log:
+        with pytest.raises(ValueError, match="Block .* truncated or corrupt"):
+            list(log)
+
+
+def test_readahead_raw_frames(tmp_path):
+    path = tmp_path / "frames.bin"
+    payloads = [b"abc", b"", b"x" * 1000]
+    bounds = [0]
+    with open(path, "wb") as f:
+        for payload in payloads:
+            f.write(len(payload).to_bytes(4, "little") + csrc.crc32c(payload).to_bytes(4, "little") + payload)
+            bounds.append(bounds[-1] + 8 + len(payload))
+
+    packed = array.array("Q", bounds).tobytes()
+    with open(path, "rb") as f:
+        reader = csrc.Readahead(f.fileno(), packed, depth=1)
+    assert [(i, bytes(block), offsets) for i, block, offsets in reader] == [
+        (i, payload, None) for i, payload in enumerate(payloads)
+    ]
@@ -0,0 +1,110 @@
+import pytest
+
+import qborsh
+
+
+@qborsh.schema
+class Entry:
+    slot: qborsh.U64
+    memo: qborsh.String
+
+
+RECORDS = [{"slot": i, "memo": "x" * (i % 9)} for i in range(2_000)]
+
+
+def write_log(path, records=RECORDS):
+    with qborsh.RecordLog(path, "w", schema=Entry) as log:
+        log.extend(records)
+
+
+def test_recordlog_roundtrip(tmp_path):
+    path = tmp_path / "entries.log"
+    write_log(path)
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert len(log) == len(RECORDS)
+        assert not log.recovered
+        assert log[0] == RECORDS[0]
+        assert log[1234] == RECORDS[1234]
+        assert log[-1] == RECORDS[-1]
+        assert list(log) == RECORDS
+        log.check()
+        with pytest.raises(IndexError):
+            log[len(RECORDS)]
+
+
+def test_recordlog_raw_views(tmp_path):
+    path = tmp_path / "raw.log"
+    with qborsh.RecordLog(path, "w") as log:
+        assert log.append(b"abc") == 0
+        log.append(b"")
+
+    with qborsh.RecordLog(path) as log:
+        view = log[0]
+        assert isinstance(view, memoryview) and bytes(view) == b"abc"
+        view.release()
+        assert bytes(log[1]) == b""
+
+
+def test_recordlog_append(tmp_path):
+    path = tmp_path / "entries.log"
+    write_log(path, RECORDS[:500])
+    with qborsh.RecordLog(path, "a", schema=Entry) as log:
+        assert len(log) == 500
+        log.extend(RECORDS[500:])
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert list(log) == RECORDS
+
+
+def test_recordlog_append_creates(tmp_path):
+    path = tmp_path / "new.log"
+    with qborsh.RecordLog(path, "a", schema=Entry) as log:
+        log.extend(RECORDS[:10])
+    with qborsh.RecordLog(path, "a", schema=Entry) as log:
+        log.extend(RECORDS[10:20])
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert list(log) == RECORDS[:20]
+
+
+def test_recordlog_recovers_torn_tail(tmp_path):
+    path = tmp_path / "entries.log"
+    log = qborsh.RecordLog(path, "w", schema=Entry)
+    log.extend(RECORDS[:100])
+    log.flush()
+    del log  # no footer
+
+    # Simulate a partially written frame
+    with open(path, "ab") as f:
+        f.write(b"\x10\x00\x00\x00\x00")
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        assert log.recovered
+        assert list(log) == RECORDS[:100]
+
+
+def test_recordlog_detects_corruption(tmp_path):
+    path = tmp_path / "entries.log"
+    write_log(path)
+    data = bytearray(path.read_bytes())
+    data[100] ^= 0xFF
+    path.write_bytes(bytes(data))
+
+    with qborsh.RecordLog(path, schema=Entry) as log:
+        with pytest.raises(ValueError, match="truncated or corrupt"):
+            log.check()
+        with pytest.raises(ValueError, match="truncated or corrupt"):
+            list(log)
+
+
+def test_recordlog_rejects_other_files(tmp_path):
+    path = tmp_path / "other.bin"
+    path.write_bytes(b"not a record log at all")
+    with pytest.raises(ValueError, match="not a record log"):
+        qborsh.RecordLog(path)
+
+
+def test_decode_accepts_memoryview():
+    encoded = Entry.encode(RECORDS[7])
+    assert Entry.decode(memoryview(b"\x00" + encoded)[1:]) == RECORDS[7]
@@ -0,0 +1,130 @@
+import pytest
+
+import qborsh
+from qborsh import Registry
+
+
+@qborsh.schema
+class Pool:
+    mint: qborsh.FixedBytes[4]
+    liquidity: qborsh.U64
+
+
+@qborsh.schema
+class Position:
+    owner: qborsh.String
+    shares: qborsh.Vector[qborsh.U32]
+
+
+class Opaque(qborsh.BorshType):
+    """
+    A type without a native layout, decoded through the Python fallback.
+    """
+
+    def serialize(self, buf, value):
+        buf.write_u16(value)
+
+    def deserialize(self, buf):
+        return buf.read_u16() * 2
+
+    def sizeof(self, value=None):
+        return 2
+
+    def layout(self):
+        return None
+
+
+POOL = Registry.anchor_discriminator("account", "Pool")
+POSITION = Registry.anchor_discriminator("account", "Position")
+
+
+def anchor_registry() -> Registry:
+    registry = Registry()
+    registry.register(POOL, Pool)
+    registry.register(POSITION, Position)
+    return registry
+
+
+def test_anchor_discriminator():
+    import hashlib
+
+    assert POOL == hashlib.sha256(b"account:Pool").digest()[:8]
+
+
+def test_decode():
+    registry = anchor_registry()
+    pool = {"mint": b"mint", "liquidity": 7}
+    position = {"owner": "alice", "shares": [1, 2]}
+    assert registry.decode(POOL + Pool.encode(pool)) == pool
+    assert registry.decode(POSITION + Position.encode(position), tagged=True) == ("Position", position)
+    assert type(registry.schema(POOL + b"rest")).__name__ == "Pool"
+    assert registry.schema(b"\x00" * 8) is None
+    assert len(registry) == 2 and POSITION in registry
+
+
+def test_decode_many():
+    registry = anchor_registry()
+    values = [{"mint": bytes([i]) * 4, "liquidity": i} for i in range(50)]
+    records = [POOL + Pool.encode(value) for value in values]
+    records.insert(10, bytearray(POSITION + Position.encode({"owner": "bob", "shares": []})))
+    decoded = registry.decode_many(records, tagged=True)
+    assert decoded[10] == ("Position", {"owner": "bob", "shares": []})
+    assert [value for _, value in decoded[:10] + decoded[11:]] == values
+    assert registry.decode_many(iter(records[:2])) == [values[0], values[1]]
+
+
+def test_unknown_discriminator():
+    registry = anchor_registry()
+    with pytest.raises(KeyError):
+        registry.decode(b"\x00" * 8 + b"payload")
+    with pytest.raises(KeyError):
+        registry.decode(POOL[:3])
+    with pytest.raises(KeyError):
+        registry.decode_many([POOL + Pool.encode({"mint": b"mint", "liquidity": 1}), b"\xff" * 9])
+
+
+@pytest.mark.parametrize("width", [1, 4])
+def test_narrow_discriminators(width):
+    registry = Registry(width=width)
+    for tag in range(200):
+        registry.register(tag, qborsh.U32, name=f"t{tag}")
+    for tag in range(200):
+        data = tag.to_bytes(width, "little") + qborsh.U32.encode(tag * 3)
+        assert registry.decode(data, tagged=True) == (f"t{tag}", tag * 3)
+
+
+def test_register_after_decode():
+    registry = anchor_registry()
+    assert registry.decode(POOL + Pool.encode({"mint": b"mint", "liquidity": 1}))["liquidity"] == 1
+    native = registry._native
+    for i in range(5000):
+        registry.register(Registry.anchor_discriminator("account", f"A{i}"), qborsh.U32, name=f"A{i}")
+    registry.register(Registry.anchor_discriminator("account", "Opaque"), Opaque)
+    assert registry._native is native
+    for i in range(0, 5000, 7):
+        data = Registry.anchor_discriminator("account", f"A{i}") + qborsh.U32.encode(i)
+        assert registry.decode(data, tagged=True) == (f"A{i}", i)
+    assert registry.decode(Registry.anchor_discriminator("account", "Opaque") + b"\x03\x00") == 6
+    assert registry.decode(POSITION + Position.encode({"owner": "a", "shares": []}))["owner"] == "a"
+    with pytest.raises(ValueError):
+        registry.register(Registry.anchor_discriminator("account", "A3"), qborsh.U8)
+    assert registry.decode(Registry.anchor_discriminator("account", "A3") + qborsh.U32.encode(3)) == 3
+
+
+def test_python_fallback():
+    registry = Registry(width=1)
+    registry.register(1, qborsh.U8)
+    registry.register(2, Opaque)
+    assert registry.decode_many([b"\x01\x05", b"\x02\x03\x00"], tagged=True) == [("U8", 5), ("Opaque", 6)]
+    with pytest.raises(KeyError):
+        registry.decode(b"\x03\x00")
+
+
+def test_register_errors():
+    registry = anchor_registry()
+    with pytest.raises(ValueError):
+        registry.register(POOL, Pool)
+    with pytest.raises(ValueError):
+        registry.register(b"short", Pool)
+    with pytest.raises(ValueError):
+        Registry(width=2)
@@ -0,0 +1,106 @@
+import pytest
+
+import qborsh
+
+
+@qborsh.schema
+class Inner:
+    flag: qborsh.Bool
+    score: qborsh.I32
+
+
+@qborsh.schema
+class Transfer:
+    slot: qborsh.U64
+    memo: qborsh.String
+    amount: qborsh.U64
+    delta: qborsh.I64
+    inner: Inner
+    owner: qborsh.PubKey
+
+
+def make_records(n):
+    records = []
+    for i in range(n):
+        records.append(
+            {
+                "slot": i,
+                "memo": "m" * (i % 5),
+                "amount": (i * 7919) % 1000 + 2**63,
+                "delta": i - n // 2,
+                "inner": {"flag": i % 2 == 0, "score": -i},
+                "owner": bytes([i % 3]) * 32,
+            }
+        )
+    return records
+
+
+RECORDS = make_records(10_000)
+ENCODED = [Transfer.encode(r) for r in RECORDS]
+BLOB = b"".join(ENCODED)
+
+
+@pytest.mark.parametrize("source", [BLOB, ENCODED], ids=["concatenated", "sequence"])
+def test_scan_aggregates(source):
+    result = qborsh.scan(
+        Transfer,
+        source,
+        [("count",), ("sum", "amount"), ("min", "delta"), ("max", "inner.score")],
+        workers=4,
+    )
+    assert result == [
+        len(RECORDS),
+        sum(r["amount"] for r in RECORDS),  # exceeds u64
+        min(r["delta"] for r in RECORDS),
+        max(r["inner"]["score"] for r in RECORDS),
+    ]
+
+
+def test_scan_filters():
+    owner = qborsh.PubKey.decode(bytes([1]) * 32)
+    result = qborsh.scan(
+        Transfer,
+        BLOB,
+        [
+            ("filter", "slot", ">=", 100),
+            ("filter", "inner.flag", "==", True),
+            ("filter", "owner", "==", owner),
+            ("count",),
+            ("sum", "slot"),
+        ],
+    )
+    matching = [r for r in RECORDS if r["slot"] >= 100 and r["inner"]["flag"] and r["owner"] == bytes([1]) * 32]
+    assert result == [len(matching), sum(r["slot"] for r in matching)]
+
+
+def test_scan_string_filter():
+    result = qborsh.scan(Transfer, ENCODED, [("filter", "memo", "!=", "mm"), "count"])
+    assert result == [sum(1 for r in RECORDS if r["memo"] != "mm")]
+
+
+def test_scan_negative_threshold_on_unsigned():
+    assert qborsh.scan(Transfer, BLOB, [("filter", "slot", ">", -1), "count"]) == [len(RECORDS)]
+
+
+def test_scan_file(tmp_path):
+    path = tmp_path / "records.bin"
+    path.write_bytes(BLOB)
+    assert qborsh.scan(Transfer, path, ["count"]) == [len(RECORDS)]
+
+
+def test_scan_empty():
+    assert qborsh.scan(Transfer, b"", ["count", ("min", "slot"), ("sum", "amount")]) == [0, None, 0]
+
+
+def test_scan_truncated():
+    with pytest.raises(ValueError, match="malformed or truncated"):
+        qborsh.scan(Transfer, BLOB[:-1], ["count"])
+
+
+def test_scan_bad_ops():
+    with pytest.raises(KeyError):
+        qborsh.scan(Transfer, BLOB, [("sum", "missing")])
+    with pytest.raises(TypeError):
+        qborsh.scan(Transfer, BLOB, [("sum", "memo")])
+    with pytest.raises(ValueError):
+        qborsh.scan(Transfer, BLOB, [("filter", "memo", "<", "a")])
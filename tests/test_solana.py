@@ -0,0 +1,123 @@
+import pytest
+
+import qborsh
+from qborsh import aio, solana
+from qborsh.types.base import MMAP_THRESHOLD
+
+PAYER = bytes(range(32))
+PROGRAM = bytes([7]) * 32
+BLOCKHASH = bytes([9]) * 32
+TABLE = bytes([5]) * 32
+SIGNATURE = bytes([1]) * 64
+
+
+def message_body() -> bytes:
+    return (
+        b"\x01\x00\x01"  # header
+        + b"\x02"
+        + PAYER
+        + PROGRAM  # account keys
+        + BLOCKHASH
+        + b"\x01"  # one instruction
+        + b"\x01"  # program id index
+        + b"\x01\x00"  # accounts
+        + b"\x03abc"  # data
+    )
+
+
+def legacy_tx() -> bytes:
+    return b"\x01" + SIGNATURE + message_body()
+
+
+def v0_tx() -> bytes:
+    lookups = b"\x01" + TABLE + b"\x02\x00\x01" + b"\x00"
+    return b"\x01" + SIGNATURE + b"\x80" + message_body() + lookups
+
+
+def test_legacy():
+    tx = solana.Transaction.decode(legacy_tx())
+    message = tx["message"]
+    assert tx["signatures"] == [SIGNATURE]
+    assert message["version"] == "legacy"
+    assert message["header"] == {
+        "num_required_signatures": 1,
+        "num_readonly_signed_accounts": 0,
+        "num_readonly_unsigned_accounts": 1,
+    }
+    assert message["account_keys"] == [PAYER, PROGRAM]
+    assert message["recent_blockhash"] == BLOCKHASH
+    ix = message["instructions"][0]
+    assert message["account_keys"][ix["program_id_index"]] == PROGRAM
+    assert ix["accounts"] == b"\x00"
+    assert isinstance(ix["data"], memoryview) and ix["data"] == b"abc"
+
+
+def test_v0():
+    raw = v0_tx()
+    tx = solana.Transaction.decode(raw)
+    message = tx["message"]
+    assert message["version"] == 0
+    assert message["address_table_lookups"] == [
+        {"account_key": TABLE, "writable_indexes": b"\x00\x01", "readonly_indexes": b""}
+    ]
+    # Instruction data points into the transaction itself
+    assert message["instructions"][0]["data"].obj is raw
+
+
+@pytest.mark.parametrize("raw", [legacy_tx(), v0_tx()])
+def test_roundtrip(raw):
+    assert solana.Transaction.encode(solana.Transaction.decode(raw)) == raw
+
+
+def test_rejects_unknown_version_and_truncation():
+    raw = v0_tx()
+    with pytest.raises(ValueError, match="Unsupported message version 1"):
+        solana.Transaction.decode(raw[:65] + b"\x81" + raw[66:])
+    with pytest.raises(RuntimeError):
+        solana.Transaction.decode(raw[:-3])
+
+
+def test_scan_skips_transactions():
+    records = [legacy_tx(), v0_tx(), v0_tx()]
+    assert qborsh.scan(solana.Transaction, records, [("count",)]) == [3]
+
+
+def tx_with_data(data: bytes, count: int = 1) -> bytes:
+    ix = b"\x01\x01\x00" + qborsh.ShortBytes.encode(data)
+    body = b"\x01\x00\x01\x02" + PAYER + PROGRAM + BLOCKHASH + qborsh.ShortU16.encode(count) + ix * count
+    return b"\x01" + SIGNATURE + body
+
+
+def test_views_survive_stream_buffer_reuse():
+    # The reader decodes in place from a receive buffer it compacts and refills
+    raws = [tx_with_data(bytes([i % 256]) * (i % 50 + 1)) for i in range(1000)]
+    protocol = aio.FrameReader(solana.Transaction, buffer_size=256)
+    stream = b"".join(aio.FRAME_PREFIX.pack(len(raw)) + raw for raw in raws)
+    for i in range(0, len(stream), 97):
+        chunk = stream[i : i + 97]
+        buf = protocol.get_buffer(len(chunk))
+        n = min(len(buf), len(chunk))
+        buf[:n] = chunk[:n]
+        protocol.buffer_updated(n)
+        rest = chunk[n:]
+        while rest:
+            buf = protocol.get_buffer(len(rest))
+            n = min(len(buf), len(rest))
+            buf[:n] = rest[:n]
+            protocol.buffer_updated(n)
+            rest = rest[n:]
+
+    decoded = list(protocol._messages)
+    assert len(decoded) == len(raws)
+    for i, tx in enumerate(decoded):
+        assert tx["message"]["instructions"][0]["data"] == bytes([i % 256]) * (i % 50 + 1)
+
+
+def test_decode_file_with_views(tmp_path):
+    # Large enough to be memory-mapped, which must close after decoding
+    raw = tx_with_data(b"\xab" * 60_000, count=20)
+    path = tmp_path / "tx.bin"
+    path.write_bytes(raw)
+    tx = solana.Transaction.decode_file(path)
+    assert len(raw) >= MMAP_THRESHOLD
+    assert [bytes(ix["data"]) for ix in tx["message"]["instructions"]] == [b"\xab" * 60_000] * 20
@@ -0,0 +1,81 @@
+import random
+
+import pytest
+
+import qborsh
+
+
+@qborsh.schema
+class Event:
+    slot: qborsh.U64
+    delta: qborsh.I32
+    price: qborsh.F64
+    big: qborsh.I128
+    owner: qborsh.PubKey
+    name: qborsh.String
+
+
+def make_records(n, seed=7):
+    rng = random.Random(seed)
+    return [
+        {
+            "slot": rng.randrange(2**40),
+            "delta": rng.randrange(-(2**31), 2**31),
+            "price": rng.uniform(-1e6, 1e6),
+            "big": rng.randrange(-(2**127), 2**127),
+            "owner": qborsh.PubKey.decode(bytes([rng.randrange(4)]) * 32),
+            "name": "n" * rng.randrange(6) + chr(97 + rng.randrange(3)),
+        }
+        for _ in range(n)
+    ]
+
+
+RECORDS = make_records(5_000)
+ENCODED = [Event.encode(r) for r in RECORDS]
+BLOB = b"".join(ENCODED)
+
+
+def expected(key, reverse=False):
+    sort_key = {
+        "owner": lambda r: qborsh.PubKey.encode(r["owner"]),
+        "name": lambda r: r["name"].encode(),
+    }.get(key, lambda r: r[key])
+    # sorted(reverse=True) keeps ties in input order, like qborsh
+    return sorted(range(len(RECORDS)), key=lambda i: sort_key(RECORDS[i]), reverse=reverse)
+
+
+@pytest.mark.parametrize("key", ["slot", "delta", "price", "big", "owner", "name"])
+@pytest.mark.parametrize("reverse", [False, True])
+def test_sort_permutation(key, reverse):
+    perm = Event.sort(ENCODED, key, reverse=reverse, permutation=True, workers=4)
+    assert list(perm) == expected(key, reverse)
+
+
+def test_sort_records():
+    ordered = Event.sort(BLOB, "slot")
+    assert ordered == b"".join(ENCODED[i] for i in expected("slot"))
+    assert Event.sort(b"", "slot") == b""
+
+
+def test_sort_is_stable():
+    perm = Event.sort(ENCODED, "owner", permutation=True)
+    for a, b in zip(perm, perm[1:]):
+        if RECORDS[a]["owner"] == RECORDS[b]["owner"]:
+            assert a < b
+
+
+@pytest.mark.parametrize("key", ["slot", "name"])
+def test_sort_file(tmp_path, key):
+    source = tmp_path / "events.bin"
+    destination = tmp_path / "sorted.bin"
+    source.write_bytes(BLOB)
+
+    Event.sort_file(source, destination, key, run_bytes=len(BLOB) // 7, tmp_dir=tmp_path)
+    assert destination.read_bytes() == b"".join(ENCODED[i] for i in expected(key))
+
+
+def test_sort_errors():
+    with pytest.raises(KeyError):
+        Event.sort(BLOB, "missing")
+    with pytest.raises(ValueError, match="malformed or truncated"):
+        Event.sort(BLOB[:-1], "slot")
@@ -0,0 +1,173 @@
+import struct
+
+import pytest
+
+import qborsh
+from qborsh import spl
+
+MINT = bytes([1]) * 32
+OWNER = bytes([2]) * 32
+DELEGATE = bytes([3]) * 32
+
+
+def key(raw: bytes) -> str:
+    return qborsh.PubKey.decode(raw)
+
+
+def some(value: bytes) -> bytes:
+    return b"\x01\x00\x00\x00" + value
+
+
+def none(size: int) -> bytes:
+    return bytes(4 + size)
+
+
+def mint_data(supply: int = 1000) -> bytes:
+    return some(OWNER) + struct.pack("<QB?", supply, 6, True) + none(32)
+
+
+def account_data(amount: int = 5) -> bytes:
+    return (
+        MINT
+        + OWNER
+        + struct.pack("<Q", amount)
+        + some(DELEGATE)
+        + bytes([spl.FROZEN])
+        + none(8)
+        + struct.pack("<Q", 2)
+        + none(32)
+    )
+
+
+def tlv(kind: int, value: bytes) -> bytes:
+    return struct.pack("<HH", kind, len(value)) + value
+
+
+def test_sizes():
+    assert spl.Mint.compile().size == spl.MINT_SIZE
+    assert spl.TokenAccount.compile().size == spl.ACCOUNT_SIZE
+    assert spl.Multisig.compile().size == spl.MULTISIG_SIZE
+
+
+def test_mint_and_account():
+    assert spl.decode_account(mint_data()) == (
+        "mint",
+        {
+            "mint_authority": key(OWNER),
+            "supply": 1000,
+            "decimals": 6,
+            "is_initialized": True,
+            "freeze_authority": None,
+        },
+    )
+    kind, account = spl.decode_account(account_data())
+    assert kind == "account"
+    assert account == {
+        "mint": key(MINT),
+        "owner": key(OWNER),
+        "amount": 5,
+        "delegate": key(DELEGATE),
+        "state": spl.FROZEN,
+        "is_native": None,
+        "delegated_amount": 2,
+        "close_authority": None,
+    }
+    assert spl.TokenAccount.encode(account) == account_data()
+
+
+def test_multisig():
+    data = bytes([2, 3, 1]) + OWNER + DELEGATE + bytes(32 * 9)
+    kind, multisig = spl.decode_account(data)
+    assert kind == "multisig" and multisig["m"] == 2 and multisig["signers"][:2] == [key(OWNER), key(DELEGATE)]
+
+
+def test_batches():
+    accounts = b"".join(account_data(amount) for amount in range(100))
+    assert [account["amount"] for account in spl.decode_token_accounts(accounts)] == list(range(100))
+    mints = memoryview(b"".join(mint_data(supply) for supply in range(10)))
+    assert [mint["supply"] for mint in spl.decode_mints(mints)] == list(range(10))
+    with pytest.raises(ValueError):
+        spl.decode_token_accounts(accounts[:-1])
+    assert spl.decode_mints(b"") == []
+
+
+def test_token_2022_account():
+    fee = struct.pack("<Q", 9)
+    data = account_data() + bytes([spl.ACCOUNT_TYPE_ACCOUNT]) + tlv(2, fee) + tlv(7, b"") + tlv(99, b"ab") + bytes(8)
+    kind, account = spl.decode_account(data)
+    assert kind == "account" and account["amount"] == 5
+    assert account["extensions"] == {
+        "transfer_fee_amount": {"withheld_amount": 9},
+        "immutable_owner": {},
+        "unknown_99": b"ab",
+    }
+
+
+def test_token_2022_mint():
+    metadata = qborsh.Tuple[qborsh.PubKey, qborsh.PubKey, qborsh.String, qborsh.String, qborsh.String]
+    value = metadata.encode((key(OWNER), key(MINT), "Token", "TKN", "https://x")) + struct.pack("<I", 1)
+    value += struct.pack("<I", 1) + b"k" + struct.pack("<I", 1) + b"v"
+    data = mint_data().ljust(spl.ACCOUNT_SIZE, b"\x00") + bytes([spl.ACCOUNT_TYPE_MINT])
+    data += tlv(18, OWNER + MINT) + tlv(19, value)
+    kind, mint = spl.decode_account(data)
+    assert kind == "mint" and mint["supply"] == 1000
+    assert mint["extensions"]["metadata_pointer"] == {"authority": key(OWNER), "metadata_address": key(MINT)}
+    token_metadata = mint["extensions"]["token_metadata"]
+    assert token_metadata["symbol"] == "TKN" and token_metadata["additional_metadata"] == [("k", "v")]
+
+
+def test_invalid():
+    with pytest.raises(ValueError):
+        spl.decode_account(b"\x00" * 100)
+    with pytest.raises(ValueError):
+        spl.decode_account(account_data() + b"\x05")
+    with pytest.raises(ValueError):
+        spl.decode_account(account_data() + bytes([spl.ACCOUNT_TYPE_ACCOUNT]) + tlv(2, b"")[:2] + b"\xff\x00")
+
+
+def test_nonce():
+    nonce = bytes([7]) * 32
+    data = struct.pack("<II", 1, 1) + OWNER + nonce + struct.pack("<Q", 5000)
+    assert spl.NonceData.compile().size + 8 == spl.NONCE_SIZE
+    assert spl.decode_nonce(data) == {
+        "authority": key(OWNER),
+        "durable_nonce": nonce,
+        "fee_calculator": {"lamports_per_signature": 5000},
+    }
+    assert spl.decode_nonce(bytearray(spl.NONCE_SIZE)) is None
+    with pytest.raises(ValueError):
+        spl.decode_nonce(data[:-1])
+    with pytest.raises(ValueError):
+        spl.decode_nonce(struct.pack("<II", 1, 2) + data[8:])
+
+
+def test_stake():
+    meta = struct.pack("<Q", 2282880) + OWNER + DELEGATE + struct.pack("<qQ", -1, 3) + MINT
+    stake = DELEGATE + struct.pack("<QQQdQ", 10**9, 500, 2**64 - 1, 0.25, 42)
+    data = struct.pack("<I", 2) + meta + stake + b"\x01"
+    data += bytes(spl.STAKE_SIZE - len(data))
+    state, value = spl.decode_stake(data)
+    assert state == "stake" and value["stake_flags"] == 1
+    assert value["meta"] == {
+        "rent_exempt_reserve": 2282880,
+        "authorized": {"staker": key(OWNER), "withdrawer": key(DELEGATE)},
+        "lockup": {"unix_timestamp": -1, "epoch": 3, "custodian": key(MINT)},
+    }
+    assert value["stake"] == {
+        "delegation": {
+            "voter_pubkey": key(DELEGATE),
+            "stake": 10**9,
+            "activation_epoch": 500,
+            "deactivation_epoch": 2**64 - 1,
+            "warmup_cooldown_rate": 0.25,
+        },
+        "credits_observed": 42,
+    }
+
+    initialized = struct.pack("<I", 1) + meta
+    assert spl.decode_stake(initialized + bytes(spl.STAKE_SIZE - len(initialized))) == ("initialized", value["meta"])
+    assert spl.decode_stake(bytes(spl.STAKE_SIZE)) == ("uninitialized", None)
+    with pytest.raises(ValueError):
+        spl.decode_stake(struct.pack("<I", 4) + bytes(spl.STAKE_SIZE - 4))
+    with pytest.raises(ValueError):
+        spl.decode_stake(data[:100])
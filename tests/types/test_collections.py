@@ -26,6 +26,61 @@ class TestOptional:
         out = opt_str.decode(encoded)
         assert out == "Hello"
 
+    def test_wire_format(self):
+        opt_u64 = qborsh.Optional[qborsh.U64]
+        assert opt_u64.encode(None) == b"\x00"
+        assert opt_u64.encode(7) == b"\x01" + (7).to_bytes(8, "little")
+        assert opt_u64._program is not None
+
+    def test_optional_fields_in_schema(self):
+        @qborsh.schema
+        class Fill:
+            price: qborsh.Optional[qborsh.U64]
+            size: qborsh.Optional[qborsh.U64]
+            owner: qborsh.Optional[qborsh.PubKey]
+
+        value = {"price": 2**64 - 1, "size": None, "owner": "1" * 32}
+        encoded = Fill.encode(value)
+        assert len(encoded) == 1 + 8 + 1 + 1 + 32
+        assert Fill.decode(encoded) == value
+
+    def test_buffer_option_is_inline(self):
+        buf = qborsh.Buffer(16)
+        buf.write_option(b"\x05\x00")
+        buf.write_option(None)
+        assert bytes(buf.data[: buf.size]) == b"\x01\x05\x00\x00"
+        buf.reset_offset()
+        assert buf.read_option(2) == b"\x05\x00"
+        assert buf.read_option(2) is None
+
+
+class TestCOption:
+    coption_u64 = qborsh.COption[qborsh.U64]
+
+    def test_wire_format(self):
+        assert self.coption_u64.encode(None) == bytes(12)
+        assert self.coption_u64.encode(7) == b"\x01\x00\x00\x00" + (7).to_bytes(8, "little")
+        assert self.coption_u64.sizeof() == 12
+        assert self.coption_u64._program is not None
+
+    def test_roundtrip(self):
+        for value in (None, 0, 2**64 - 1):
+            assert self.coption_u64.decode(self.coption_u64.encode(value)) == value
+
+    def test_fixed_size_in_struct(self):
+        layout = qborsh.Layout(("struct", (("a", ("coption", ("pubkey",))), ("b", ("u8",)))))
+        assert layout.size == 37
+
+    def test_invalid_tag(self):
+        with pytest.raises(ValueError):
+            self.coption_u64.decode(b"\x02" + bytes(11))
+
+    def test_variable_element(self):
+        with pytest.raises(TypeError):
+            qborsh.COption[qborsh.String]
+        with pytest.raises(ValueError):
+            qborsh.Layout(("coption", ("string",)))
+
 
 class TestVector:
     vec_u8 = qborsh.Vector[qborsh.U8]
@@ -78,3 +133,70 @@ class TestMap:
     def test_map_key_out_of_range(self):
         with pytest.raises(ValueError):
             self.map_u8_str.encode({999: "big key"})
+
+
+class TestTuple:
+    quote = qborsh.Tuple[qborsh.U64, qborsh.PubKey, qborsh.String]
+    pair = qborsh.Tuple[qborsh.U32, qborsh.I16]
+
+    def test_roundtrip(self):
+        value = (100, "1" * 32, "SOL")
+        assert self.quote.decode(self.quote.encode(value)) == value
+        assert self.pair.decode(self.pair.encode([7, -2])) == (7, -2)
+
+    def test_wire_format(self):
+        assert self.pair.encode((1, -1)) == b"\x01\x00\x00\x00\xff\xff"
+        assert self.pair.sizeof() == 6
+        assert self.pair.compile().size == 6
+        assert self.quote.sizeof() is None
+
+    def test_wrong_length(self):
+        with pytest.raises(ValueError, match="Expected 2 items"):
+            self.pair.encode((1,))
+
+    def test_truncated(self):
+        with pytest.raises(RuntimeError):
+            self.pair.decode(b"\x01\x00\x00\x00\xff")
+
+    def test_in_schema_and_scan(self):
+        @qborsh.schema
+        class Level:
+            side: qborsh.U8
+            order: qborsh.Tuple[qborsh.U64, qborsh.U64]
+
+        records = [Level.encode({"side": 0, "order": (price, 1)}) for price in range(10)]
+        assert Level.decode(records[3]) == {"side": 0, "order": (3, 1)}
+        assert qborsh.scan(Level, records, [("filter", "order.0", ">", 6), ("count",)]) == [3]
+
+
+class TestShortVec:
+    keys = qborsh.ShortVec[qborsh.Array[qborsh.U8, 2]]
+
+    def test_roundtrip(self):
+        value = [[i % 256, 0] for i in range(200)]
+        encoded = self.keys.encode(value)
+        assert encoded[:2] == b"\xc8\x01"
+        assert len(encoded) == 2 + 400
+        assert self.keys.decode(encoded) == value
+
+    def test_python_path_matches(self):
+        class PyU8(qborsh.BorshType):
+            def serialize(self, buf, value):
+                buf.write_u8(value)
+
+            def deserialize(self, buf):
+                return buf.read_u8()
+
+            def sizeof(self):
+                return 1
+
+        python = qborsh.ShortVec[PyU8]
+        native = qborsh.ShortVec[qborsh.U8]
+        assert python._program is None
+        value = list(range(130))
+        assert python.encode(value) == native.encode(value)
+        assert python.decode(native.encode(value)) == value
+
+    def test_too_long(self):
+        with pytest.raises(ValueError, match="shortvec"):
+            qborsh.ShortVec[qborsh.U8].encode([0] * 0x10000)
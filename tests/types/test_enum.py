@@ -0,0 +1,168 @@
+import pytest
+
+import qborsh
+
+
+@qborsh.schema
+class Transfer:
+    amount: qborsh.U64
+    memo: qborsh.Optional[qborsh.String]
+
+
+@qborsh.enum
+class Instruction:
+    Initialize: None
+    Transfer: Transfer
+    SetOwner: qborsh.PubKey
+    Batch: qborsh.Vector[qborsh.U32]
+
+
+class PyU16(qborsh.BorshType):
+    """
+    U16 without a native layout, forcing the Python path.
+    """
+
+    def serialize(self, buf, value):
+        buf.write_u16(value)
+
+    def deserialize(self, buf):
+        return buf.read_u16()
+
+    def sizeof(self):
+        return 2
+
+
+@qborsh.enum
+class PyEnum:
+    Empty: None
+    Value: PyU16
+
+
+class TestEnum:
+    def test_roundtrip(self):
+        values = [
+            ("Initialize", None),
+            ("Transfer", {"amount": 7, "memo": None}),
+            ("Transfer", {"amount": 2**64 - 1, "memo": "hi"}),
+            ("SetOwner", "1" * 32),
+            ("Batch", [1, 2, 3]),
+        ]
+        for value in values:
+            assert Instruction.decode(Instruction.encode(value)) == value
+
+    def test_wire_format(self):
+        assert Instruction.encode("Initialize") == b"\x00"
+        transfer = Instruction.encode(("Transfer", {"amount": 5, "memo": None}))
+        assert transfer == b"\x01" + (5).to_bytes(8, "little") + b"\x00"
+        assert Instruction.encode(("Batch", [9])) == b"\x03\x01\x00\x00\x00\x09\x00\x00\x00"
+
+    def test_native_and_python_paths_agree(self):
+        assert Instruction._program is not None
+        assert PyEnum._program is None
+
+        @qborsh.enum
+        class NativeEnum:
+            Empty: None
+            Value: qborsh.U16
+
+        for value in [("Empty", None), ("Value", 513)]:
+            assert PyEnum.encode(value) == NativeEnum.encode(value)
+            assert PyEnum.decode(NativeEnum.encode(value)) == NativeEnum.decode(PyEnum.encode(value)) == value
+
+    @pytest.mark.parametrize("kind", [Instruction, PyEnum])
+    def test_errors(self, kind):
+        with pytest.raises(ValueError, match="Unknown enum variant"):
+            kind.encode(("Missing", None))
+        with pytest.raises(ValueError, match="Invalid enum variant index 9"):
+            kind.decode(b"\x09")
+        with pytest.raises(RuntimeError):
+            kind.decode(b"")
+
+    def test_payload_required(self):
+        with pytest.raises(ValueError, match="needs a payload"):
+            Instruction.encode("Transfer")
+
+    def test_nested(self):
+        @qborsh.schema
+        class Tx:
+            fee: qborsh.U64
+            instructions: qborsh.Vector[Instruction]
+
+        value = {"fee": 5000, "instructions": [("Initialize", None), ("Batch", [])]}
+        assert Tx.decode(Tx.encode(value)) == value
+
+    def test_sizeof_and_layout(self):
+        assert Instruction.sizeof() is None
+        assert Instruction.variants == ("Initialize", "Transfer", "SetOwner", "Batch")
+
+        @qborsh.enum
+        class Side:
+            Bid: qborsh.U64
+            Ask: qborsh.U64
+
+        assert Side.sizeof() == 9
+        assert Side.compile().size == 9
+
+    def test_scan_skips_enum_fields(self):
+        @qborsh.schema
+        class Order:
+            instruction: Instruction
+            price: qborsh.U64
+
+        records = [Order.encode({"instruction": ("Batch", [1] * i), "price": i}) for i in range(5)]
+        assert qborsh.scan(Order, records, [("filter", "price", ">=", 3), ("sum", "price")]) == [7]
+
+
+class TestLayoutValues:
+    def test_matches_python_decode(self):
+        @qborsh.schema
+        class Everything:
+            a: qborsh.U8
+            b: qborsh.I128
+            c: qborsh.F32
+            d: qborsh.Bool
+            e: qborsh.String
+            f: qborsh.Bytes
+            g: qborsh.Set[qborsh.U16]
+            h: qborsh.Map[qborsh.String, qborsh.I64]
+            i: qborsh.Array[qborsh.U8, 3]
+            j: qborsh.Padding[qborsh.U32]
+            k: qborsh.Optional[qborsh.U128]
+
+        value = {
+            "a": 1,
+            "b": -(2**100),
+            "c": 1.5,
+            "d": True,
+            "e": "é",
+            "f": b"\x00\x01",
+            "g": {1, 2},
+            "h": {"x": -1},
+            "i": [1, 2, 3],
+            "j": None,
+            "k": 2**127,
+        }
+        # Set elements are encoded in hash order, so compare decoded values
+        buf = qborsh.Buffer(64)
+        Everything.compile().write(buf, value)
+        native = bytes(buf.data[: buf.size])
+        encoded = Everything.encode(value)
+        assert len(native) == len(encoded)
+
+        buf.attach(encoded)
+        try:
+            decoded = Everything.compile().read(buf)
+        finally:
+            buf.detach()
+        del value["j"]
+        assert decoded == Everything.decode(native) == value
+
+    def test_dotdict_structs(self):
+        @qborsh.schema(dotdict=True)
+        class Point:
+            x: qborsh.I32
+
+        buf = qborsh.Buffer(8)
+        Point.compile().write(buf, {"x": -3})
+        buf.reset_offset()
+        assert Point.compile().read(buf).x == -3
@@ -1,3 +1,5 @@
+import pickle
+
 import pytest
 import qbase58
 import qborsh
@@ -26,6 +28,92 @@ class TestPubKey:
     def test_sizeof(self):
         assert self.pubkey_type().sizeof() == 32
 
+    @pytest.mark.parametrize("raw", [b"\x00" * 32, b"\x00" * 5 + b"\xff" * 27, b"\xff" * 32, bytes(range(32))])
+    def test_native_base58_matches_qbase58(self, raw):
+        text = self.pubkey_type.decode(raw)
+        assert text == qbase58.encode(raw)
+        assert self.pubkey_type.encode(text) == raw
+
+    @pytest.mark.parametrize("text", ["0" * 32, "1" * 31, "1" * 33, "z" * 45, ""])
+    def test_invalid_base58(self, text):
+        with pytest.raises(ValueError):
+            self.pubkey_type.encode(text)
+
+    def test_vector(self):
+        keys = [bytes([i]) * 32 for i in range(20)]
+        encoded = qborsh.Vector[qborsh.PubKey].encode(keys)
+        assert qborsh.Vector[qborsh.PubKey].decode(encoded) == [qbase58.encode(k) for k in keys]
+        with pytest.raises(RuntimeError):
+            qborsh.Vector[qborsh.PubKey].decode(encoded[:-1])
+
+
+class TestPublicKey:
+    raw = bytes(range(32))
+
+    @pytest.fixture
+    def lazy(self):
+        qborsh.set_lazy_pubkeys(True)
+        yield
+        qborsh.set_lazy_pubkeys(False)
+
+    def test_decodes_lazily(self, lazy):
+        key = qborsh.PubKey.decode(self.raw)
+        assert isinstance(key, qborsh.PublicKey)
+        assert bytes(key) == self.raw
+        assert str(key) == qbase58.encode(self.raw)
+        assert repr(key) == f"PublicKey('{key}')"
+
+    def test_vector(self, lazy):
+        keys = qborsh.Vector[qborsh.PubKey].decode(qborsh.Vector[qborsh.PubKey].encode([self.raw, self.raw]))
+        assert keys[0] == keys[1] and keys[0] is not keys[1]
+        assert len({keys[0], keys[1], qborsh.PublicKey(self.raw)}) == 1
+
+    def test_compare_and_hash(self):
+        key = qborsh.PublicKey(self.raw)
+        assert key == qborsh.PublicKey(qbase58.encode(self.raw))
+        assert key != str(key) and key != self.raw
+        assert qborsh.PublicKey(b"\x00" * 32) < key
+        assert hash(key) == hash(qborsh.PublicKey(self.raw))
+
+    def test_encode_and_pickle(self):
+        key = qborsh.PublicKey(self.raw)
+        assert qborsh.PubKey.encode(key) == self.raw
+        assert pickle.loads(pickle.dumps(key)) == key
+
+    def test_off_by_default(self):
+        assert isinstance(qborsh.PubKey.decode(self.raw), str)
+
+
+class TestInterned:
+    def test_shares_repeated_values(self):
+        mint = bytes(range(32))
+        record = qborsh.Tuple[qborsh.Interned[qborsh.PubKey], qborsh.Interned[qborsh.String], qborsh.String]
+        values = qborsh.Vector[record].decode(qborsh.Vector[record].encode([(mint, "swap", "a")] * 3))
+        assert values[0] == (qbase58.encode(mint), "swap", "a")
+        assert values[0][0] is values[2][0]
+        assert values[0][1] is values[2][1]
+
+    def test_collisions_and_clear(self):
+        names = qborsh.Vector[qborsh.Interned[qborsh.String]]
+        words = [f"word{i}" for i in range(20000)] + ["é"]
+        assert names.decode(names.encode(words)) == words
+        qborsh.clear_interned()
+        assert names.decode(names.encode(words)) == words
+
+    def test_follows_lazy_pubkeys(self):
+        key = qborsh.Interned[qborsh.PubKey]
+        raw = qborsh.PubKey.encode(b"\x07" * 32)
+        assert isinstance(key.decode(raw), str)
+        qborsh.set_lazy_pubkeys(True)
+        try:
+            assert isinstance(key.decode(raw), qborsh.PublicKey)
+        finally:
+            qborsh.set_lazy_pubkeys(False)
+
+    def test_only_strings_and_pubkeys(self):
+        with pytest.raises(TypeError):
+            qborsh.Interned[qborsh.U64]
+
 
 class TestPadding:
     padding_u8 = qborsh.Padding[qborsh.U8]
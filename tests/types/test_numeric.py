@@ -38,3 +38,96 @@ def test_roundtrip(borsh_type, valid_values, invalid_values, expected_size):
         else:
             with pytest.raises((OverflowError, ValueError)):
                 borsh_type.encode(val)
+
+
+class TestShortU16:
+    cases = [
+        (0, b"\x00"),
+        (0x7F, b"\x7f"),
+        (0x80, b"\x80\x01"),
+        (0x3FFF, b"\xff\x7f"),
+        (0x4000, b"\x80\x80\x01"),
+        (0xFFFF, b"\xff\xff\x03"),
+    ]
+
+    def test_wire_format(self):
+        for value, encoded in self.cases:
+            assert qborsh.ShortU16.encode(value) == encoded
+            assert qborsh.ShortU16.decode(encoded) == value
+
+    def test_out_of_range(self):
+        with pytest.raises(ValueError, match="out of range"):
+            qborsh.ShortU16.encode(0x10000)
+        with pytest.raises(ValueError, match="out of range"):
+            qborsh.ShortU16.encode(-1)
+
+    @pytest.mark.parametrize("encoded", [b"\x80\x00", b"\xff\xff\x04", b"\x80\x80\x80", b"\x80"])
+    def test_rejects_invalid(self, encoded):
+        with pytest.raises(RuntimeError):
+            qborsh.ShortU16.decode(encoded)
+
+
+class TestVarInt:
+    cases = [
+        (0, b"\x00"),
+        (0x7F, b"\x7f"),
+        (0x80, b"\x80\x01"),
+        (300, b"\xac\x02"),
+        (2**56 - 1, b"\xff" * 7 + b"\x7f"),
+        (2**56, b"\x80" * 8 + b"\x01"),
+        (2**64 - 1, b"\xff" * 9 + b"\x01"),
+    ]
+
+    def test_wire_format(self):
+        for value, encoded in self.cases:
+            assert qborsh.VarU64.encode(value) == encoded
+            assert qborsh.VarU64.decode(encoded) == value
+            # The word-at-a-time path kicks in with 8 bytes left to read
+            assert qborsh.VarU64.decode(encoded + b"\x00" * 8) == value
+
+    def test_zigzag(self):
+        for value, encoded in [(0, b"\x00"), (-1, b"\x01"), (1, b"\x02"), (-64, b"\x7f"), (64, b"\x80\x01")]:
+            assert qborsh.VarI64.encode(value) == encoded
+            assert qborsh.VarI64.decode(encoded) == value
+        for value in (2**63 - 1, -(2**63)):
+            assert qborsh.VarI64.decode(qborsh.VarI64.encode(value)) == value
+
+    def test_out_of_range(self):
+        with pytest.raises(ValueError):
+            qborsh.VarU64.encode(-1)
+        with pytest.raises(ValueError):
+            qborsh.VarU64.encode(2**64)
+        with pytest.raises(ValueError):
+            qborsh.VarI64.encode(2**63)
+
+    @pytest.mark.parametrize("encoded", [b"\x80", b"\xff" * 9 + b"\x02", b"\xff" * 10 + b"\x01"])
+    def test_rejects_invalid(self, encoded):
+        with pytest.raises(RuntimeError):
+            qborsh.VarU64.decode(encoded)
+
+    def test_vector(self):
+        values = [0, 1, 127, 128, 300, 2**35, 2**63, 2**64 - 1] * 10
+        encoded = qborsh.Vector[qborsh.VarU64].encode(values)
+        assert len(encoded) < 4 + 8 * len(values)
+        assert qborsh.Vector[qborsh.VarU64].decode(encoded) == values
+
+        signed = [0, -1, 5, -(2**40), 2**62] * 10
+        assert qborsh.Vector[qborsh.VarI64].decode(qborsh.Vector[qborsh.VarI64].encode(signed)) == signed
+        with pytest.raises(RuntimeError):
+            qborsh.Vector[qborsh.VarU64].decode(encoded[:-1])
+
+
+@pytest.mark.parametrize("value", [2**64, 2**70, -(2**70)])
+def test_native_overflow_is_value_error(value):
+    @qborsh.schema
+    class Fields:
+        a: qborsh.U64
+        b: qborsh.U8
+
+    # Natively encoded containers raise what the Python path raises
+    with pytest.raises(ValueError, match="out of range|negative"):
+        Fields.encode({"a": value, "b": 0})
+    with pytest.raises(ValueError, match="out of range|negative"):
+        qborsh.Vector[qborsh.U64].encode([value])
+    with pytest.raises(ValueError, match="out of range|negative"):
+        qborsh.Optional[qborsh.U32].encode(value)
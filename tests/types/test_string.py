@@ -51,3 +51,46 @@ class TestBytes:
 
     def test_sizeof(self):
         assert self.bytes_type.sizeof() is None
+
+
+class TestFixedBytes:
+    def test_roundtrip(self):
+        key = bytes(range(32))
+        encoded = qborsh.FixedBytes[32].encode(key)
+        assert encoded == key
+        assert qborsh.FixedBytes[32].decode(encoded) == key
+        assert qborsh.FixedBytes[32].sizeof() == 32
+
+    def test_wrong_length(self):
+        with pytest.raises(ValueError):
+            qborsh.FixedBytes[32].encode(b"\x00" * 31)
+
+
+class TestShortBytes:
+    def test_roundtrip(self):
+        data = b"\x01" * 200
+        encoded = qborsh.ShortBytes.encode(data)
+        assert encoded[:2] == b"\xc8\x01"
+        assert qborsh.ShortBytes.decode(encoded) == data
+
+
+class TestView:
+    def test_view_into_source(self):
+        raw = qborsh.Bytes.encode(b"payload")
+        view = qborsh.View[qborsh.Bytes].decode(raw)
+        assert isinstance(view, memoryview)
+        assert view.obj is raw and view == b"payload"
+
+    def test_copies_mutable_sources(self):
+        raw = qborsh.Bytes.encode(b"payload")
+        view = qborsh.View[qborsh.Bytes].decode(memoryview(raw)[:])
+        assert isinstance(view, memoryview) and view.obj is raw
+
+        data = bytearray(raw)
+        copy = qborsh.View[qborsh.Bytes].decode(data)
+        data[4:] = b"changed"
+        assert copy == b"payload" and isinstance(copy, bytes)
+
+    def test_rejects_non_bytes(self):
+        with pytest.raises(TypeError):
+            qborsh.View[qborsh.String]